@@ -42,11 +42,12 @@ using namespace std;
 #include "help_functions.h"
 #include "host_functions.h"
 #include "kernel.h"
+#include "SW.h"
+#include "SW_Stream.h"
+#include "time_functions.h"
 
 #define ALL_MESSAGES
 
-void K_americanPut_sw_model(t_in_data* host_IN_DATA, float* sw_RES, int NB_OF_TESTS, int Nb_Of_Threads);
-
 // ********************************************************************************** //
 // DEBUG Settings
 // ********************************************************************************** //
@@ -112,12 +113,28 @@ int main(int argc, char* argv[])
     // ---------------------------------------------------------
     // Check SW_HW_Mode value
     // ---------------------------------------------------------
-	if ((SW_HW_Mode!="sw") && (SW_HW_Mode!="hw")) {
+	if ((SW_HW_Mode!="sw") && (SW_HW_Mode!="hw") && (SW_HW_Mode!="bench") && (SW_HW_Mode!="microbench") && (SW_HW_Mode!="precision")) {
 		cout << endl << "HOST-Error: SW_HW_Mode option does not support the following value: " << SW_HW_Mode << endl;
-		cout <<         "            Supported values are: sw, hw" << endl << endl;
+		cout <<         "            Supported values are: sw, hw, bench, microbench, precision" << endl << endl;
 		return EXIT_FAILURE;
 	}
 
+	// ============================================================================
+	// Step: Run Pricing Microbenchmark End Exit
+	//       (the test config file argument is a microbenchmark config file)
+	// ============================================================================
+	if (SW_HW_Mode == "microbench") {
+		cout << endl;
+		cout << "HOST-Info: ============================================================= " << endl;
+		cout << "HOST-Info: Step: Run Pricing Microbenchmark                              " << endl;
+		cout << "HOST-Info: ============================================================= " << endl;
+
+		run_sw_microbenchmark(Test_Config_File_Name);
+
+		cout << endl << "HOST-Info: Application Completed" << endl << endl;
+		return EXIT_SUCCESS;
+	}
+
 
     // ---------------------------------------------------------
     // Initialize some fields in Test_Config and then
@@ -127,7 +144,7 @@ int main(int argc, char* argv[])
     sw_hw_config_t         SW_HW_Config;
 
     SW_HW_Config.MAX_NB_OF_TESTS = CONST_MAX_NB_OF_TESTS;
-    SW_HW_Config.MAX_TREE_HEIGHT = CONST_MAX_TREE_HEIGHT;
+    SW_HW_Config.MAX_TREE_HEIGHT = (SW_HW_Mode == "hw") ? CONST_MAX_TREE_HEIGHT : SW_MAX_TREE_HEIGHT;   // The SW model tiles taller trees
 
     read_sw_hw_config_file(SW_HW_Config_File_Name, &SW_HW_Config);
     print_sw_hw_config_info(SW_HW_Config);
@@ -141,7 +158,44 @@ int main(int argc, char* argv[])
     // ------------------------------------------------------------
     int DEFINED_NB_OF_TESTS;
     int ROUNDED_NB_OF_TESTS;
-    process_configurations(SW_HW_Mode, &SW_HW_Config, &Test_Config, &DEFINED_NB_OF_TESTS, &ROUNDED_NB_OF_TESTS);
+    process_configurations((SW_HW_Mode == "hw") ? "hw" : "sw", &SW_HW_Config, &Test_Config, &DEFINED_NB_OF_TESTS, &ROUNDED_NB_OF_TESTS);
+
+
+	// =========================================================================
+	// Step: Stream the SW Model when the tests do not fit MAX_NB_OF_TESTS
+	// =========================================================================
+	if (ROUNDED_NB_OF_TESTS > SW_HW_Config.MAX_NB_OF_TESTS) {
+
+		if (SW_HW_Mode != "sw") {
+			cout << endl << "HOST-Error: Only the sw mode supports more than MAX_NB_OF_TESTS(" << SW_HW_Config.MAX_NB_OF_TESTS << ") tests" << endl << endl;
+			return EXIT_FAILURE;
+		}
+
+		cout << endl;
+		cout << "HOST-Info: ============================================================= " << endl;
+		cout << "HOST-Info: Step: Run SW Model (Streaming)                                " << endl;
+		cout << "HOST-Info: ============================================================= " << endl;
+
+		double tstart, tstop;
+
+		tstart = get_time_ms();
+
+		K_americanPut_sw_stream(&Test_Config, DEFINED_NB_OF_TESTS, SW_STREAM_CHUNK_SIZE, SW_HW_Config.NB_OF_THREADS, SW_HW_Config.SW_ENGINE, "SW_Res.txt");
+
+		tstop = get_time_ms();
+
+		cout << "HOST_Info: SW Model Execution"                                                       << endl;
+		cout << "HOST_Info:     # Threads    = " <<  SW_HW_Config.NB_OF_THREADS                       << endl;
+		cout << "HOST_Info:     SW Engine    = " <<  SW_HW_Config.SW_ENGINE                           << endl;
+		if ((SW_HW_Config.SW_ENGINE == "simd") || (SW_HW_Config.SW_ENGINE == "batch"))
+		cout << "HOST_Info:     SIMD ISA     = " <<  sw_simd_isa_name()                               << endl;
+		cout << "HOST_Info:     # Tests      = " <<  DEFINED_NB_OF_TESTS                              << endl;
+		cout << "HOST_Info:     Runtime (ms) = " << fixed << setprecision(1) << (tstop-tstart) << endl << endl;
+		cout << "HOST-Info: Results stored in the SW_Res.txt file (not compared against the original SW model)" << endl;
+
+		cout << endl << "HOST-Info: Application Completed" << endl << endl;
+		return EXIT_SUCCESS;
+	}
 
 
 	// =========================================================================
@@ -152,9 +206,10 @@ int main(int argc, char* argv[])
 	cout << "HOST-Info: Step: Prepare Data to Run Application                         " << endl;
 	cout << "HOST-Info: ============================================================= " << endl;
 
-	t_in_data*  host_IN_DATA;
-	float*      sw_RES;             // For Results from SW model
-	float*      hw_RES;             // For Results from HW Kernel
+	t_in_data*     host_IN_DATA;
+	t_in_data_soa  host_IN_SOA;        // host_IN_DATA in SoA layout (SW model)
+	float*         sw_RES;             // For Results from SW model
+	float*         hw_RES;             // For Results from HW Kernel
 
 	// ---------------------------------------------------------------------------------
 	// Allocate Memory for host_IN_DATA and initialize it (t_in_data)
@@ -162,6 +217,15 @@ int main(int argc, char* argv[])
 	host_IN_DATA = allocate_host_mem<t_in_data>(ROUNDED_NB_OF_TESTS,"host_IN_DATA",true);
     generate_test_vectors(host_IN_DATA, Test_Config, ROUNDED_NB_OF_TESTS);
 
+	// ---------------------------------------------------------------------------------
+	// The SW model reads the test vectors in SoA layout (one aligned array per field)
+	// ---------------------------------------------------------------------------------
+	if (SW_HW_Mode != "hw") {
+		cout << "HOST-Info: Converting host_IN_DATA to SoA layout (host_IN_SOA) ... " << endl;
+		host_IN_SOA = in_data_soa_alloc(ROUNDED_NB_OF_TESTS);
+		in_data_aos_to_soa(host_IN_DATA, host_IN_SOA);
+	}
+
 	// ---------------------------------------------------------------------------------
 	// Allocate Memory for sw_RES and hw_RES to store SW and HW results
 	// ---------------------------------------------------------------------------------
@@ -182,26 +246,114 @@ int main(int argc, char* argv[])
 		cout << "HOST-Info: ============================================================= " << endl;
 
 		double tstart, tstop;
-		struct timeval t;
 
-		gettimeofday(&t, NULL);
-		tstart = 1.0e-6*t.tv_usec + t.tv_sec;
+		tstart = get_time_ms();
 
-		K_americanPut_sw_model(host_IN_DATA, sw_RES, ROUNDED_NB_OF_TESTS, SW_HW_Config.NB_OF_THREADS);
+		K_americanPut_sw_model(&host_IN_SOA, sw_RES, SW_HW_Config.NB_OF_THREADS, SW_HW_Config.SW_ENGINE);
 
-		gettimeofday(&t, NULL);
-		tstop = 1.0e-6*t.tv_usec + t.tv_sec;
+		tstop = get_time_ms();
 
 		cout << "HOST_Info: SW Model Execution"                                                       << endl;
 		cout << "HOST_Info:     # Threads    = " <<  SW_HW_Config.NB_OF_THREADS                       << endl;
-		cout << "HOST_Info:     Runtime (ms) = " << fixed << setprecision(1) << (tstop-tstart)*1000.0 << endl << endl;
+		cout << "HOST_Info:     SW Engine    = " <<  SW_HW_Config.SW_ENGINE                           << endl;
+		if ((SW_HW_Config.SW_ENGINE == "simd") || (SW_HW_Config.SW_ENGINE == "batch"))
+		cout << "HOST_Info:     SIMD ISA     = " <<  sw_simd_isa_name()                               << endl;
+		cout << "HOST_Info:     Runtime (ms) = " << fixed << setprecision(1) << (tstop-tstart) << endl << endl;
+
+		// ============================================================================
+		// Step: Compare selected SW Engine against the original SW model
+		//       IMPORTANT: We compare only DEFINED_NB_OF_TESTS
+		// ============================================================================
+		if (SW_HW_Config.SW_ENGINE != "original") {
+			float* ref_RES = allocate_host_mem<float>(ROUNDED_NB_OF_TESTS,"ref_RES",true);
+
+			tstart = get_time_ms();
+
+			K_americanPut_sw_model(&host_IN_SOA, ref_RES, SW_HW_Config.NB_OF_THREADS, "original");
+
+			tstop = get_time_ms();
+
+			cout << "HOST_Info: SW Model Execution (Reference)"                                           << endl;
+			cout << "HOST_Info:     # Threads    = " <<  SW_HW_Config.NB_OF_THREADS                       << endl;
+			cout << "HOST_Info:     SW Engine    = " <<  "original"                                       << endl;
+			cout << "HOST_Info:     Runtime (ms) = " << fixed << setprecision(1) << (tstop-tstart) << endl << endl;
+
+			int Nb_Of_Errors = compare_results(ref_RES, sw_RES, DEFINED_NB_OF_TESTS, 5);
+			free(ref_RES);
+
+			if (Nb_Of_Errors == 0) {
+				cout << "HOST_Info: SW Engine " << SW_HW_Config.SW_ENGINE << " matches the original SW model" << endl << endl;
+			} else {
+				cout << "HOST_Info: SW Engine " << SW_HW_Config.SW_ENGINE << " does not match the original SW model (#Errors=" << Nb_Of_Errors << ")" << endl << endl;
+				return EXIT_FAILURE;
+			}
+		}
 
 		// ============================================================================
 		// Step: Store results in a file
 		// ============================================================================
 	    string HW_Out_File_Name = "SW_Res.txt";
 	    cout << "HOST-Info: Results stored in the " + HW_Out_File_Name + " file ..." << endl;
-	    store_results(SW_HW_Mode, HW_Out_File_Name, host_IN_DATA, hw_RES, &Test_Config);
+	    store_results(SW_HW_Mode, HW_Out_File_Name, host_IN_DATA, sw_RES, &Test_Config);
+
+		free(host_IN_DATA);
+		in_data_soa_free(&host_IN_SOA);
+		free(sw_RES);
+		free(hw_RES);
+
+		cout << endl << "HOST-Info: Application Completed" << endl << endl;
+		return EXIT_SUCCESS;
+	}
+
+	// ============================================================================
+	// ============================================================================
+	// Step: Run SW Scheduling Benchmark End Exit
+	// ============================================================================
+	// ============================================================================
+
+	if (SW_HW_Mode == "bench") {
+		cout << endl;
+		cout << "HOST-Info: ============================================================= " << endl;
+		cout << "HOST-Info: Step: Run SW Scheduling Benchmark                             " << endl;
+		cout << "HOST-Info: ============================================================= " << endl;
+		cout << "HOST_Info:     # Threads    = " <<  SW_HW_Config.NB_OF_THREADS                       << endl;
+		cout << "HOST_Info:     SW Engine    = " <<  SW_HW_Config.SW_ENGINE                           << endl;
+		cout << "HOST_Info:     # Tests      = " <<  DEFINED_NB_OF_TESTS                              << endl << endl;
+
+		t_in_data_soa host_IN_SOA_Defined = in_data_soa_view(host_IN_SOA, 0, DEFINED_NB_OF_TESTS);
+		run_sw_scheduling_benchmark(&host_IN_SOA_Defined, SW_HW_Config.NB_OF_THREADS, SW_HW_Config.SW_ENGINE, 10);
+
+		free(host_IN_DATA);
+		in_data_soa_free(&host_IN_SOA);
+		free(sw_RES);
+		free(hw_RES);
+
+		cout << endl << "HOST-Info: Application Completed" << endl << endl;
+		return EXIT_SUCCESS;
+	}
+
+	// ============================================================================
+	// ============================================================================
+	// Step: Run SW Precision Report End Exit
+	// ============================================================================
+	// ============================================================================
+
+	if (SW_HW_Mode == "precision") {
+		cout << endl;
+		cout << "HOST-Info: ============================================================= " << endl;
+		cout << "HOST-Info: Step: Run SW Precision Report                                 " << endl;
+		cout << "HOST-Info: ============================================================= " << endl;
+		cout << "HOST_Info:     # Threads    = " <<  SW_HW_Config.NB_OF_THREADS                       << endl;
+		cout << "HOST_Info:     SW Engine    = " <<  SW_HW_Config.SW_ENGINE                           << endl;
+		cout << "HOST_Info:     # Tests      = " <<  DEFINED_NB_OF_TESTS                              << endl << endl;
+
+		t_in_data_soa host_IN_SOA_Defined = in_data_soa_view(host_IN_SOA, 0, DEFINED_NB_OF_TESTS);
+		run_sw_precision_report(&host_IN_SOA_Defined, SW_HW_Config.NB_OF_THREADS, SW_HW_Config.SW_ENGINE);
+
+		free(host_IN_DATA);
+		in_data_soa_free(&host_IN_SOA);
+		free(sw_RES);
+		free(hw_RES);
 
 		cout << endl << "HOST-Info: Application Completed" << endl << endl;
 		return EXIT_SUCCESS;
@@ -490,6 +642,10 @@ int main(int argc, char* argv[])
 	clReleaseCommandQueue(Command_Queue);
 	clReleaseContext(Context);
 
+	free(host_IN_DATA);
+	free(sw_RES);
+	free(hw_RES);
+
 
 	cout << endl << "HOST-Info: Application Completed" << endl << endl;
 	return EXIT_SUCCESS;
@@ -19,9 +19,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <thread>
+#include <vector>
+#include <algorithm>
 
 #include "kernel.h"
 #include "help_functions.h"
+#include "SW.h"
+#include "SW_ThreadPool.h"
+#include "time_functions.h"
 #include "cmath"
 
 
@@ -41,6 +46,8 @@ float sw_calc_p0(int T, float S, float K, float r, float sigma, float q, int n)
 	float deltaT, up, p0, p1, exercise;
 	float p[CONST_MAX_TREE_HEIGHT];
 
+	if (n > CONST_MAX_TREE_HEIGHT) return sw_calc_p0_tiled(T, S, K, r, sigma, q, n);
+
 	deltaT = (float) T / n;
 	up = expf(sigma * sqrtf(deltaT));
 
@@ -66,27 +73,308 @@ float sw_calc_p0(int T, float S, float K, float r, float sigma, float q, int n)
 }
 
 
+// ============================================================================================================ //
+// ------------------------------------------------------------------------------------------------------------ //
+//                                   SW MODEL - Precomputed S*up^k Table
+// ------------------------------------------------------------------------------------------------------------ //
+// ============================================================================================================ //
+// The exponent (2*i - j) used by the exercise value is always in the [-n...n-2] range.
+// Therefore S*up^k is calculated once per option (2*n powf calls) and stored in the Su table,
+// instead of calling powf for every node of the tree (~n*n/2 powf calls).
+// Su[k+n] is calculated exactly as in sw_calc_p0, so both models produce identical results.
+// ============================================================================================================ //
+float sw_calc_p0_table(int T, float S, float K, float r, float sigma, float q, int n) {
+	//    T... expiration time
+	//    S... stock price
+	//    K... strike price
+	//    q... dividend yield
+	//    n... height of the binomial tree
+
+	float deltaT, up, p0, p1, exercise;
+	float p[CONST_MAX_TREE_HEIGHT];
+	float Su[2*CONST_MAX_TREE_HEIGHT];      // Su[k+n] = S * up^k, k = [-n...n-1]
+
+	if (n > CONST_MAX_TREE_HEIGHT) return sw_calc_p0_tiled(T, S, K, r, sigma, q, n);
+
+	deltaT = (float) T / n;
+	up = expf(sigma * sqrtf(deltaT));
+
+	p0 = (up*expf(-q * deltaT) - expf(-r * deltaT)) / (powf(up,2) - 1); // up^2
+	p1 = expf(-r * deltaT) - p0;
+
+	// S*up^k table
+	for (int k = -n; k < n; k++) {
+		Su[k+n] = S * powf(up,k);
+	}
+
+	// initial values at time T
+	for (int i = 0; i < n; i++) {
+		p[i] = K - Su[2*i]; // S*up^(2*i - n)
+		if (p[i] < 0) p[i] = 0;
+	}
+
+	// move to earlier times
+	for (int j = n-1; j > 0; j--) {
+		float* Su_j = &Su[n-j];  // Su_j[2*i] = S*up^(2*i - j)
+		for (int i = 0; i < j; i++) {
+			p[i] = p0 * p[i+1] + p1 * p[i];   // binomial value
+			exercise = K - Su_j[2*i];         // exercise value
+			if (p[i] < exercise) p[i] = exercise;
+		}
+	}
+
+	return (p[0]);
+}
+
+
+// ============================================================================================================ //
+// ------------------------------------------------------------------------------------------------------------ //
+//                                      SW MODEL - Tiled Backward Induction
+// ------------------------------------------------------------------------------------------------------------ //
+// ============================================================================================================ //
+// Supports any tree height n: the p column (n values) is kept in heap memory and the triangle is processed in
+// bands of SW_TILE_HEIGHT rows. Each band is split in tiles of SW_TILE_WIDTH values, processed from left to right.
+// In the row j = J-s of a band (s = 0 ... SW_TILE_HEIGHT-1), the tile starting at a updates p[a-s ... a+W-s-1]:
+//    o) p[i+1] read by the last node of the tile was updated by the same tile in the row j+1
+//    o) p[a-s] read by the first node was updated in the row j+1 by the previous tile, which stops at p[a-s-1]
+//       in the row j
+// so the rows of a tile are calculated in place while its values stay in the cache.
+//
+// The exercise values of a tile use exponents 2*i - j in a range of 2*SW_TILE_WIDTH + SW_TILE_HEIGHT values,
+// S*up^k is calculated once per tile for this range (as in sw_calc_p0_table). Every node is calculated with the
+// same operations as in sw_calc_p0, so both models produce identical results.
+// ============================================================================================================ //
+float sw_calc_p0_tiled(int T, float S, float K, float r, float sigma, float q, int n) {
+	//    T... expiration time
+	//    S... stock price
+	//    K... strike price
+	//    q... dividend yield
+	//    n... height of the binomial tree
+
+	static thread_local vector<float> Col;        // p column, reused by all options priced by a thread
+
+	float deltaT, up, p0, p1, exercise;
+	float Su[2*SW_TILE_WIDTH + SW_TILE_HEIGHT];   // Su[k-k_min] = S * up^k, for the exponents of a tile
+
+	if ((int)Col.size() < n) Col.resize(n);
+	float* p = Col.data();
+
+	deltaT = (float) T / n;
+	up = expf(sigma * sqrtf(deltaT));
+
+	p0 = (up*expf(-q * deltaT) - expf(-r * deltaT)) / (powf(up,2) - 1); // up^2
+	p1 = expf(-r * deltaT) - p0;
+
+	// initial values at time T
+	for (int i = 0; i < n; i++) {
+		p[i] = K - S * powf(up,(2*i - n)); // up^(2*i - n)
+		if (p[i] < 0) p[i] = 0;
+	}
+
+	// move to earlier times: bands of rows J ... J-H+1
+	for (int J = n-1; J > 0; ) {
+		int H = min(SW_TILE_HEIGHT, J);
+
+		for (int a = 0; a < J; a += SW_TILE_WIDTH) {
+
+			// S*up^k table for k = [k_min ... k_min + 2*SW_TILE_WIDTH + H - 2]
+			int k_min = 2*a - J - (H-1);
+			for (int k = 0; k < 2*SW_TILE_WIDTH + H - 1; k++) {
+				Su[k] = S * powf(up,k_min + k);
+			}
+
+			for (int s = 0; s < H; s++) {
+				int j  = J - s;
+				int lo = max(0, a - s);
+				int hi = min(j, a + SW_TILE_WIDTH - s);
+
+				for (int i = lo; i < hi; i++) {
+					p[i] = p0 * p[i+1] + p1 * p[i];        // binomial value
+					exercise = K - Su[2*i - j - k_min];    // exercise value // S*up^(2*i - j)
+					if (p[i] < exercise) p[i] = exercise;
+				}
+			}
+		}
+
+		J -= H;
+	}
+
+	return (p[0]);
+}
+
+
+// ============================================================================================================ //
+// ------------------------------------------------------------------------------------------------------------ //
+//                                   SW MODEL - Fixed Tree Heights
+// ------------------------------------------------------------------------------------------------------------ //
+// ============================================================================================================ //
+// sw_calc_p0_fixed_n<N> is sw_calc_p0_table compiled for a tree height N known at compile time:
+//    o) p[] and the S*up^k tables are stack arrays of exactly N values, the loop bounds and the 1/N division
+//       are constants
+//    o) S*up^k is stored in two tables of even and odd k: a row reads the exercise values of its nodes from
+//       consecutive entries of one table (sw_calc_p0_table reads every second entry of a single table)
+//    o) the nodes of a row are calculated in blocks of SW_FIXED_UNROLL nodes: the binomial values of a block
+//       are calculated from p[] first, then compared with the exercise values and stored, so the compiler
+//       calculates a block with vector instructions
+// A block only reads p[i ... i+SW_FIXED_UNROLL], which the nodes before it in the row do not change, so the
+// nodes are calculated with the same operations as in sw_calc_p0 and both models produce identical results.
+// sw_calc_p0_fixed dispatches n to the heights listed below and prices the other heights with
+// sw_calc_p0_table (generic fallback).
+// ============================================================================================================ //
+#ifndef SW_FIXED_UNROLL
+#define SW_FIXED_UNROLL 8
+#endif
+
+template <int N>
+static float sw_calc_p0_fixed_n(int T, float S, float K, float r, float sigma, float q) {
+	static_assert((N >= 2) && (N <= CONST_MAX_TREE_HEIGHT), "Unsupported fixed tree height");
+	static_assert((N % 2) == 0, "Fixed tree heights are even");
+
+	float deltaT, up, p0, p1, exercise;
+	float p[N];
+	float Su_Even[N];       // Su_Even[m] = S * up^(2*m - N),   m = [0...N-1]
+	float Su_Odd [N];       // Su_Odd [m] = S * up^(2*m+1 - N), m = [0...N-1]
+
+	deltaT = (float) T / N;
+	up = expf(sigma * sqrtf(deltaT));
+
+	p0 = (up*expf(-q * deltaT) - expf(-r * deltaT)) / (powf(up,2) - 1); // up^2
+	p1 = expf(-r * deltaT) - p0;
+
+	// S*up^k tables
+	for (int m = 0; m < N; m++) {
+		Su_Even[m] = S * powf(up, 2*m   - N);
+		Su_Odd [m] = S * powf(up, 2*m+1 - N);
+	}
+
+	// initial values at time T
+	for (int i = 0; i < N; i++) {
+		p[i] = K - Su_Even[i]; // S*up^(2*i - N)
+		if (p[i] < 0) p[i] = 0;
+	}
+
+	// move to earlier times
+	for (int j = N-1; j > 0; j--) {
+		// Su_j[i] = S*up^(2*i - j): N-j+2*i is even for even j
+		const float* Su_j = ((j % 2) == 0) ? &Su_Even[(N-j)/2] : &Su_Odd[(N-j)/2];
+		int i = 0;
+
+		for (; i + SW_FIXED_UNROLL <= j; i += SW_FIXED_UNROLL) {
+			float v[SW_FIXED_UNROLL];
+			for (int u = 0; u < SW_FIXED_UNROLL; u++)
+				v[u] = p0 * p[i+u+1] + p1 * p[i+u];              // binomial value
+			for (int u = 0; u < SW_FIXED_UNROLL; u++) {
+				exercise = K - Su_j[i+u];                          // exercise value
+				p[i+u]   = (v[u] < exercise) ? exercise : v[u];
+			}
+		}
+		for (; i < j; i++) {
+			p[i] = p0 * p[i+1] + p1 * p[i];
+			exercise = K - Su_j[i];
+			if (p[i] < exercise) p[i] = exercise;
+		}
+	}
+
+	return (p[0]);
+}
+
+float sw_calc_p0_fixed(int T, float S, float K, float r, float sigma, float q, int n) {
+	switch (n) {
+		case   64: return sw_calc_p0_fixed_n<  64>(T, S, K, r, sigma, q);
+		case  128: return sw_calc_p0_fixed_n< 128>(T, S, K, r, sigma, q);
+		case  256: return sw_calc_p0_fixed_n< 256>(T, S, K, r, sigma, q);
+		case  512: return sw_calc_p0_fixed_n< 512>(T, S, K, r, sigma, q);
+		case 1024: return sw_calc_p0_fixed_n<1024>(T, S, K, r, sigma, q);
+		default:   return sw_calc_p0_table(T, S, K, r, sigma, q, n);
+	}
+}
+
+
+// ============================================================================================================ //
+// ------------------------------------------------------------------------------------------------------------ //
+//                                              SW Engines
+// ------------------------------------------------------------------------------------------------------------ //
+// ============================================================================================================ //
+typedef struct {
+	string        name;
+	t_sw_calc_p0  calc_p0;            // Prices a single option
+	bool          batched;            // Options are grouped in work items and priced by sw_calc_p0_batch
+	bool          shared;             // Options are grouped by tree and priced by sw_calc_p0_shared
+} t_sw_engine;
+
+static const t_sw_engine SW_Engines[] = {
+	{"original", sw_calc_p0,       false, false},
+	{"table",    sw_calc_p0_table, false, false},
+	{"tiled",    sw_calc_p0_tiled, false, false},
+	{"simd",     sw_calc_p0_simd,  false, false},
+	{"batch",    sw_calc_p0_simd,  true , false},
+	{"mixed",    sw_calc_p0_mixed, false, false},
+	{"double",   sw_calc_p0_double,false, false},
+	{"fixed",    sw_calc_p0_fixed, false, false},
+	{"shared",   sw_calc_p0_table, false, true },
+};
+
+static const int Nb_Of_SW_Engines = sizeof(SW_Engines)/sizeof(SW_Engines[0]);
+
+vector<string> sw_engine_names() {
+	vector<string> names;
+	for (int i=0; i<Nb_Of_SW_Engines; i++) names.push_back(SW_Engines[i].name);
+	return names;
+}
+
+bool sw_engine_supported(string SW_Engine) {
+	for (int i=0; i<Nb_Of_SW_Engines; i++)
+		if (SW_Engines[i].name == SW_Engine) return true;
+	return false;
+}
+
+static const t_sw_engine* sw_engine(string SW_Engine) {
+	for (int i=0; i<Nb_Of_SW_Engines; i++)
+		if (SW_Engines[i].name == SW_Engine) return &SW_Engines[i];
+
+	cout << endl << "HOST-Error: Unsupported SW Engine: " << SW_Engine << endl << endl;
+	exit(1);
+}
+
+
 // ============================================================================================================ //
 // ------------------------------------------------------------------------------------------------------------ //
 //                               SW MODEL - Multi-threading Implementation
 // ------------------------------------------------------------------------------------------------------------ //
 // ============================================================================================================ //
-void K_americanPut_sw_model_task(t_in_data* host_IN_DATA, float* sw_RES, int Nb_Of_Tests, int Start_Index) {
+// -----------------------------------------------------------------
+// Static partitioning: new threads on every call, each thread gets
+// NB_OF_TESTS/Nb_Of_Threads consecutive tests (the last thread also
+// gets the remaining tests).
+// Kept as a reference for the SW scheduling benchmark.
+// -----------------------------------------------------------------
+void K_americanPut_sw_model_task(t_sw_calc_p0 calc_p0, t_in_data_soa* host_IN_SOA, float* sw_RES, int Nb_Of_Tests, int Start_Index, double Start_Time, double* Finish_Time) {
+
+	t_in_data_soa in_d = in_data_soa_view(*host_IN_SOA, Start_Index, Nb_Of_Tests);
+	float*        res  = &sw_RES[Start_Index];
 
 	for (int i = 0; i<Nb_Of_Tests; i++) {
-		int indx = Start_Index + i;
-		sw_RES[indx] = sw_calc_p0 (host_IN_DATA[indx].T, host_IN_DATA[indx].S, host_IN_DATA[indx].K, host_IN_DATA[indx].r, host_IN_DATA[indx].sigma, host_IN_DATA[indx].q, host_IN_DATA[indx].n);
+		res[i] = calc_p0 (in_d.T[i], in_d.S[i], in_d.K[i], in_d.r[i], in_d.sigma[i], in_d.q[i], in_d.n[i]);
 	}
 
+	*Finish_Time = get_time_ms() - Start_Time;
 }
 
-void K_americanPut_sw_model(t_in_data* host_IN_DATA, float* sw_RES, int NB_OF_TESTS, int Nb_Of_Threads) {
+void K_americanPut_sw_model_static(t_in_data_soa* host_IN_SOA, float* sw_RES, int Nb_Of_Threads, string SW_Engine, vector<double>* Thread_Finish_Time_ms) {
+
+	t_sw_calc_p0 calc_p0 = sw_engine(SW_Engine)->calc_p0;
 
+	int NB_OF_TESTS = host_IN_SOA->Nb_Of_Tests;
 	int Nb_of_Test_Vectors_per_Task = NB_OF_TESTS/Nb_Of_Threads;
 	thread* t = new thread[Nb_Of_Threads];
 
+	double Start_Time = get_time_ms();
+
+	Thread_Finish_Time_ms->assign(Nb_Of_Threads, 0);
+
 	for (int i=0; i<Nb_Of_Threads; i++) {
-		t[i] = thread(K_americanPut_sw_model_task, host_IN_DATA, sw_RES, Nb_of_Test_Vectors_per_Task, i*Nb_of_Test_Vectors_per_Task);
+		int Nb_Of_Tests = (i == Nb_Of_Threads-1) ? NB_OF_TESTS - i*Nb_of_Test_Vectors_per_Task : Nb_of_Test_Vectors_per_Task;
+		t[i] = thread(K_americanPut_sw_model_task, calc_p0, host_IN_SOA, sw_RES, Nb_Of_Tests, i*Nb_of_Test_Vectors_per_Task, Start_Time, &(*Thread_Finish_Time_ms)[i]);
 	}
 
 	for (int i=0; i<Nb_Of_Threads; i++) {
@@ -96,3 +384,94 @@ void K_americanPut_sw_model(t_in_data* host_IN_DATA, float* sw_RES, int NB_OF_TE
 	delete[] t;
 
 }
+
+// -----------------------------------------------------------------
+// Work-stealing thread pool (see SW_ThreadPool.h)
+//   o) the pool is created once and reused by all calls
+//   o) the cost of a test (or a work item of the batch engine) is
+//      proportional to n*n - the number of tree nodes
+// -----------------------------------------------------------------
+void K_americanPut_sw_model(t_in_data_soa* host_IN_SOA, float* sw_RES, int Nb_Of_Threads, string SW_Engine) {
+
+	const t_sw_engine*        engine = sw_engine(SW_Engine);
+	shared_ptr<SW_ThreadPool> pool   = sw_thread_pool(Nb_Of_Threads);
+	const int*                n      = host_IN_SOA->n;
+
+	// ---------------------------------------------------------
+	// Batched engine: group options and distribute work items
+	// ---------------------------------------------------------
+	if (engine->batched) {
+		vector<t_sw_work_item> Items = sw_batch_plan(host_IN_SOA, sw_batch_nb_of_lanes());
+
+		pool->parallel_for(Items.size(),
+			[&](int i) { double n_i = n[Items[i].Index[0]]; return n_i*n_i; },
+			[&](int Begin, int End) {
+				for (int i = Begin; i < End; i++)
+					sw_calc_p0_batch(host_IN_SOA, sw_RES, &Items[i]);
+			});
+		return;
+	}
+
+	// ---------------------------------------------------------
+	// Shared engine: tree parameters calculated once per group,
+	// then every option is priced from its S and K
+	// ---------------------------------------------------------
+	if (engine->shared) {
+		t_sw_tree_groups         Groups       = sw_tree_group_plan(host_IN_SOA);
+		int                      Nb_Of_Groups = Groups.Group_Start.size() - 1;
+		vector<t_sw_tree_params> Params(Nb_Of_Groups);
+		vector<t_sw_option>      Options(host_IN_SOA->Nb_Of_Tests);
+
+		for (int i = 0; i < host_IN_SOA->Nb_Of_Tests; i++) {
+			Options[i].S = host_IN_SOA->S[Groups.Order[i]];
+			Options[i].K = host_IN_SOA->K[Groups.Order[i]];
+		}
+
+		pool->parallel_for(Nb_Of_Groups,
+			[&](int g) { return (double) n[Groups.Order[Groups.Group_Start[g]]]; },
+			[&](int Begin, int End) {
+				for (int g = Begin; g < End; g++)
+					sw_tree_params_init(host_IN_SOA, Groups.Order[Groups.Group_Start[g]], &Params[g]);
+			});
+
+		pool->parallel_for(host_IN_SOA->Nb_Of_Tests,
+			[&](int i) { double n_i = n[Groups.Order[i]]; return n_i*n_i; },
+			[&](int Begin, int End) {
+				for (int i = Begin; i < End; i++) {
+					int indx = Groups.Order[i];
+					if (n[indx] > CONST_MAX_TREE_HEIGHT)
+						sw_RES[indx] = sw_calc_p0_tiled(host_IN_SOA->T[indx], Options[i].S, Options[i].K, host_IN_SOA->r[indx], host_IN_SOA->sigma[indx], host_IN_SOA->q[indx], n[indx]);
+					else
+						sw_RES[indx] = sw_calc_p0_shared(&Params[Groups.Group[i]], Options[i].S, Options[i].K);
+				}
+			});
+		return;
+	}
+
+	// ---------------------------------------------------------
+	// Single option engines
+	// ---------------------------------------------------------
+	t_sw_calc_p0 calc_p0 = engine->calc_p0;
+
+	pool->parallel_for(host_IN_SOA->Nb_Of_Tests,
+		[&](int i) { double n_i = n[i]; return n_i*n_i; },
+		[&](int Begin, int End) {
+			t_in_data_soa in_d = in_data_soa_view(*host_IN_SOA, Begin, End-Begin);
+			float*        res  = &sw_RES[Begin];
+			for (int i = 0; i < End-Begin; i++)
+				res[i] = calc_p0 (in_d.T[i], in_d.S[i], in_d.K[i], in_d.r[i], in_d.sigma[i], in_d.q[i], in_d.n[i]);
+		});
+}
+
+void K_americanPut_sw_model(t_in_data* host_IN_DATA, float* sw_RES, int NB_OF_TESTS, int Nb_Of_Threads) {
+	K_americanPut_sw_model(host_IN_DATA, sw_RES, NB_OF_TESTS, Nb_Of_Threads, "original");
+}
+
+void K_americanPut_sw_model(t_in_data* host_IN_DATA, float* sw_RES, int NB_OF_TESTS, int Nb_Of_Threads, string SW_Engine) {
+	t_in_data_soa host_IN_SOA = in_data_soa_alloc(NB_OF_TESTS);
+
+	in_data_aos_to_soa(host_IN_DATA, host_IN_SOA);
+	K_americanPut_sw_model(&host_IN_SOA, sw_RES, Nb_Of_Threads, SW_Engine);
+
+	in_data_soa_free(&host_IN_SOA);
+}
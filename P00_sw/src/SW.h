@@ -0,0 +1,115 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#ifndef __SW_H__
+#define __SW_H__
+
+#include <string>
+#include <vector>
+
+#include "kernel.h"
+#include "SW_SoA.h"
+
+using namespace std;
+
+// ============================================================================
+// SW Engines
+//   o) original : sw_calc_p0       (powf() for every node of the tree)
+//   o) table    : sw_calc_p0_table (S*up^k taken from a per-option table)
+//   o) tiled    : sw_calc_p0_tiled (backward induction in tiles, any tree height)
+//   o) simd     : sw_calc_p0_simd  (SIMD backward induction, ISA selected at runtime)
+//   o) batch    : sw_calc_p0_batch (options sharing a tree priced together in SIMD lanes)
+//   o) mixed    : sw_calc_p0_mixed (float p column, double accumulation, see SW_Precision.h)
+//   o) double   : sw_calc_p0_double (double precision, see SW_Precision.h)
+//   o) fixed    : sw_calc_p0_fixed (compiled for the tree heights 64, 128, 256, 512 and 1024)
+//   o) shared   : sw_calc_p0_shared (tree parameters calculated once per group of options, see SW_Shared.cpp)
+// ============================================================================
+// Trees taller than CONST_MAX_TREE_HEIGHT are priced by sw_calc_p0_tiled (all engines)
+#define SW_MAX_TREE_HEIGHT 65536
+#ifndef SW_TILE_WIDTH
+#define SW_TILE_WIDTH      1024
+#endif
+#ifndef SW_TILE_HEIGHT
+#define SW_TILE_HEIGHT     256
+#endif
+
+typedef float (*t_sw_calc_p0)(int T, float S, float K, float r, float sigma, float q, int n);
+
+#define SW_MAX_LANES 16
+
+typedef struct {
+	int Nb_Of_Options;                // 1: single option, >1: options priced together in SIMD lanes
+	int Index[SW_MAX_LANES];          // Indexes of the options in host_IN_SOA
+} t_sw_work_item;
+
+// ============================================================================
+// Tree groups (SW_Shared.cpp)
+//   Options with the same T, r, sigma, q and n share deltaT, up, p0, p1 and
+//   up^k. The options of the group g are
+//   Order[Group_Start[g] ... Group_Start[g+1]-1].
+// ============================================================================
+typedef struct {
+	vector<int> Order;                // Indexes of the options in host_IN_SOA, sorted by tree
+	vector<int> Group;                // Group of Order[i]
+	vector<int> Group_Start;          // First entry of every group in Order (last entry: Nb_Of_Tests)
+} t_sw_tree_groups;
+
+typedef struct {
+	int           n;
+	float         p0, p1;
+	vector<float> U;                  // U[k+n] = up^k, k = [-n...n-1] (empty if n > CONST_MAX_TREE_HEIGHT)
+} t_sw_tree_params;
+
+typedef struct {
+	float S, K;                       // Per-option record of the shared engine
+} t_sw_option;
+
+float sw_calc_p0       (int T, float S, float K, float r, float sigma, float q, int n);
+float sw_calc_p0_table (int T, float S, float K, float r, float sigma, float q, int n);
+float sw_calc_p0_tiled (int T, float S, float K, float r, float sigma, float q, int n);
+float sw_calc_p0_simd  (int T, float S, float K, float r, float sigma, float q, int n);
+float sw_calc_p0_mixed (int T, float S, float K, float r, float sigma, float q, int n);
+float sw_calc_p0_double(int T, float S, float K, float r, float sigma, float q, int n);
+float sw_calc_p0_fixed (int T, float S, float K, float r, float sigma, float q, int n);
+
+string sw_simd_isa_name();
+
+int                    sw_batch_nb_of_lanes();
+vector<t_sw_work_item> sw_batch_plan(t_in_data_soa* host_IN_SOA, int Nb_Of_Lanes);
+void                   sw_calc_p0_batch(t_in_data_soa* host_IN_SOA, float* sw_RES, t_sw_work_item* Item);
+
+t_sw_tree_groups sw_tree_group_plan (t_in_data_soa* host_IN_SOA);
+void             sw_tree_params_calc(t_in_data_soa* host_IN_SOA, int Index, float* p0, float* p1, float* U);
+void             sw_tree_params_init(t_in_data_soa* host_IN_SOA, int Index, t_sw_tree_params* Params);
+float            sw_calc_p0_shared  (const t_sw_tree_params* Params, float S, float K);
+
+vector<string> sw_engine_names();
+bool           sw_engine_supported(string SW_Engine);
+
+// The SW model works on SoA test vectors (host_IN_SOA->Nb_Of_Tests tests).
+// The t_in_data versions convert the test vectors to SoA first.
+void K_americanPut_sw_model(t_in_data_soa* host_IN_SOA, float* sw_RES, int Nb_Of_Threads, string SW_Engine);
+void K_americanPut_sw_model(t_in_data* host_IN_DATA, float* sw_RES, int NB_OF_TESTS, int Nb_Of_Threads);
+void K_americanPut_sw_model(t_in_data* host_IN_DATA, float* sw_RES, int NB_OF_TESTS, int Nb_Of_Threads, string SW_Engine);
+void K_americanPut_sw_model_static(t_in_data_soa* host_IN_SOA, float* sw_RES, int Nb_Of_Threads, string SW_Engine, vector<double>* Thread_Finish_Time_ms);
+
+void run_sw_scheduling_benchmark(t_in_data_soa* host_IN_SOA, int Nb_Of_Threads, string SW_Engine, int Nb_Of_Runs);
+void run_sw_microbenchmark(const char* MicroBench_Config_File_Name);
+void run_sw_precision_report(t_in_data_soa* host_IN_SOA, int Nb_Of_Threads, string SW_Engine);
+
+#endif
@@ -0,0 +1,399 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include "kernel.h"
+#include "help_functions.h"
+#include "SW.h"
+#include "SW_ThreadPool.h"
+#include "time_functions.h"
+
+float hw_calc_p0_0 (t_in_data in_d);
+
+// Percentile (0 < p <= 1) of the values
+static double percentile(vector<double> values, double p) {
+	sort(values.begin(), values.end());
+	int indx = (int) ceil(p * values.size()) - 1;
+	if (indx < 0) indx = 0;
+	return values[indx];
+}
+
+
+// ============================================================================================================ //
+// ------------------------------------------------------------------------------------------------------------ //
+//                                       SW Scheduling Benchmark
+// ------------------------------------------------------------------------------------------------------------ //
+// ============================================================================================================ //
+// Compares the two ways of distributing tests across the threads:
+//    o) static : new threads on every call, NB_OF_TESTS/Nb_Of_Threads consecutive tests per thread
+//    o) pool   : persistent work-stealing thread pool with chunks weighted by n*n
+// For each scheme, the tests are priced Nb_Of_Runs times (after one warm-up run) and we report:
+//    o) Runtime     : wall time of the call (median and p99)
+//    o) Thread Skew : time between the first and the last thread running out of work (median and p99)
+//    o) Idle        : average share of the runtime the threads spent without work
+// The static scheme always prices single options, so for the batch engine it uses sw_calc_p0_simd and for the
+// shared engine sw_calc_p0_table.
+// ============================================================================================================ //
+typedef struct {
+	string         name;
+	vector<double> runtime_ms;
+	vector<double> skew_ms;
+	vector<double> idle;
+} t_sched_stat;
+
+static void record_thread_times(t_sched_stat* stat, double runtime_ms, const vector<double>& Thread_Finish_Time_ms) {
+	double first = *min_element(Thread_Finish_Time_ms.begin(), Thread_Finish_Time_ms.end());
+	double last  = *max_element(Thread_Finish_Time_ms.begin(), Thread_Finish_Time_ms.end());
+	double busy  = 0;
+
+	for (unsigned i=0; i<Thread_Finish_Time_ms.size(); i++) busy += Thread_Finish_Time_ms[i];
+
+	stat->runtime_ms.push_back(runtime_ms);
+	stat->skew_ms.push_back(last - first);
+	stat->idle.push_back((last > 0) ? 1.0 - busy / (last * Thread_Finish_Time_ms.size()) : 0.0);
+}
+
+void run_sw_scheduling_benchmark(t_in_data_soa* host_IN_SOA, int Nb_Of_Threads, string SW_Engine, int Nb_Of_Runs) {
+	int NB_OF_TESTS = host_IN_SOA->Nb_Of_Tests;
+
+	float* static_RES = allocate_host_mem<float>(NB_OF_TESTS,"static_RES",true);
+	float* pool_RES   = allocate_host_mem<float>(NB_OF_TESTS,"pool_RES",true);
+
+	t_sched_stat Static_Stat, Pool_Stat;
+	Static_Stat.name = "static";
+	Pool_Stat.name   = "pool";
+
+	vector<double> Thread_Finish_Time_ms;
+	double tstart;
+
+	cout << "HOST-Info: Benchmarking SW scheduling (" << Nb_Of_Runs << " runs + 1 warm-up run per scheme) ..." << endl << endl;
+
+	for (int run = 0; run <= Nb_Of_Runs; run++) {
+
+		// Static partitioning
+		// .........................
+		tstart = get_time_ms();
+		K_americanPut_sw_model_static(host_IN_SOA, static_RES, Nb_Of_Threads, SW_Engine, &Thread_Finish_Time_ms);
+		if (run > 0) record_thread_times(&Static_Stat, get_time_ms() - tstart, Thread_Finish_Time_ms);
+
+		// Work-stealing pool
+		// .........................
+		tstart = get_time_ms();
+		K_americanPut_sw_model(host_IN_SOA, pool_RES, Nb_Of_Threads, SW_Engine);
+		if (run > 0) record_thread_times(&Pool_Stat, get_time_ms() - tstart, sw_thread_pool(Nb_Of_Threads)->Thread_Finish_Time_ms);
+	}
+
+	// ------------------------------
+	// Print Benchmark results
+	// ------------------------------
+	t_sched_stat* Stats[2] = {&Static_Stat, &Pool_Stat};
+
+	cout << "HOST-Info: " << string(86, '-') << endl;
+	cout << "HOST-Info: " << left << setw(8) << "Scheme"
+	     << " | " << right << setw(12) << "Runtime(ms)" << " | " << setw(12) << "Runtime(ms)"
+	     << " | " << setw(12) << "Skew(ms)"    << " | " << setw(12) << "Skew(ms)"
+	     << " | " << setw(8)  << "Idle(%)"     << endl;
+	cout << "HOST-Info: " << left << setw(8) << ""
+	     << " | " << right << setw(12) << "median" << " | " << setw(12) << "p99"
+	     << " | " << setw(12) << "median"      << " | " << setw(12) << "p99"
+	     << " | " << setw(8)  << "mean"        << endl;
+	cout << "HOST-Info: " << string(86, '-') << endl;
+
+	for (int i = 0; i < 2; i++) {
+		double idle = 0;
+		for (unsigned k = 0; k < Stats[i]->idle.size(); k++) idle += Stats[i]->idle[k];
+		idle = 100.0 * idle / Stats[i]->idle.size();
+
+		cout << "HOST-Info: " << left << setw(8) << Stats[i]->name << fixed << setprecision(1)
+		     << " | " << right << setw(12) << percentile(Stats[i]->runtime_ms, 0.50) << " | " << setw(12) << percentile(Stats[i]->runtime_ms, 0.99)
+		     << " | " << setw(12) << percentile(Stats[i]->skew_ms, 0.50)    << " | " << setw(12) << percentile(Stats[i]->skew_ms, 0.99)
+		     << " | " << setw(8)  << idle << endl;
+	}
+	cout << "HOST-Info: " << string(86, '-') << endl;
+
+	shared_ptr<SW_ThreadPool> pool = sw_thread_pool(Nb_Of_Threads);
+	cout << "HOST-Info: pool: #chunks=" << pool->Nb_Of_Chunks << " #steals=" << pool->Nb_Of_Steals << " (last run)" << endl << endl;
+
+	// ------------------------------
+	// Both schemes should produce the same results
+	// ------------------------------
+	int Nb_Of_Errors = compare_results(static_RES, pool_RES, NB_OF_TESTS, 5);
+	if (Nb_Of_Errors != 0)
+		cout << "HOST-Info: static and pool results do not match (#Errors=" << Nb_Of_Errors << ")" << endl << endl;
+
+	free(static_RES);
+	free(pool_RES);
+}
+
+
+// ============================================================================================================ //
+// ------------------------------------------------------------------------------------------------------------ //
+//                                         SW Pricing Microbenchmark
+// ------------------------------------------------------------------------------------------------------------ //
+// ============================================================================================================ //
+// Sweeps tree height x batch size x thread count x engine (see microbench_config.txt). Every point prices a
+// batch of options sharing n (K increased by K_Step for each option) NB_OF_WARMUP_RUNS times without timing,
+// then NB_OF_RUNS timed times, and reports:
+//    o) Runtime     : median, p99 and min of the timed runs
+//    o) Options/s   : batch size / median runtime
+//    o) Nodes/s     : tree nodes (n*(n+1)/2 per option) / median runtime, and ns per node and thread
+// The results are printed and stored in a JSON file for regression tracking.
+// Engines are the SW engines (sw_engine_names) and "kernel": the C++ model of the kernel (hw_calc_p0_0 in
+// K0.cpp), which only supports trees up to CONST_MAX_TREE_HEIGHT.
+// ============================================================================================================ //
+typedef struct {
+	vector<int>    Tree_Heights;
+	vector<int>    Batch_Sizes;
+	vector<int>    Nb_Of_Threads;
+	vector<string> Engines;
+	int            Nb_Of_Runs;
+	int            Nb_Of_Warmup_Runs;
+	test_config_t  Option;                     // n and NB_OF_TESTS are set by each point of the sweep
+	string         JSON_File_Name;
+} t_microbench_config;
+
+typedef struct {
+	string Engine;
+	int    n;
+	int    Batch_Size;
+	int    Nb_Of_Threads;
+	double Median_ms;
+	double P99_ms;
+	double Min_ms;
+	double Options_Per_Sec;
+	double Nodes_Per_Sec;
+	double ns_Per_Node;                       // per thread
+} t_microbench_result;
+
+static void read_microbench_config_file(const char* File_Name, t_microbench_config* Config) {
+	vector<char> Buffer;
+	char*        Tokens[CFG_MAX_TOKENS_PER_LINE];
+	char*        in_line;
+	int          line_nb = 0;
+
+	Config->Nb_Of_Runs        = 10;
+	Config->Nb_Of_Warmup_Runs = 2;
+	Config->JSON_File_Name    = "SW_MicroBench.json";
+	Config->Option.Company_Name = "MicroBench";
+	Config->Option.T = 1; Config->Option.S = 110.0f; Config->Option.K = 100.0f;
+	Config->Option.r = 0.025f; Config->Option.sigma = 0.2f; Config->Option.q = 0.1f; Config->Option.K_Step = 0.01f;
+
+	cfg_read_file(File_Name, &Buffer);
+	char* Pos = Buffer.data();
+	char* End = Buffer.data() + Buffer.size() - 1;
+
+	while ((in_line = cfg_next_line(&Pos, End)) != NULL) {
+		line_nb ++;
+		int nb_of_tokens = cfg_split_line(in_line, Tokens, CFG_MAX_TOKENS_PER_LINE);
+		if (nb_of_tokens == 0) continue;
+
+		string Key = Tokens[0];
+		if (nb_of_tokens < 2) {
+			cout << endl << "HOST-Error: " << File_Name << " (line " << line_nb << "):  Missing value: " << cfg_line_string(Tokens, nb_of_tokens) << endl << endl;
+			exit(1);
+		}
+
+		if      (Key == "TREE_HEIGHT")       { for (int i=1; i<nb_of_tokens; i++) Config->Tree_Heights.push_back (cfg_to_int(Tokens[i], File_Name, line_nb)); }
+		else if (Key == "BATCH_SIZE")        { for (int i=1; i<nb_of_tokens; i++) Config->Batch_Sizes.push_back  (cfg_to_int(Tokens[i], File_Name, line_nb)); }
+		else if (Key == "NB_OF_THREADS")     { for (int i=1; i<nb_of_tokens; i++) Config->Nb_Of_Threads.push_back(cfg_to_int(Tokens[i], File_Name, line_nb)); }
+		else if (Key == "ENGINE")            { for (int i=1; i<nb_of_tokens; i++) Config->Engines.push_back(Tokens[i]); }
+		else if (Key == "NB_OF_RUNS")        { Config->Nb_Of_Runs        = cfg_to_int(Tokens[1], File_Name, line_nb); }
+		else if (Key == "NB_OF_WARMUP_RUNS") { Config->Nb_Of_Warmup_Runs = cfg_to_int(Tokens[1], File_Name, line_nb); }
+		else if (Key == "JSON_FILE")         { Config->JSON_File_Name    = Tokens[1]; }
+		else if ((Key == "OPTION") && (nb_of_tokens == 8)) {
+			Config->Option.T      = cfg_to_int  (Tokens[1], File_Name, line_nb);
+			Config->Option.S      = cfg_to_float(Tokens[2], File_Name, line_nb);
+			Config->Option.K      = cfg_to_float(Tokens[3], File_Name, line_nb);
+			Config->Option.r      = cfg_to_float(Tokens[4], File_Name, line_nb);
+			Config->Option.sigma  = cfg_to_float(Tokens[5], File_Name, line_nb);
+			Config->Option.q      = cfg_to_float(Tokens[6], File_Name, line_nb);
+			Config->Option.K_Step = cfg_to_float(Tokens[7], File_Name, line_nb);
+		} else {
+			cout << endl << "HOST-Error: " << File_Name << " (line " << line_nb << "):  Incorrect line: " << cfg_line_string(Tokens, nb_of_tokens) << endl;
+			cout <<         "            Expected: TREE_HEIGHT, BATCH_SIZE, NB_OF_THREADS, ENGINE, NB_OF_RUNS, NB_OF_WARMUP_RUNS, JSON_FILE or OPTION <T> <S> <K> <r> <sigma> <q> <K_Step>" << endl << endl;
+			exit(1);
+		}
+	}
+
+	// ---------------------------------
+	// Check the configuration
+	// ---------------------------------
+	if (Config->Tree_Heights.empty() || Config->Batch_Sizes.empty() || Config->Nb_Of_Threads.empty() || Config->Engines.empty()) {
+		cout << endl << "HOST-Error: " << File_Name << ": TREE_HEIGHT, BATCH_SIZE, NB_OF_THREADS and ENGINE lines are required" << endl << endl;
+		exit(1);
+	}
+	for (unsigned i=0; i<Config->Tree_Heights.size(); i++) {
+		if ((Config->Tree_Heights[i] < 2) || (Config->Tree_Heights[i] > SW_MAX_TREE_HEIGHT)) {
+			cout << endl << "HOST-Error: " << File_Name << ": TREE_HEIGHT " << Config->Tree_Heights[i] << " is not in [2 ... " << SW_MAX_TREE_HEIGHT << "]" << endl << endl;
+			exit(1);
+		}
+	}
+	for (unsigned i=0; i<Config->Batch_Sizes.size(); i++) {
+		if (Config->Batch_Sizes[i] < 1) {
+			cout << endl << "HOST-Error: " << File_Name << ": BATCH_SIZE should be at least 1" << endl << endl;
+			exit(1);
+		}
+	}
+	for (unsigned i=0; i<Config->Nb_Of_Threads.size(); i++) {
+		if (Config->Nb_Of_Threads[i] < 1) {
+			cout << endl << "HOST-Error: " << File_Name << ": NB_OF_THREADS should be at least 1" << endl << endl;
+			exit(1);
+		}
+	}
+	for (unsigned i=0; i<Config->Engines.size(); i++) {
+		if ((Config->Engines[i] != "kernel") && !sw_engine_supported(Config->Engines[i])) {
+			cout << endl << "HOST-Error: " << File_Name << ": Unsupported ENGINE " << Config->Engines[i] << endl;
+			cout <<         "            Supported engines are: kernel";
+			vector<string> names = sw_engine_names();
+			for (unsigned k=0; k<names.size(); k++) cout << ", " << names[k];
+			cout << endl << endl;
+			exit(1);
+		}
+	}
+	if (Config->Nb_Of_Runs < 1) {
+		cout << endl << "HOST-Error: " << File_Name << ": NB_OF_RUNS should be at least 1" << endl << endl;
+		exit(1);
+	}
+}
+
+// The kernel C++ model prices one t_in_data record, the tests are distributed by the thread pool
+static void K_americanPut_kernel_model(t_in_data* host_IN_DATA, float* RES, int NB_OF_TESTS, int Nb_Of_Threads) {
+	sw_thread_pool(Nb_Of_Threads)->parallel_for(NB_OF_TESTS,
+		[&](int i) { double n_i = host_IN_DATA[i].n; return n_i*n_i; },
+		[&](int Begin, int End) {
+			for (int i = Begin; i < End; i++)
+				RES[i] = hw_calc_p0_0(host_IN_DATA[i]);
+		});
+}
+
+static void store_microbench_json(t_microbench_config* Config, vector<t_microbench_result>* Results) {
+	fstream JSON_File;
+	JSON_File.open(Config->JSON_File_Name, ios::out);
+	if (!JSON_File.is_open()) {
+		cout << endl << "HOST-Error: Unable to open a file for write: " << Config->JSON_File_Name << endl << endl;
+		exit(1);
+	}
+
+	JSON_File << "{" << endl;
+	JSON_File << "  \"benchmark\": \"sw_microbench\"," << endl;
+	JSON_File << "  \"simd_isa\": \"" << sw_simd_isa_name() << "\"," << endl;
+	JSON_File << "  \"hardware_threads\": " << thread::hardware_concurrency() << "," << endl;
+	JSON_File << "  \"nb_of_runs\": " << Config->Nb_Of_Runs << "," << endl;
+	JSON_File << "  \"nb_of_warmup_runs\": " << Config->Nb_Of_Warmup_Runs << "," << endl;
+	JSON_File << "  \"results\": [";
+
+	for (unsigned i=0; i<Results->size(); i++) {
+		t_microbench_result* Res = &(*Results)[i];
+		JSON_File << ((i == 0) ? "" : ",") << endl;
+		JSON_File << "    {\"engine\": \"" << Res->Engine << "\", \"n\": " << Res->n << ", \"batch_size\": " << Res->Batch_Size
+		          << ", \"threads\": " << Res->Nb_Of_Threads << setprecision(6) << defaultfloat
+		          << ", \"median_ms\": " << Res->Median_ms << ", \"p99_ms\": " << Res->P99_ms << ", \"min_ms\": " << Res->Min_ms
+		          << ", \"options_per_sec\": " << Res->Options_Per_Sec << ", \"nodes_per_sec\": " << Res->Nodes_Per_Sec
+		          << ", \"ns_per_node\": " << Res->ns_Per_Node << "}";
+	}
+	JSON_File << endl << "  ]" << endl << "}" << endl;
+	JSON_File.close();
+}
+
+void run_sw_microbenchmark(const char* MicroBench_Config_File_Name) {
+	t_microbench_config         Config;
+	vector<t_microbench_result> Results;
+
+	read_microbench_config_file(MicroBench_Config_File_Name, &Config);
+
+	cout << "HOST-Info: Benchmarking the pricing engines (" << Config.Nb_Of_Runs << " runs + " << Config.Nb_Of_Warmup_Runs << " warm-up runs per point, SIMD ISA: " << sw_simd_isa_name() << ") ..." << endl << endl;
+
+	cout << "HOST-Info: " << string(99, '-') << endl;
+	cout << "HOST-Info: " << left << setw(8) << "Engine" << " | " << right << setw(6) << "n" << " | " << setw(6) << "Batch" << " | " << setw(7) << "Threads"
+	     << " | " << setw(11) << "Median(ms)" << " | " << setw(11) << "p99(ms)" << " | " << setw(11) << "Options/s" << " | " << setw(11) << "MNodes/s"
+	     << " | " << setw(8) << "ns/node" << endl;
+	cout << "HOST-Info: " << string(99, '-') << endl;
+
+	for (unsigned b=0; b<Config.Batch_Sizes.size(); b++) {
+		int Batch_Size = Config.Batch_Sizes[b];
+
+		t_in_data*    host_IN_DATA = allocate_host_mem<t_in_data>(Batch_Size,"host_IN_DATA",false);
+		t_in_data_soa host_IN_SOA  = in_data_soa_alloc(Batch_Size);
+		float*        RES          = allocate_host_mem<float>(Batch_Size,"RES",false);
+
+		for (unsigned h=0; h<Config.Tree_Heights.size(); h++) {
+			int n = Config.Tree_Heights[h];
+
+			vector<test_config_t> Test_Config(1, Config.Option);
+			Test_Config[0].n           = n;
+			Test_Config[0].NB_OF_TESTS = Batch_Size;
+			generate_test_vectors(host_IN_DATA, &Test_Config, 0, Batch_Size);
+			in_data_aos_to_soa(host_IN_DATA, host_IN_SOA);
+
+			for (unsigned t=0; t<Config.Nb_Of_Threads.size(); t++) {
+				int Nb_Of_Threads = Config.Nb_Of_Threads[t];
+
+				for (unsigned e=0; e<Config.Engines.size(); e++) {
+					string Engine = Config.Engines[e];
+
+					if ((Engine == "kernel") && (n > CONST_MAX_TREE_HEIGHT)) {
+						cout << "HOST-Info: " << left << setw(8) << Engine << " | " << right << setw(6) << n << " | " << setw(6) << Batch_Size << " | " << setw(7) << Nb_Of_Threads
+						     << " | skipped (n > CONST_MAX_TREE_HEIGHT)" << endl;
+						continue;
+					}
+
+					vector<double> Runtime_ms;
+					for (int run = 0; run < Config.Nb_Of_Warmup_Runs + Config.Nb_Of_Runs; run++) {
+						double tstart = get_time_ms();
+						if (Engine == "kernel") K_americanPut_kernel_model(host_IN_DATA, RES, Batch_Size, Nb_Of_Threads);
+						else                    K_americanPut_sw_model(&host_IN_SOA, RES, Nb_Of_Threads, Engine);
+						if (run >= Config.Nb_Of_Warmup_Runs) Runtime_ms.push_back(get_time_ms() - tstart);
+					}
+
+					t_microbench_result Res;
+					double Nb_Of_Nodes = (double)Batch_Size * n * (n+1) / 2;
+
+					Res.Engine          = Engine;
+					Res.n               = n;
+					Res.Batch_Size      = Batch_Size;
+					Res.Nb_Of_Threads   = Nb_Of_Threads;
+					Res.Median_ms       = percentile(Runtime_ms, 0.50);
+					Res.P99_ms          = percentile(Runtime_ms, 0.99);
+					Res.Min_ms          = *min_element(Runtime_ms.begin(), Runtime_ms.end());
+					Res.Options_Per_Sec = (Res.Median_ms > 0) ? Batch_Size  * 1.0e3 / Res.Median_ms : 0;
+					Res.Nodes_Per_Sec   = (Res.Median_ms > 0) ? Nb_Of_Nodes * 1.0e3 / Res.Median_ms : 0;
+					Res.ns_Per_Node     = Res.Median_ms * 1.0e6 * min(Nb_Of_Threads, Batch_Size) / Nb_Of_Nodes;
+					Results.push_back(Res);
+
+					cout << "HOST-Info: " << left << setw(8) << Engine << " | " << right << setw(6) << n << " | " << setw(6) << Batch_Size << " | " << setw(7) << Nb_Of_Threads
+					     << fixed << setprecision(3) << " | " << setw(11) << Res.Median_ms << " | " << setw(11) << Res.P99_ms
+					     << setprecision(0) << " | " << setw(11) << Res.Options_Per_Sec << setprecision(1) << " | " << setw(11) << Res.Nodes_Per_Sec * 1.0e-6
+					     << setprecision(3) << " | " << setw(8) << Res.ns_Per_Node << endl;
+				}
+			}
+		}
+
+		free(host_IN_DATA);
+		free(RES);
+		in_data_soa_free(&host_IN_SOA);
+	}
+	cout << "HOST-Info: " << string(99, '-') << endl << endl;
+
+	store_microbench_json(&Config, &Results);
+	cout << "HOST-Info: Results stored in the " << Config.JSON_File_Name << " file" << endl;
+}
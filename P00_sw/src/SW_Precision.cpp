@@ -0,0 +1,111 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "kernel.h"
+#include "help_functions.h"
+#include "SW.h"
+#include "SW_Precision.h"
+#include "SW_ThreadPool.h"
+#include "time_functions.h"
+
+
+// ============================================================================================================ //
+// ------------------------------------------------------------------------------------------------------------ //
+//                                          SW MODEL - Precision Engines
+// ------------------------------------------------------------------------------------------------------------ //
+// ============================================================================================================ //
+float sw_calc_p0_double(int T, float S, float K, float r, float sigma, float q, int n) {
+	return (float) sw_calc_p0_prec<double, double>(T, S, K, r, sigma, q, n);
+}
+
+float sw_calc_p0_mixed(int T, float S, float K, float r, float sigma, float q, int n) {
+	return (float) sw_calc_p0_prec<float, double>(T, S, K, r, sigma, q, n);
+}
+
+
+// ============================================================================================================ //
+// ------------------------------------------------------------------------------------------------------------ //
+//                                            SW Precision Report
+// ------------------------------------------------------------------------------------------------------------ //
+// ============================================================================================================ //
+// Prices the tests with the original (float), mixed and double engines (and the selected engine) and compares
+// the results against a double reference (sw_calc_p0_prec<double,double>, not rounded to float):
+//    o) Max Abs / Max Rel : largest absolute and relative error
+//    o) RMS Abs           : root mean square of the absolute errors
+//    o) #Out of Tol.      : results cmp_floats rejects against the reference rounded to float
+// The relative error is only calculated for reference values above SW_PRECISION_MIN_VALUE.
+// ============================================================================================================ //
+#define SW_PRECISION_MIN_VALUE 1.0e-3
+
+void run_sw_precision_report(t_in_data_soa* host_IN_SOA, int Nb_Of_Threads, string SW_Engine) {
+	int             NB_OF_TESTS = host_IN_SOA->Nb_Of_Tests;
+	const int*      n           = host_IN_SOA->n;
+	vector<double>  ref_RES(NB_OF_TESTS);
+	float*          sw_RES      = allocate_host_mem<float>(NB_OF_TESTS,"sw_RES",true);
+
+	// ---------------------------------
+	// Double reference
+	// ---------------------------------
+	double tstart = get_time_ms();
+	sw_thread_pool(Nb_Of_Threads)->parallel_for(NB_OF_TESTS,
+		[&](int i) { double n_i = n[i]; return n_i*n_i; },
+		[&](int Begin, int End) {
+			t_in_data_soa in_d = *host_IN_SOA;
+			for (int i = Begin; i < End; i++)
+				ref_RES[i] = sw_calc_p0_prec<double, double>(in_d.T[i], in_d.S[i], in_d.K[i], in_d.r[i], in_d.sigma[i], in_d.q[i], in_d.n[i]);
+		});
+	double Reference_ms = get_time_ms() - tstart;
+
+	cout << "HOST-Info: Double reference priced in " << fixed << setprecision(1) << Reference_ms << " ms" << endl << endl;
+
+	vector<string> Engines = {"original", "mixed", "double"};
+	if (find(Engines.begin(), Engines.end(), SW_Engine) == Engines.end()) Engines.push_back(SW_Engine);
+
+	cout << "HOST-Info: " << string(84, '-') << endl;
+	cout << "HOST-Info: " << left << setw(10) << "SW Engine" << " | " << right << setw(11) << "Runtime(ms)"
+	     << " | " << setw(11) << "Max Abs" << " | " << setw(11) << "Max Rel" << " | " << setw(11) << "RMS Abs" << " | " << setw(12) << "#Out of Tol." << endl;
+	cout << "HOST-Info: " << string(84, '-') << endl;
+
+	for (unsigned e=0; e<Engines.size(); e++) {
+		tstart = get_time_ms();
+		K_americanPut_sw_model(host_IN_SOA, sw_RES, Nb_Of_Threads, Engines[e]);
+		double Runtime_ms = get_time_ms() - tstart;
+
+		double Max_Abs = 0, Max_Rel = 0, Sum_Sq = 0;
+		int    Nb_Out_Of_Tolerance = 0;
+
+		for (int i=0; i<NB_OF_TESTS; i++) {
+			double Abs_Err = fabs((double)sw_RES[i] - ref_RES[i]);
+			Max_Abs  = max(Max_Abs, Abs_Err);
+			Sum_Sq  += Abs_Err * Abs_Err;
+			if (fabs(ref_RES[i]) > SW_PRECISION_MIN_VALUE) Max_Rel = max(Max_Rel, Abs_Err / fabs(ref_RES[i]));
+			if (cmp_floats((float)ref_RES[i], sw_RES[i]) == 0) Nb_Out_Of_Tolerance ++;
+		}
+
+		cout << "HOST-Info: " << left << setw(10) << Engines[e] << " | " << right << fixed << setprecision(1) << setw(11) << Runtime_ms
+		     << scientific << setprecision(3) << " | " << setw(11) << Max_Abs << " | " << setw(11) << Max_Rel << " | " << setw(11) << sqrt(Sum_Sq / max(NB_OF_TESTS,1))
+		     << " | " << setw(12) << Nb_Out_Of_Tolerance << endl;
+	}
+	cout << "HOST-Info: " << string(84, '-') << endl << endl;
+	cout << fixed;
+
+	free(sw_RES);
+}
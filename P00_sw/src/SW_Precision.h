@@ -0,0 +1,82 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#ifndef __SW_PRECISION_H__
+#define __SW_PRECISION_H__
+
+#include <cmath>
+#include <vector>
+
+using namespace std;
+
+// ============================================================================
+// SW Model templated on the precision
+//   o) Store_T : type of the p column (the values of the tree nodes)
+//   o) Calc_T  : type of deltaT, up, p0, p1, S*up^k and of the node calculation
+//   Instances (SW engines, see SW.h):
+//   o) <float,  float >  float   (same operations as sw_calc_p0_table)
+//   o) <float,  double>  mixed   (float storage, double accumulation)
+//   o) <double, double>  double
+// The test vectors (t_in_data) stay in float, the result is returned in Calc_T.
+// Any tree height is supported (the p column is kept in heap memory).
+// ============================================================================
+static inline float  prec_exp (float  x)        { return expf(x);    }
+static inline double prec_exp (double x)        { return exp(x);     }
+static inline float  prec_sqrt(float  x)        { return sqrtf(x);   }
+static inline double prec_sqrt(double x)        { return sqrt(x);    }
+static inline float  prec_pow (float  x, int k) { return powf(x,k);  }
+static inline double prec_pow (double x, int k) { return pow(x,k);   }
+
+template <typename Store_T, typename Calc_T>
+Calc_T sw_calc_p0_prec(int T, float S, float K, float r, float sigma, float q, int n) {
+	Calc_T deltaT, up, p0, p1, exercise, value;
+
+	vector<Store_T> p(n);
+	vector<Calc_T>  Su(2*n);                    // Su[k+n] = S * up^k, k = [-n...n-1]
+
+	deltaT = (Calc_T) T / n;
+	up = prec_exp((Calc_T)sigma * prec_sqrt(deltaT));
+
+	p0 = (up*prec_exp(-(Calc_T)q * deltaT) - prec_exp(-(Calc_T)r * deltaT)) / (prec_pow(up,2) - 1); // up^2
+	p1 = prec_exp(-(Calc_T)r * deltaT) - p0;
+
+	// S*up^k table
+	for (int k = -n; k < n; k++) {
+		Su[k+n] = (Calc_T)S * prec_pow(up,k);
+	}
+
+	// initial values at time T
+	for (int i = 0; i < n; i++) {
+		value = (Calc_T)K - Su[2*i]; // S*up^(2*i - n)
+		p[i]  = (value < 0) ? 0 : (Store_T)value;
+	}
+
+	// move to earlier times
+	for (int j = n-1; j > 0; j--) {
+		Calc_T* Su_j = &Su[n-j];  // Su_j[2*i] = S*up^(2*i - j)
+		for (int i = 0; i < j; i++) {
+			value    = p0 * (Calc_T)p[i+1] + p1 * (Calc_T)p[i];   // binomial value
+			exercise = (Calc_T)K - Su_j[2*i];                     // exercise value
+			p[i]     = (Store_T)((value < exercise) ? exercise : value);
+		}
+	}
+
+	return ((Calc_T)p[0]);
+}
+
+#endif
@@ -0,0 +1,440 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <algorithm>
+
+#include "kernel.h"
+#include "help_functions.h"
+#include "SW.h"
+#include "cmath"
+
+// ----------------------------------------------------------------------------
+// AVX2 and AVX-512 paths are only compiled for x86 with GCC/Clang, all other
+// targets use the scalar path
+// ----------------------------------------------------------------------------
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SW_SIMD_X86
+#include <immintrin.h>
+#endif
+
+// Max SIMD width (floats) - used to pad the p and exercise arrays
+#define SIMD_MAX_WIDTH 16
+
+
+// ============================================================================================================ //
+// ------------------------------------------------------------------------------------------------------------ //
+//                                         SW MODEL - SIMD Implementation
+// ------------------------------------------------------------------------------------------------------------ //
+// ============================================================================================================ //
+// In the backward induction, the new p[i] depends only on the old p[i] and p[i+1]. When the row is processed
+// from i=0 upwards in blocks of W elements, p[i+W] is loaded before it is overwritten, therefore each block is
+// calculated with W-wide vector operations.
+//
+// The exercise value of the node (i,j) is K - S*up^(2*i - j). For the given row j, exponents have the same
+// parity as j, therefore two exercise tables are precomputed:
+//    Ex_Even[m] = K - S*up^(2*m - n)       used when (n-j) is even: Ex_Even[i + (n-j)/2]
+//    Ex_Odd[m]  = K - S*up^(2*m - n + 1)   used when (n-j) is odd:  Ex_Odd [i + (n-j-1)/2]
+// and a row reads them with contiguous (vector) loads.
+//
+// Values calculated beyond p[j-1] by the last block of the row are never read again.
+// ============================================================================================================ //
+
+typedef struct {
+	float  p0, p1;
+	float* p;          // [n + SIMD_MAX_WIDTH]
+	float* Ex_Even;    // [n + SIMD_MAX_WIDTH]
+	float* Ex_Odd;     // [n + SIMD_MAX_WIDTH]
+} t_simd_tree;
+
+static void sw_simd_init_tree(t_simd_tree* tree, int T, float S, float K, float r, float sigma, float q, int n) {
+	float deltaT, up;
+
+	deltaT = (float) T / n;
+	up = expf(sigma * sqrtf(deltaT));
+
+	tree->p0 = (up*expf(-q * deltaT) - expf(-r * deltaT)) / (powf(up,2) - 1); // up^2
+	tree->p1 = expf(-r * deltaT) - tree->p0;
+
+	for (int m = 0; m < n; m++) {
+		tree->Ex_Even[m] = K - S * powf(up,(2*m - n));
+		tree->Ex_Odd[m]  = K - S * powf(up,(2*m - n + 1));
+	}
+
+	// initial values at time T
+	for (int i = 0; i < n; i++) {
+		tree->p[i] = tree->Ex_Even[i];
+		if (tree->p[i] < 0) tree->p[i] = 0;
+	}
+
+	// padding read by the last block of a row
+	for (int i = n; i < n + SIMD_MAX_WIDTH; i++) {
+		tree->p[i] = 0; tree->Ex_Even[i] = 0; tree->Ex_Odd[i] = 0;
+	}
+}
+
+static inline const float* sw_simd_row_exercise(t_simd_tree* tree, int n, int j) {
+	if (((n-j) & 1) == 0) return &tree->Ex_Even[(n-j)/2];
+	else                  return &tree->Ex_Odd[(n-j-1)/2];
+}
+
+
+// --------------------------------------
+// Scalar
+// --------------------------------------
+static void sw_simd_sweep_scalar(t_simd_tree* tree, int n) {
+	float  p0 = tree->p0, p1 = tree->p1;
+	float* p  = tree->p;
+
+	for (int j = n-1; j > 0; j--) {
+		const float* ex = sw_simd_row_exercise(tree, n, j);
+		for (int i = 0; i < j; i++) {
+			float v = p0 * p[i+1] + p1 * p[i];
+			p[i] = (ex[i] > v) ? ex[i] : v;
+		}
+	}
+}
+
+#ifdef SW_SIMD_X86
+// --------------------------------------
+// AVX2 (8 floats)
+// --------------------------------------
+__attribute__((target("avx2,fma")))
+static void sw_simd_sweep_avx2(t_simd_tree* tree, int n) {
+	__m256 p0 = _mm256_set1_ps(tree->p0);
+	__m256 p1 = _mm256_set1_ps(tree->p1);
+	float* p  = tree->p;
+
+	for (int j = n-1; j > 0; j--) {
+		const float* ex = sw_simd_row_exercise(tree, n, j);
+		for (int i = 0; i < j; i += 8) {
+			__m256 p_i  = _mm256_load_ps (&p[i]);
+			__m256 p_i1 = _mm256_loadu_ps(&p[i+1]);
+			__m256 e    = _mm256_loadu_ps(&ex[i]);
+			__m256 v    = _mm256_fmadd_ps(p0, p_i1, _mm256_mul_ps(p1, p_i));
+			_mm256_store_ps(&p[i], _mm256_max_ps(e, v));  // (e > v) ? e : v
+		}
+	}
+}
+
+// --------------------------------------
+// AVX-512 (16 floats)
+// --------------------------------------
+__attribute__((target("avx512f")))
+static void sw_simd_sweep_avx512(t_simd_tree* tree, int n) {
+	__m512 p0 = _mm512_set1_ps(tree->p0);
+	__m512 p1 = _mm512_set1_ps(tree->p1);
+	float* p  = tree->p;
+
+	for (int j = n-1; j > 0; j--) {
+		const float* ex = sw_simd_row_exercise(tree, n, j);
+		for (int i = 0; i < j; i += 16) {
+			__m512 p_i  = _mm512_load_ps (&p[i]);
+			__m512 p_i1 = _mm512_loadu_ps(&p[i+1]);
+			__m512 e    = _mm512_loadu_ps(&ex[i]);
+			__m512 v    = _mm512_fmadd_ps(p0, p_i1, _mm512_mul_ps(p1, p_i));
+			_mm512_store_ps(&p[i], _mm512_mask_max_ps(e, 0xFFFF, e, v));  // (e > v) ? e : v (passthrough e: _mm512_max_ps reads an undefined vector)
+		}
+	}
+}
+#endif
+
+
+// ============================================================================================================ //
+// ISA Dispatch
+//   The best ISA supported by the CPU is selected at runtime.
+//   The BINOMIAL_SIMD_ISA environment variable (scalar, avx2, avx512) can be used to limit the selection.
+// ============================================================================================================ //
+typedef void (*t_sw_simd_sweep)(t_simd_tree* tree, int n);
+
+typedef struct {
+	string          isa_name;
+	t_sw_simd_sweep sweep;
+} t_sw_simd_isa;
+
+static t_sw_simd_isa sw_simd_select_isa() {
+	t_sw_simd_isa isa = {"scalar", sw_simd_sweep_scalar};
+
+	char* max_isa = getenv("BINOMIAL_SIMD_ISA");
+	if ((max_isa != NULL) && (strcmp(max_isa,"scalar") != 0) && (strcmp(max_isa,"avx2") != 0) && (strcmp(max_isa,"avx512") != 0)) {
+		cout << endl << "HOST-Error: BINOMIAL_SIMD_ISA option does not support the following value: " << max_isa << endl;
+		cout <<         "            Supported values are: scalar, avx2, avx512" << endl << endl;
+		exit(1);
+	}
+
+	#ifdef SW_SIMD_X86
+	bool allow_avx2   = (max_isa == NULL) || (strcmp(max_isa,"avx2") == 0) || (strcmp(max_isa,"avx512") == 0);
+	bool allow_avx512 = (max_isa == NULL) || (strcmp(max_isa,"avx512") == 0);
+
+	__builtin_cpu_init();
+	if (allow_avx2 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+		isa.isa_name = "avx2";   isa.sweep = sw_simd_sweep_avx2;
+	}
+	if (allow_avx512 && __builtin_cpu_supports("avx512f")) {
+		isa.isa_name = "avx512"; isa.sweep = sw_simd_sweep_avx512;
+	}
+	#endif
+
+	return isa;
+}
+
+static const t_sw_simd_isa& sw_simd_isa() {
+	static const t_sw_simd_isa isa = sw_simd_select_isa();
+	return isa;
+}
+
+string sw_simd_isa_name() {
+	return sw_simd_isa().isa_name;
+}
+
+
+// ============================================================================================================ //
+// SIMD SW Engine
+// ============================================================================================================ //
+float sw_calc_p0_simd(int T, float S, float K, float r, float sigma, float q, int n) {
+	//    T... expiration time
+	//    S... stock price
+	//    K... strike price
+	//    q... dividend yield
+	//    n... height of the binomial tree
+
+	alignas(64) float p      [CONST_MAX_TREE_HEIGHT + SIMD_MAX_WIDTH];
+	alignas(64) float Ex_Even[CONST_MAX_TREE_HEIGHT + SIMD_MAX_WIDTH];
+	alignas(64) float Ex_Odd [CONST_MAX_TREE_HEIGHT + SIMD_MAX_WIDTH];
+
+	if (n > CONST_MAX_TREE_HEIGHT) return sw_calc_p0_tiled(T, S, K, r, sigma, q, n);
+
+	t_simd_tree tree;
+	tree.p = p; tree.Ex_Even = Ex_Even; tree.Ex_Odd = Ex_Odd;
+
+	sw_simd_init_tree(&tree, T, S, K, r, sigma, q, n);
+	sw_simd_isa().sweep(&tree, n);
+
+	return (p[0]);
+}
+
+
+// ============================================================================================================ //
+// ------------------------------------------------------------------------------------------------------------ //
+//                                  SW MODEL - Cross-Option SIMD Batching
+// ------------------------------------------------------------------------------------------------------------ //
+// ============================================================================================================ //
+// Options with the same T, r, sigma, q and n share deltaT, up, p0 and p1, so their trees have the same shape and
+// the same up^k values. Such options are priced together: each SIMD lane holds the tree of one option
+// (p[i*W + lane]) and the backward sweep over j and i is executed once for the whole group.
+// Only S and K differ between the lanes:
+//    exercise[lane] = K[lane] - S[lane] * up^(2*i - j)
+// where up^k is read from a table shared by all lanes (U[k+n] = up^k).
+//
+// sw_batch_plan() splits the groups of sw_tree_group_plan() (see SW_Shared.cpp) in work items of W options
+// (W = SIMD width of the selected ISA).
+// Options that cannot fill a complete group are priced individually by sw_calc_p0_simd.
+// Trees taller than CONST_MAX_TREE_HEIGHT are not batched (sw_calc_p0_simd prices them with sw_calc_p0_tiled).
+// ============================================================================================================ //
+
+typedef struct {
+	float  p0, p1;
+	float* p;          // [n * W]
+	float* U;          // [2 * n]
+	float* S;          // [W]
+	float* K;          // [W]
+} t_batch_tree;
+
+static void sw_batch_init_tree(t_batch_tree* tree, t_in_data_soa* host_IN_SOA, t_sw_work_item* Item, int W) {
+	int   indx0 = Item->Index[0];           // all lanes share T, r, sigma, q, n
+	int   n     = host_IN_SOA->n[indx0];
+
+	sw_tree_params_calc(host_IN_SOA, indx0, &tree->p0, &tree->p1, tree->U);
+
+	// Options of a group are usually consecutive in host_IN_SOA: S and K are then copied with plain (vector) loads
+	bool consecutive = true;
+	for (int lane = 1; lane < W; lane++)
+		if (Item->Index[lane] != indx0 + lane) consecutive = false;
+
+	if (consecutive) {
+		memcpy(tree->S, &host_IN_SOA->S[indx0], W * sizeof(float));
+		memcpy(tree->K, &host_IN_SOA->K[indx0], W * sizeof(float));
+	} else {
+		for (int lane = 0; lane < W; lane++) {
+			tree->S[lane] = host_IN_SOA->S[Item->Index[lane]];
+			tree->K[lane] = host_IN_SOA->K[Item->Index[lane]];
+		}
+	}
+
+	// initial values at time T
+	for (int i = 0; i < n; i++) {
+		for (int lane = 0; lane < W; lane++) {
+			float p_i = tree->K[lane] - tree->S[lane] * tree->U[2*i]; // up^(2*i - n)
+			tree->p[i*W + lane] = (p_i < 0) ? 0 : p_i;
+		}
+	}
+}
+
+// --------------------------------------
+// Scalar (any number of options)
+// --------------------------------------
+static void sw_batch_sweep_scalar(t_batch_tree* tree, int n, int W) {
+	float  p0 = tree->p0, p1 = tree->p1;
+	float* p  = tree->p;
+
+	for (int j = n-1; j > 0; j--) {
+		const float* U_j = &tree->U[n-j];  // U_j[2*i] = up^(2*i - j)
+		for (int i = 0; i < j; i++) {
+			for (int lane = 0; lane < W; lane++) {
+				float e = tree->K[lane] - tree->S[lane] * U_j[2*i];
+				float v = p0 * p[(i+1)*W + lane] + p1 * p[i*W + lane];
+				p[i*W + lane] = (e > v) ? e : v;
+			}
+		}
+	}
+}
+
+#ifdef SW_SIMD_X86
+// --------------------------------------
+// AVX2 (8 options)
+// --------------------------------------
+__attribute__((target("avx2,fma")))
+static void sw_batch_sweep_avx2(t_batch_tree* tree, int n) {
+	__m256 p0 = _mm256_set1_ps(tree->p0);
+	__m256 p1 = _mm256_set1_ps(tree->p1);
+	__m256 S  = _mm256_load_ps(tree->S);
+	__m256 K  = _mm256_load_ps(tree->K);
+	float* p  = tree->p;
+
+	for (int j = n-1; j > 0; j--) {
+		const float* U_j = &tree->U[n-j];  // U_j[2*i] = up^(2*i - j)
+		for (int i = 0; i < j; i++) {
+			__m256 p_i  = _mm256_load_ps(&p[i*8]);
+			__m256 p_i1 = _mm256_load_ps(&p[(i+1)*8]);
+			__m256 e    = _mm256_sub_ps(K, _mm256_mul_ps(S, _mm256_set1_ps(U_j[2*i])));
+			__m256 v    = _mm256_fmadd_ps(p0, p_i1, _mm256_mul_ps(p1, p_i));
+			_mm256_store_ps(&p[i*8], _mm256_max_ps(e, v));  // (e > v) ? e : v
+		}
+	}
+}
+
+// --------------------------------------
+// AVX-512 (16 options)
+// --------------------------------------
+__attribute__((target("avx512f")))
+static void sw_batch_sweep_avx512(t_batch_tree* tree, int n) {
+	__m512 p0 = _mm512_set1_ps(tree->p0);
+	__m512 p1 = _mm512_set1_ps(tree->p1);
+	__m512 S  = _mm512_load_ps(tree->S);
+	__m512 K  = _mm512_load_ps(tree->K);
+	float* p  = tree->p;
+
+	for (int j = n-1; j > 0; j--) {
+		const float* U_j = &tree->U[n-j];  // U_j[2*i] = up^(2*i - j)
+		for (int i = 0; i < j; i++) {
+			__m512 p_i  = _mm512_load_ps(&p[i*16]);
+			__m512 p_i1 = _mm512_load_ps(&p[(i+1)*16]);
+			__m512 e    = _mm512_sub_ps(K, _mm512_mul_ps(S, _mm512_set1_ps(U_j[2*i])));
+			__m512 v    = _mm512_fmadd_ps(p0, p_i1, _mm512_mul_ps(p1, p_i));
+			_mm512_store_ps(&p[i*16], _mm512_mask_max_ps(e, 0xFFFF, e, v));  // (e > v) ? e : v (passthrough e: _mm512_max_ps reads an undefined vector)
+		}
+	}
+}
+#endif
+
+// ============================================================================================================ //
+// Number of options priced together (1 - batching is not supported by the selected ISA)
+// ============================================================================================================ //
+int sw_batch_nb_of_lanes() {
+	if (sw_simd_isa().isa_name == "avx512") return 16;
+	if (sw_simd_isa().isa_name == "avx2")   return 8;
+	return 1;
+}
+
+// ============================================================================================================ //
+// Group options sharing T, r, sigma, q and n (sw_tree_group_plan) into work items of Nb_Of_Lanes options
+// ============================================================================================================ //
+vector<t_sw_work_item> sw_batch_plan(t_in_data_soa* host_IN_SOA, int Nb_Of_Lanes) {
+	t_sw_tree_groups       Groups = sw_tree_group_plan(host_IN_SOA);
+	vector<int>&           Order  = Groups.Order;
+	vector<t_sw_work_item> Items;
+
+	for (unsigned g = 0; g + 1 < Groups.Group_Start.size(); g++) {
+		int group_start = Groups.Group_Start[g];
+		int group_end   = Groups.Group_Start[g+1];
+
+		// .......................................
+		// Full groups of Nb_Of_Lanes options
+		// (trees taller than CONST_MAX_TREE_HEIGHT are priced one by one)
+		// .......................................
+		int indx = group_start;
+		if ((Nb_Of_Lanes > 1) && (host_IN_SOA->n[Order[group_start]] <= CONST_MAX_TREE_HEIGHT)) {
+			for (; indx + Nb_Of_Lanes <= group_end; indx += Nb_Of_Lanes) {
+				t_sw_work_item Item;
+				Item.Nb_Of_Options = Nb_Of_Lanes;
+				for (int lane = 0; lane < Nb_Of_Lanes; lane++) Item.Index[lane] = Order[indx + lane];
+				Items.push_back(Item);
+			}
+		}
+
+		// .......................................
+		// Remaining options are priced one by one
+		// .......................................
+		for (; indx < group_end; indx++) {
+			t_sw_work_item Item;
+			Item.Nb_Of_Options = 1;
+			Item.Index[0]      = Order[indx];
+			Items.push_back(Item);
+		}
+	}
+
+	return Items;
+}
+
+// ============================================================================================================ //
+// Batched SW Engine: prices a single work item
+// ============================================================================================================ //
+void sw_calc_p0_batch(t_in_data_soa* host_IN_SOA, float* sw_RES, t_sw_work_item* Item) {
+
+	if (Item->Nb_Of_Options == 1) {
+		int i = Item->Index[0];
+		sw_RES[i] = sw_calc_p0_simd(host_IN_SOA->T[i], host_IN_SOA->S[i], host_IN_SOA->K[i], host_IN_SOA->r[i], host_IN_SOA->sigma[i], host_IN_SOA->q[i], host_IN_SOA->n[i]);
+		return;
+	}
+
+	alignas(64) float p[(CONST_MAX_TREE_HEIGHT + 1) * SW_MAX_LANES];
+	alignas(64) float U[2 * CONST_MAX_TREE_HEIGHT];
+	alignas(64) float S[SW_MAX_LANES];
+	alignas(64) float K[SW_MAX_LANES];
+
+	int W = Item->Nb_Of_Options;
+	int n = host_IN_SOA->n[Item->Index[0]];
+
+	t_batch_tree tree;
+	tree.p = p; tree.U = U; tree.S = S; tree.K = K;
+
+	sw_batch_init_tree(&tree, host_IN_SOA, Item, W);
+
+	#ifdef SW_SIMD_X86
+	if      ((W == 16) && (sw_simd_isa().isa_name == "avx512"))                                       sw_batch_sweep_avx512(&tree, n);
+	else if ((W == 8)  && (sw_simd_isa().isa_name == "avx512" || sw_simd_isa().isa_name == "avx2"))   sw_batch_sweep_avx2  (&tree, n);
+	else
+	#endif
+	sw_batch_sweep_scalar(&tree, n, W);
+
+	for (int lane = 0; lane < W; lane++)
+		sw_RES[Item->Index[lane]] = p[lane];
+}
@@ -0,0 +1,154 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <algorithm>
+
+#include "kernel.h"
+#include "help_functions.h"
+#include "SW.h"
+#include "cmath"
+
+
+// ============================================================================================================ //
+// ------------------------------------------------------------------------------------------------------------ //
+//                                   SW MODEL - Shared Tree Parameters
+// ------------------------------------------------------------------------------------------------------------ //
+// ============================================================================================================ //
+// generate_test_vectors emits runs of options which differ only in K. deltaT, up, p0, p1 and up^k depend only on
+// T, r, sigma, q and n, so sw_tree_group_plan() groups the options by these parameters and sw_tree_params_init()
+// calculates them once per group (sw_batch_plan() and sw_batch_init_tree() use the same planner and parameter
+// routine). Every option is then priced from its S and K only (t_sw_option):
+//    exercise = K - S * U[k+n]      (U[k+n] = up^k)
+// S * U[k+n] is the same float product as S * powf(up,k) in sw_calc_p0_table, so both produce identical results.
+// Trees taller than CONST_MAX_TREE_HEIGHT have no shared parameters and are priced by sw_calc_p0_tiled.
+// The P14 kernels read the same split: t_in_option/t_tree_params records packed by the P14 Host (tree_functions.cpp).
+// ============================================================================================================ //
+
+// ============================================================================================================ //
+// Options are compared by bit pattern, so only exactly equal parameters are grouped.
+// ============================================================================================================ //
+static bool sw_same_tree(t_in_data_soa* in_d, int a, int b) {
+	return (in_d->T[a] == in_d->T[b]) && (in_d->n[a] == in_d->n[b]) &&
+	       (memcmp(&in_d->r[a],     &in_d->r[b],     sizeof(float)) == 0) &&
+	       (memcmp(&in_d->sigma[a], &in_d->sigma[b], sizeof(float)) == 0) &&
+	       (memcmp(&in_d->q[a],     &in_d->q[b],     sizeof(float)) == 0);
+}
+
+static bool sw_tree_less(t_in_data_soa* in_d, int a, int b) {
+	uint32_t a_bits[3], b_bits[3];
+
+	if (in_d->n[a] != in_d->n[b]) return (in_d->n[a] < in_d->n[b]);
+	if (in_d->T[a] != in_d->T[b]) return (in_d->T[a] < in_d->T[b]);
+
+	memcpy(&a_bits[0], &in_d->r[a], sizeof(float)); memcpy(&a_bits[1], &in_d->sigma[a], sizeof(float)); memcpy(&a_bits[2], &in_d->q[a], sizeof(float));
+	memcpy(&b_bits[0], &in_d->r[b], sizeof(float)); memcpy(&b_bits[1], &in_d->sigma[b], sizeof(float)); memcpy(&b_bits[2], &in_d->q[b], sizeof(float));
+	for (int i=0; i<3; i++)
+		if (a_bits[i] != b_bits[i]) return (a_bits[i] < b_bits[i]);
+	return false;
+}
+
+// ============================================================================================================ //
+// Batch planner: sorts the options by tree (stable, options of a group keep their order) and splits them in groups
+// ============================================================================================================ //
+t_sw_tree_groups sw_tree_group_plan(t_in_data_soa* host_IN_SOA) {
+	int              NB_OF_TESTS = host_IN_SOA->Nb_Of_Tests;
+	t_sw_tree_groups Groups;
+
+	Groups.Order.resize(NB_OF_TESTS);
+	Groups.Group.resize(NB_OF_TESTS);
+	for (int i=0; i<NB_OF_TESTS; i++) Groups.Order[i] = i;
+
+	stable_sort(Groups.Order.begin(), Groups.Order.end(), [host_IN_SOA](int a, int b) {
+		return sw_tree_less(host_IN_SOA, a, b);
+	});
+
+	for (int i=0; i<NB_OF_TESTS; i++) {
+		if ((i == 0) || !sw_same_tree(host_IN_SOA, Groups.Order[i-1], Groups.Order[i]))
+			Groups.Group_Start.push_back(i);
+		Groups.Group[i] = Groups.Group_Start.size() - 1;
+	}
+	Groups.Group_Start.push_back(NB_OF_TESTS);
+
+	return Groups;
+}
+
+// ============================================================================================================ //
+// Parameters shared by all options of a group (Index: any option of the group, n <= CONST_MAX_TREE_HEIGHT)
+// Used by the shared and the batch engines: U receives the 2*n entries of the up^k ladder
+// ============================================================================================================ //
+void sw_tree_params_calc(t_in_data_soa* host_IN_SOA, int Index, float* p0, float* p1, float* U) {
+	int   n = host_IN_SOA->n[Index];
+	float deltaT, up;
+
+	deltaT = (float) host_IN_SOA->T[Index] / n;
+	up = expf(host_IN_SOA->sigma[Index] * sqrtf(deltaT));
+
+	*p0 = (up*expf(-host_IN_SOA->q[Index] * deltaT) - expf(-host_IN_SOA->r[Index] * deltaT)) / (powf(up,2) - 1); // up^2
+	*p1 = expf(-host_IN_SOA->r[Index] * deltaT) - *p0;
+
+	// up^k ladder
+	for (int k = -n; k < n; k++) {
+		U[k+n] = powf(up,k);
+	}
+}
+
+void sw_tree_params_init(t_in_data_soa* host_IN_SOA, int Index, t_sw_tree_params* Params) {
+	int n = host_IN_SOA->n[Index];
+
+	Params->n = n;
+	Params->U.clear();
+	if (n > CONST_MAX_TREE_HEIGHT) return;
+
+	Params->U.resize(2*n);
+	sw_tree_params_calc(host_IN_SOA, Index, &Params->p0, &Params->p1, Params->U.data());
+}
+
+// ============================================================================================================ //
+// Shared SW Engine: prices a single option of a group (n <= CONST_MAX_TREE_HEIGHT)
+// ============================================================================================================ //
+float sw_calc_p0_shared(const t_sw_tree_params* Params, float S, float K) {
+	//    S... stock price
+	//    K... strike price
+
+	int          n  = Params->n;
+	float        p0 = Params->p0, p1 = Params->p1, exercise;
+	const float* U  = Params->U.data();
+	float        p[CONST_MAX_TREE_HEIGHT];
+
+	// initial values at time T
+	for (int i = 0; i < n; i++) {
+		p[i] = K - S * U[2*i]; // S*up^(2*i - n)
+		if (p[i] < 0) p[i] = 0;
+	}
+
+	// move to earlier times
+	for (int j = n-1; j > 0; j--) {
+		const float* U_j = &U[n-j];  // U_j[2*i] = up^(2*i - j)
+		for (int i = 0; i < j; i++) {
+			p[i] = p0 * p[i+1] + p1 * p[i];   // binomial value
+			exercise = K - S * U_j[2*i];      // exercise value
+			if (p[i] < exercise) p[i] = exercise;
+		}
+	}
+
+	return (p[0]);
+}
@@ -0,0 +1,114 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#include <stdlib.h>
+#include <iostream>
+
+#include "SW_SoA.h"
+
+using namespace std;
+
+// Number of elements of a field rounded up to a multiple of SW_SOA_ALIGN bytes
+static size_t soa_field_size(int Nb_Of_Tests) {
+	size_t bytes = (size_t) Nb_Of_Tests * sizeof(float);
+	return (bytes + SW_SOA_ALIGN - 1) / SW_SOA_ALIGN * SW_SOA_ALIGN;
+}
+
+// ============================================================================
+// Allocate all 7 fields in a single block
+// ============================================================================
+t_in_data_soa in_data_soa_alloc(int Nb_Of_Tests) {
+	t_in_data_soa Batch;
+	size_t        field_size = soa_field_size(Nb_Of_Tests);
+	char*         ptr;
+
+	if (posix_memalign(&Batch.Mem, SW_SOA_ALIGN, 7 * field_size + SW_SOA_ALIGN)) {
+		cout << endl << "HOST-Error: Out of Memory during memory allocation for SoA test vectors" << endl << endl;
+		exit(1);
+	}
+
+	ptr = (char*) Batch.Mem;
+	Batch.Nb_Of_Tests = Nb_Of_Tests;
+	Batch.T     = (int*)   (ptr + 0*field_size);
+	Batch.S     = (float*) (ptr + 1*field_size);
+	Batch.K     = (float*) (ptr + 2*field_size);
+	Batch.r     = (float*) (ptr + 3*field_size);
+	Batch.sigma = (float*) (ptr + 4*field_size);
+	Batch.q     = (float*) (ptr + 5*field_size);
+	Batch.n     = (int*)   (ptr + 6*field_size);
+
+	return Batch;
+}
+
+void in_data_soa_free(t_in_data_soa* Batch) {
+	if (Batch->Mem != NULL) free(Batch->Mem);
+	Batch->Mem         = NULL;
+	Batch->Nb_Of_Tests = 0;
+}
+
+// ============================================================================
+// View of tests [Start_Index ... Start_Index+Nb_Of_Tests-1] (no copy)
+// ============================================================================
+t_in_data_soa in_data_soa_view(t_in_data_soa Batch, int Start_Index, int Nb_Of_Tests) {
+	t_in_data_soa View;
+
+	if ((Start_Index < 0) || (Nb_Of_Tests < 0) || (Start_Index + Nb_Of_Tests > Batch.Nb_Of_Tests)) {
+		cout << endl << "HOST-Error: SoA view [" << Start_Index << " ... " << Start_Index + Nb_Of_Tests - 1 << "] is out of range (Nb_Of_Tests = " << Batch.Nb_Of_Tests << ")" << endl << endl;
+		exit(1);
+	}
+
+	View.Nb_Of_Tests = Nb_Of_Tests;
+	View.T     = Batch.T     + Start_Index;
+	View.S     = Batch.S     + Start_Index;
+	View.K     = Batch.K     + Start_Index;
+	View.r     = Batch.r     + Start_Index;
+	View.sigma = Batch.sigma + Start_Index;
+	View.q     = Batch.q     + Start_Index;
+	View.n     = Batch.n     + Start_Index;
+	View.Mem   = NULL;
+
+	return View;
+}
+
+// ============================================================================
+// Conversions from/to t_in_data (Batch.Nb_Of_Tests records)
+// ============================================================================
+void in_data_aos_to_soa(const t_in_data* host_IN_DATA, t_in_data_soa Batch) {
+	for (int i = 0; i < Batch.Nb_Of_Tests; i++) {
+		Batch.T[i]     = host_IN_DATA[i].T;
+		Batch.S[i]     = host_IN_DATA[i].S;
+		Batch.K[i]     = host_IN_DATA[i].K;
+		Batch.r[i]     = host_IN_DATA[i].r;
+		Batch.sigma[i] = host_IN_DATA[i].sigma;
+		Batch.q[i]     = host_IN_DATA[i].q;
+		Batch.n[i]     = host_IN_DATA[i].n;
+	}
+}
+
+void in_data_soa_to_aos(t_in_data_soa Batch, t_in_data* host_IN_DATA) {
+	for (int i = 0; i < Batch.Nb_Of_Tests; i++) {
+		host_IN_DATA[i].T         = Batch.T[i];
+		host_IN_DATA[i].S         = Batch.S[i];
+		host_IN_DATA[i].K         = Batch.K[i];
+		host_IN_DATA[i].r         = Batch.r[i];
+		host_IN_DATA[i].sigma     = Batch.sigma[i];
+		host_IN_DATA[i].q         = Batch.q[i];
+		host_IN_DATA[i].n         = Batch.n[i];
+		host_IN_DATA[i].dummy_val = 0.0f;
+	}
+}
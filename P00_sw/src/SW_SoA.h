@@ -0,0 +1,48 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#ifndef __SW_SOA_H__
+#define __SW_SOA_H__
+
+#include "kernel.h"
+
+// ============================================================================
+// Structure of Arrays (SoA) representation of the test vectors
+//   o) One array per t_in_data field, each aligned to SW_SOA_ALIGN bytes,
+//      so that consecutive options can be read with vector loads
+//   o) A view (in_data_soa_view) refers to a sub-range of a batch and
+//      does not own any memory
+// ============================================================================
+#define SW_SOA_ALIGN 64
+
+typedef struct {
+	int    Nb_Of_Tests;
+	int   *T;
+	float *S, *K, *r, *sigma, *q;
+	int   *n;
+	void  *Mem;                       // Owned memory (NULL for a view)
+} t_in_data_soa;
+
+t_in_data_soa in_data_soa_alloc(int Nb_Of_Tests);
+void          in_data_soa_free (t_in_data_soa* Batch);
+t_in_data_soa in_data_soa_view (t_in_data_soa Batch, int Start_Index, int Nb_Of_Tests);
+
+void in_data_aos_to_soa(const t_in_data* host_IN_DATA, t_in_data_soa Batch);
+void in_data_soa_to_aos(t_in_data_soa Batch, t_in_data* host_IN_DATA);
+
+#endif
@@ -0,0 +1,89 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#include <thread>
+#include <fstream>
+
+#include "kernel.h"
+#include "help_functions.h"
+#include "SW.h"
+#include "SW_SoA.h"
+#include "SW_Stream.h"
+
+typedef struct {
+	int           Start_Index;           // Global index of the first test in the chunk
+	int           Nb_Of_Tests;
+	t_in_data*    IN_DATA;               // Generated test vectors (used to store the results)
+	t_in_data_soa IN_SOA;                // Test vectors priced by the SW model
+	float*        RES;
+} t_sw_chunk_buf;
+
+void K_americanPut_sw_stream(vector<test_config_t>* Test_Config, int NB_OF_TESTS, int Chunk_Size, int Nb_Of_Threads, string SW_Engine, string Out_File_Name) {
+	t_sw_chunk_buf Buf[2];
+	thread         Pricing;
+	t_results_file out_file;
+	int            Nb_Of_Chunks = (NB_OF_TESTS + Chunk_Size - 1) / Chunk_Size;
+
+	for (int b=0; b<2; b++) {
+		Buf[b].IN_DATA = allocate_host_mem<t_in_data>(Chunk_Size,"Chunk["+to_string(b)+"].IN_DATA",true);
+		Buf[b].IN_SOA  = in_data_soa_alloc(Chunk_Size);
+		Buf[b].RES     = allocate_host_mem<float>(Chunk_Size,"Chunk["+to_string(b)+"].RES",true);
+	}
+
+	cout << "HOST-Info: Streaming " << NB_OF_TESTS << " tests in " << Nb_Of_Chunks << " chunks of up to " << Chunk_Size << " tests ..." << endl;
+
+	open_results_file("sw", Out_File_Name, &out_file);
+
+	for (int c=0; c<=Nb_Of_Chunks; c++) {
+		t_sw_chunk_buf* Cur  = &Buf[c%2];
+		t_sw_chunk_buf* Prev = &Buf[(c+1)%2];
+
+		// ---------------------------------------------------------
+		// Generate chunk c (while chunk c-1 is priced)
+		// ---------------------------------------------------------
+		if (c < Nb_Of_Chunks) {
+			Cur->Start_Index = c * Chunk_Size;
+			Cur->Nb_Of_Tests = min(Chunk_Size, NB_OF_TESTS - Cur->Start_Index);
+
+			generate_test_vectors(Cur->IN_DATA, Test_Config, Cur->Start_Index, Cur->Nb_Of_Tests);
+			Cur->IN_SOA.Nb_Of_Tests = Cur->Nb_Of_Tests;
+			in_data_aos_to_soa(Cur->IN_DATA, Cur->IN_SOA);
+		}
+
+		if (Pricing.joinable()) Pricing.join();
+
+		// ---------------------------------------------------------
+		// Price chunk c and store the results of chunk c-1
+		// ---------------------------------------------------------
+		if (c < Nb_Of_Chunks)
+			Pricing = thread([Cur, Nb_Of_Threads, SW_Engine]() {
+				K_americanPut_sw_model(&Cur->IN_SOA, Cur->RES, Nb_Of_Threads, SW_Engine);
+			});
+
+		if (c > 0)
+			store_results_chunk(&out_file, Prev->IN_DATA, Prev->RES, Test_Config, Prev->Start_Index, Prev->Nb_Of_Tests);
+	}
+
+	close_results_file(&out_file);
+
+	for (int b=0; b<2; b++) {
+		free(Buf[b].IN_DATA);
+		in_data_soa_free(&Buf[b].IN_SOA);
+		free(Buf[b].RES);
+	}
+}
@@ -0,0 +1,39 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#ifndef __SW_STREAM_H__
+#define __SW_STREAM_H__
+
+#include <string>
+#include <vector>
+
+#include "help_functions.h"
+
+using namespace std;
+
+// ============================================================================
+// Streaming SW model
+//   Prices the NB_OF_TESTS tests defined in Test_Config in chunks of
+//   Chunk_Size tests and appends the results to Out_File_Name.
+//   Host memory does not depend on NB_OF_TESTS: two chunks are in flight,
+//   while one chunk is priced the next one is generated and the results
+//   of the previous one are stored.
+// ============================================================================
+void K_americanPut_sw_stream(vector<test_config_t>* Test_Config, int NB_OF_TESTS, int Chunk_Size, int Nb_Of_Threads, string SW_Engine, string Out_File_Name);
+
+#endif
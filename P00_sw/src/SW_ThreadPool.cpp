@@ -0,0 +1,197 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#include <stdlib.h>
+
+#include "SW_ThreadPool.h"
+#include "time_functions.h"
+
+// Target number of chunks per thread. More chunks improve balancing, fewer chunks reduce scheduling overhead.
+#define CHUNKS_PER_THREAD 8
+
+// ============================================================================
+// Create the threads. They wait for work in worker()
+// ============================================================================
+SW_ThreadPool::SW_ThreadPool(int Nb_Of_Threads) :
+		Nb_Of_Chunks(0), Nb_Of_Steals(0), Nb_Of_Threads(Nb_Of_Threads),
+		Queues(Nb_Of_Threads), Queue_Mutex(new mutex[Nb_Of_Threads]),
+		Job_Id(0), Nb_Of_Active_Threads(0), Stop(false), Body(NULL), Job_Start_Time(0) {
+
+	Thread_Finish_Time_ms.resize(Nb_Of_Threads, 0);
+	Thread_Nb_Of_Chunks.resize(Nb_Of_Threads, 0);
+
+	for (int i=0; i<Nb_Of_Threads; i++)
+		Threads.push_back(thread(&SW_ThreadPool::worker, this, i));
+}
+
+SW_ThreadPool::~SW_ThreadPool() {
+	{
+		lock_guard<mutex> lock(State_Mutex);
+		Stop = true;
+	}
+	Start_CV.notify_all();
+
+	for (unsigned i=0; i<Threads.size(); i++)
+		Threads[i].join();
+}
+
+// ============================================================================
+// Get the next chunk for Thread_Id
+//   o) from the front of its own queue or
+//   o) from the back of another thread's queue (steal)
+// Returns false when all queues are empty
+// ============================================================================
+bool SW_ThreadPool::next_chunk(int Thread_Id, t_sw_chunk* Chunk) {
+	{
+		lock_guard<mutex> lock(Queue_Mutex[Thread_Id]);
+		if (!Queues[Thread_Id].empty()) {
+			*Chunk = Queues[Thread_Id].front();
+			Queues[Thread_Id].pop_front();
+			return true;
+		}
+	}
+
+	for (int i=1; i<Nb_Of_Threads; i++) {
+		int Victim_Id = (Thread_Id + i) % Nb_Of_Threads;
+		lock_guard<mutex> lock(Queue_Mutex[Victim_Id]);
+		if (!Queues[Victim_Id].empty()) {
+			*Chunk = Queues[Victim_Id].back();
+			Queues[Victim_Id].pop_back();
+
+			lock_guard<mutex> steal_lock(Steal_Mutex);
+			Nb_Of_Steals++;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// ============================================================================
+// Worker Thread
+// ============================================================================
+void SW_ThreadPool::worker(int Thread_Id) {
+	unsigned long Last_Job_Id = 0;
+
+	while (true) {
+		{
+			unique_lock<mutex> lock(State_Mutex);
+			Start_CV.wait(lock, [&] { return Stop || (Job_Id != Last_Job_Id); });
+			if (Stop) return;
+			Last_Job_Id = Job_Id;
+		}
+
+		t_sw_chunk Chunk;
+		int Nb_Of_Processed_Chunks = 0;
+		while (next_chunk(Thread_Id, &Chunk)) {
+			(*Body)(Chunk.Begin, Chunk.End);
+			Nb_Of_Processed_Chunks++;
+		}
+
+		Thread_Finish_Time_ms[Thread_Id] = get_time_ms() - Job_Start_Time;
+		Thread_Nb_Of_Chunks[Thread_Id]   = Nb_Of_Processed_Chunks;
+
+		{
+			lock_guard<mutex> lock(State_Mutex);
+			Nb_Of_Active_Threads--;
+			if (Nb_Of_Active_Threads == 0) Done_CV.notify_all();
+		}
+	}
+}
+
+// ============================================================================
+// Parallel For
+// ============================================================================
+void SW_ThreadPool::parallel_for(int Nb_Of_Items, const function<double(int)>& Item_Cost, const function<void(int,int)>& Body) {
+	lock_guard<mutex> job_lock(Job_Mutex);
+
+	Job_Start_Time = get_time_ms();
+	Nb_Of_Chunks   = 0;
+	Nb_Of_Steals   = 0;
+
+	if (Nb_Of_Items <= 0) {
+		for (int i=0; i<Nb_Of_Threads; i++) { Thread_Finish_Time_ms[i] = 0; Thread_Nb_Of_Chunks[i] = 0; }
+		return;
+	}
+
+	// ---------------------------------------------------------
+	// Cost-aware chunking: consecutive items are grouped until
+	// the chunk reaches Target_Chunk_Cost
+	// ---------------------------------------------------------
+	vector<t_sw_chunk> Chunks;
+	double Total_Cost = 0;
+
+	for (int i=0; i<Nb_Of_Items; i++) Total_Cost += Item_Cost(i);
+
+	double Target_Chunk_Cost = Total_Cost / (Nb_Of_Threads * CHUNKS_PER_THREAD);
+	t_sw_chunk Chunk = {0, 0, 0};
+
+	for (int i=0; i<Nb_Of_Items; i++) {
+		Chunk.Cost += Item_Cost(i);
+		Chunk.End   = i+1;
+		if ((Chunk.Cost >= Target_Chunk_Cost) || (i == Nb_Of_Items-1)) {
+			Chunks.push_back(Chunk);
+			Chunk.Begin = i+1; Chunk.Cost = 0;
+		}
+	}
+	Nb_Of_Chunks = Chunks.size();
+
+	// ---------------------------------------------------------
+	// Initial distribution: contiguous blocks of chunks with
+	// ~Total_Cost/Nb_Of_Threads cost per thread
+	// ---------------------------------------------------------
+	double Assigned_Cost = 0;
+	int    Thread_Id     = 0;
+
+	for (unsigned i=0; i<Chunks.size(); i++) {
+		while ((Thread_Id < Nb_Of_Threads-1) && (Assigned_Cost >= Total_Cost * (Thread_Id+1) / Nb_Of_Threads))
+			Thread_Id++;
+
+		lock_guard<mutex> lock(Queue_Mutex[Thread_Id]);
+		Queues[Thread_Id].push_back(Chunks[i]);
+		Assigned_Cost += Chunks[i].Cost;
+	}
+
+	// ---------------------------------------------------------
+	// Start all threads and wait until all chunks are processed
+	// ---------------------------------------------------------
+	unique_lock<mutex> lock(State_Mutex);
+	this->Body           = &Body;
+	Nb_Of_Active_Threads = Nb_Of_Threads;
+	Job_Id++;
+	Start_CV.notify_all();
+
+	Done_CV.wait(lock, [&] { return Nb_Of_Active_Threads == 0; });
+	this->Body = NULL;
+}
+
+
+// ============================================================================
+// Persistent pool
+// ============================================================================
+static mutex                     SW_Thread_Pool_Mutex;
+static shared_ptr<SW_ThreadPool> SW_Thread_Pool;
+
+shared_ptr<SW_ThreadPool> sw_thread_pool(int Nb_Of_Threads) {
+	lock_guard<mutex> lock(SW_Thread_Pool_Mutex);
+
+	if ((SW_Thread_Pool == nullptr) || (SW_Thread_Pool->nb_of_threads() != Nb_Of_Threads))
+		SW_Thread_Pool = make_shared<SW_ThreadPool>(Nb_Of_Threads);
+
+	return SW_Thread_Pool;
+}
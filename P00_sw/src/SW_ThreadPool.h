@@ -0,0 +1,90 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#ifndef __SW_THREADPOOL_H__
+#define __SW_THREADPOOL_H__
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+
+using namespace std;
+
+// ============================================================================
+// Work-stealing Thread Pool
+//   o) Threads are created once and reused by all parallel_for calls
+//   o) Items are grouped in chunks of similar cost (Item_Cost), so that
+//      expensive items are processed alone and cheap items are grouped
+//   o) Each thread starts with a contiguous block of chunks of ~equal cost
+//      and steals chunks from other threads once its own queue is empty
+// ============================================================================
+typedef struct {
+	int    Begin, End;                    // Items [Begin ... End-1]
+	double Cost;
+} t_sw_chunk;
+
+class SW_ThreadPool {
+public:
+	SW_ThreadPool(int Nb_Of_Threads);
+	~SW_ThreadPool();
+
+	int  nb_of_threads() const { return Nb_Of_Threads; }
+
+	// Calls Body(Begin, End) for all items [0 ... Nb_Of_Items-1] and returns when all items are processed
+	void parallel_for(int Nb_Of_Items, const function<double(int)>& Item_Cost, const function<void(int,int)>& Body);
+
+	// ---------------------------------------
+	// Statistics of the last parallel_for call
+	// ---------------------------------------
+	vector<double> Thread_Finish_Time_ms;   // Time when each thread ran out of work (relative to the call start)
+	vector<int>    Thread_Nb_Of_Chunks;     // Number of chunks processed by each thread
+	int            Nb_Of_Chunks;
+	int            Nb_Of_Steals;
+
+private:
+	void worker(int Thread_Id);
+	bool next_chunk(int Thread_Id, t_sw_chunk* Chunk);
+
+	int                           Nb_Of_Threads;
+	vector<thread>                Threads;
+
+	vector<deque<t_sw_chunk>>     Queues;          // One queue of chunks per thread
+	unique_ptr<mutex[]>           Queue_Mutex;
+
+	mutex                         Job_Mutex;       // Only one parallel_for call is processed at a time
+	mutex                         State_Mutex;
+	condition_variable            Start_CV;
+	condition_variable            Done_CV;
+	unsigned long                 Job_Id;
+	int                           Nb_Of_Active_Threads;
+	bool                          Stop;
+
+	const function<void(int,int)>* Body;
+	double                        Job_Start_Time;
+	mutex                         Steal_Mutex;
+};
+
+// Persistent pool shared by all SW model calls (replaced only if Nb_Of_Threads changes). The handle keeps its pool
+// alive: a caller holding the previous pool can still use it after another caller requested a different size.
+shared_ptr<SW_ThreadPool> sw_thread_pool(int Nb_Of_Threads);
+
+#endif
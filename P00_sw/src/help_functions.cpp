@@ -23,12 +23,113 @@
 #include <vector>
 #include <cmath>
 #include <cstring>
-#include <regex>
+#include <cstdio>
+#include <cerrno>
 #include <typeinfo>
+#include <climits>
+#include <algorithm>
+#include <cstddef>
+#include <fcntl.h>
+#include <unistd.h>
 
 using namespace std;
 
 #include "help_functions.h"
+#include "SW.h"
+
+// ==================================================
+// Config File Tokenizer
+//   The whole file is read into one buffer and parsed
+//   in place: every line is cut at '\n' and at the
+//   comment ('#'), tokens are delimited by spaces/tabs
+//   and terminated with '\0' in the buffer, and numbers
+//   are converted with strtol/strtof. No string is
+//   built per line or per value.
+// ==================================================
+void cfg_read_file(const char* File_Name, vector<char>* Buffer) {
+	FILE* File = fopen(File_Name, "rb");
+	if (File == NULL) {
+	    cout << endl << "HOST-Error: Failed to open the " <<  File_Name << " for read" << endl << endl;
+	    exit(1);
+	}
+
+	fseek(File, 0, SEEK_END);
+	long Size = ftell(File);
+	fseek(File, 0, SEEK_SET);
+
+	Buffer->resize(Size + 1);
+	if ((Size > 0) && (fread(Buffer->data(), 1, Size, File) != (size_t)Size)) {
+	    cout << endl << "HOST-Error: Failed to read the " <<  File_Name << " file" << endl << endl;
+	    exit(1);
+	}
+	(*Buffer)[Size] = '\0';
+	fclose(File);
+}
+
+// Returns the next line ('\0' terminated, NULL at the end of the buffer) and moves *Pos to the following one
+char* cfg_next_line(char** Pos, char* End) {
+	if (*Pos >= End) return NULL;
+
+	char* Line = *Pos;
+	char* Eol  = (char*)memchr(Line, '\n', End - Line);
+	if (Eol == NULL) Eol = End;
+	*Eol = '\0';
+	*Pos = Eol + 1;
+	return Line;
+}
+
+// Splits a line into '\0' terminated tokens (the comment is removed). Returns the number of tokens (at most Max_Tokens)
+int cfg_split_line(char* Line, char** Tokens, int Max_Tokens) {
+	int   Nb_Of_Tokens = 0;
+	char* p            = Line;
+
+	while ((*p != '\0') && (*p != '#')) {
+		while ((*p == ' ') || (*p == '\t') || (*p == '\r')) p++;
+		if ((*p == '\0') || (*p == '#')) break;
+
+		if (Nb_Of_Tokens == Max_Tokens) break;
+		Tokens[Nb_Of_Tokens++] = p;
+
+		while ((*p != '\0') && (*p != '#') && (*p != ' ') && (*p != '\t') && (*p != '\r')) p++;
+		if (*p == '#') { *p = '\0'; break; }
+		if (*p != '\0') *p++ = '\0';
+	}
+	return Nb_Of_Tokens;
+}
+
+// Line as read (tokens separated by a single space), only built for the error messages
+string cfg_line_string(char** Tokens, int Nb_Of_Tokens) {
+	string Line;
+	for (int i=0; i<Nb_Of_Tokens; i++) {
+		if (i > 0) Line += " ";
+		Line += Tokens[i];
+	}
+	return Line;
+}
+
+static void cfg_value_error(const char* File_Name, int Line_Nb, const char* Token, const char* Type) {
+	cout << endl << "HOST-Error: " <<  File_Name << " (line " << Line_Nb << "):  Incorrect value " << Token << endl;
+	cout <<         "            The value should be of type " << Type << endl;
+	exit(1);
+}
+
+int cfg_to_int(const char* Token, const char* File_Name, int Line_Nb) {
+	char* End;
+	errno = 0;
+	long Value = strtol(Token, &End, 10);
+	if ((End == Token) || (*End != '\0') || (errno == ERANGE) || (Value < INT_MIN) || (Value > INT_MAX))
+		cfg_value_error(File_Name, Line_Nb, Token, "int");
+	return (int)Value;
+}
+
+float cfg_to_float(const char* Token, const char* File_Name, int Line_Nb) {
+	char* End;
+	float Value = strtof(Token, &End);
+	if ((End == Token) || (*End != '\0'))
+		cfg_value_error(File_Name, Line_Nb, Token, "float");
+	return Value;
+}
+
 
 // ==================================================
 // Read Test Config File
@@ -36,68 +137,31 @@ using namespace std;
 //   test configuration. If not, then Error and exit
 // ==================================================
 void  read_test_config_file(const char* Test_Config_File_Name, vector<test_config_t> *Test_Config) {
-    fstream Config_File;
-    string	in_line;
+    vector<char> Buffer;
+    char*   Tokens[CFG_MAX_TOKENS_PER_LINE];
+    char*   in_line;
     int     line_nb = 0;
     int     nb_of_read_values;
     int     Nb_Of_Values_To_Read_Per_Line = 10;
     test_config_t Current_Test_Confguration;
 
-    Config_File.open(Test_Config_File_Name,ios::in);
-	if (! Config_File.is_open()) {
-	    cout << endl << "HOST-Error: Failed to open the " <<  Test_Config_File_Name << " for read" << endl << endl;
-	    exit(1);
-	}
+    cfg_read_file(Test_Config_File_Name, &Buffer);
 
-	while (getline (Config_File,in_line)) {
-		line_nb ++;
+	char* Pos = Buffer.data();
+	char* End = Buffer.data() + Buffer.size() - 1;
 
-		// -----------------------------------
-		// If comment exists, then remove it
-		// -----------------------------------
-		int comment_index = in_line.find("#");
-		if (comment_index != -1) {
-			in_line = in_line.substr(0,comment_index);
-		}
+	(*Test_Config).reserve((*Test_Config).size() + count(Pos, End, '\n') + 1);
 
-		// ---------------------------------------------------------------
-		// If a string contains only space characters then read next line
-		// ---------------------------------------------------------------
-		int start_str = in_line.find_first_not_of(" \t");
-		if (start_str == -1) continue;
+	Current_Test_Confguration.File_Name = Test_Config_File_Name;
 
-		// --------------------------------------------------------
-		// Remove all leading, trailing and extra spaces
-		// --------------------------------------------------------
-		in_line = regex_replace(in_line, regex("^ +| +$|( ) +"), "$1");
+	while ((in_line = cfg_next_line(&Pos, End)) != NULL) {
+		line_nb ++;
 
-		// --------------------------------------------------------
-		// Read All values from the line
-		// --------------------------------------------------------
-		stringstream in_str_stream;
-		in_str_stream << in_line;
-
-		Current_Test_Confguration.File_Name = Test_Config_File_Name;
-		Current_Test_Confguration.Line_Nb   = line_nb;
-
-		nb_of_read_values = 0;
-		while (!in_str_stream.eof()) {
-			nb_of_read_values ++;
-			switch (nb_of_read_values) {
-				case  1: in_str_stream >> Current_Test_Confguration.Company_Name; break;
-				case  2: in_str_stream >> Current_Test_Confguration.T;            break;
-				case  3: in_str_stream >> Current_Test_Confguration.S;            break;
-				case  4: in_str_stream >> Current_Test_Confguration.K;            break;
-				case  5: in_str_stream >> Current_Test_Confguration.r;            break;
-				case  6: in_str_stream >> Current_Test_Confguration.sigma;        break;
-				case  7: in_str_stream >> Current_Test_Confguration.q;            break;
-				case  8: in_str_stream >> Current_Test_Confguration.n;            break;
-				case  9: in_str_stream >> Current_Test_Confguration.K_Step;       break;
-				case 10: in_str_stream >> Current_Test_Confguration.NB_OF_TESTS;  break;
-				default: break;
-			}
-			if (nb_of_read_values == Nb_Of_Values_To_Read_Per_Line) break;
-		}
+		// ---------------------------------------------------------------
+		// Split the line (comment removed); skip lines without any value
+		// ---------------------------------------------------------------
+		nb_of_read_values = cfg_split_line(in_line, Tokens, Nb_Of_Values_To_Read_Per_Line);
+		if (nb_of_read_values == 0) continue;
 
 		if (nb_of_read_values != Nb_Of_Values_To_Read_Per_Line) {
 			cout << endl << "HOST-Error: The " <<  Test_Config_File_Name << " file is incomplete." << endl;
@@ -105,11 +169,24 @@ void  read_test_config_file(const char* Test_Config_File_Name, vector<test_confi
 			exit(1);
 		}
 
+		// --------------------------------------------------------
+		// Read All values from the line
+		// --------------------------------------------------------
+		Current_Test_Confguration.Line_Nb      = line_nb;
+		Current_Test_Confguration.Company_Name = Tokens[0];
+		Current_Test_Confguration.T            = cfg_to_int  (Tokens[1], Test_Config_File_Name, line_nb);
+		Current_Test_Confguration.S            = cfg_to_float(Tokens[2], Test_Config_File_Name, line_nb);
+		Current_Test_Confguration.K            = cfg_to_float(Tokens[3], Test_Config_File_Name, line_nb);
+		Current_Test_Confguration.r            = cfg_to_float(Tokens[4], Test_Config_File_Name, line_nb);
+		Current_Test_Confguration.sigma        = cfg_to_float(Tokens[5], Test_Config_File_Name, line_nb);
+		Current_Test_Confguration.q            = cfg_to_float(Tokens[6], Test_Config_File_Name, line_nb);
+		Current_Test_Confguration.n            = cfg_to_int  (Tokens[7], Test_Config_File_Name, line_nb);
+		Current_Test_Confguration.K_Step       = cfg_to_float(Tokens[8], Test_Config_File_Name, line_nb);
+		Current_Test_Confguration.NB_OF_TESTS  = cfg_to_int  (Tokens[9], Test_Config_File_Name, line_nb);
+
 		(*Test_Config).push_back(Current_Test_Confguration);
 	}
 
-	Config_File.close();
-
 	if ((*Test_Config).size() == 0) {
 		cout << endl << "HOST-Error: No Test configurations were found in the " <<  Test_Config_File_Name << " file." << endl;
 		exit(1);
@@ -171,59 +248,42 @@ void print_test_config_info(vector<test_config_t>  *Test_Config) {
 // ==================================================
 
 void  read_sw_hw_config_file(const char* SW_HW_Config_File_Name, sw_hw_config_t* SW_HW_Config) {
-    fstream Config_File;
-    string	in_line;
+    vector<char> Buffer;
+    char*   Tokens[CFG_MAX_TOKENS_PER_LINE];
+    char*   in_line;
     int     line_nb = 0;
     int     nb_of_read_values = 0;
-    int     Nb_Of_Values_To_Read_Per_Line = 4;
+    int     Nb_Of_Values_To_Read_Per_Line = 5;
 
-    Config_File.open(SW_HW_Config_File_Name,ios::in);
-	if (! Config_File.is_open()) {
-	    cout << endl << "HOST-Error: Failed to open the " <<  SW_HW_Config_File_Name << " for read" << endl << endl;
-	    exit(1);
-	}
+    cfg_read_file(SW_HW_Config_File_Name, &Buffer);
 
-	while (getline (Config_File,in_line)) {
-		line_nb ++;
+	char* Pos = Buffer.data();
+	char* End = Buffer.data() + Buffer.size() - 1;
 
-		// -----------------------------------
-		// If comment exists, then remove it
-		// -----------------------------------
-		int comment_index = in_line.find("#");
-		if (comment_index != -1) {
-			in_line = in_line.substr(0,comment_index);
-		}
+	while ((in_line = cfg_next_line(&Pos, End)) != NULL) {
+		line_nb ++;
 
 		// ---------------------------------------------------------------
-		// If a string contains only space characters then read next line
+		// Split the line (comment removed); skip lines without any value
 		// ---------------------------------------------------------------
-		int start_str = in_line.find_first_not_of(" \t");
-		if (start_str == -1) continue;
-
-		// --------------------------------------------------------
-		// Remove all leading, trailing and extra spaces
-		// --------------------------------------------------------
-		in_line = regex_replace(in_line, regex("^ +| +$|( ) +"), "$1");
+		nb_of_read_values = cfg_split_line(in_line, Tokens, Nb_Of_Values_To_Read_Per_Line);
+		if (nb_of_read_values == 0) continue;
 
 		// --------------------------------------------------------
 		// Read All values from the line
 		// --------------------------------------------------------
-		stringstream in_str_stream;
-		in_str_stream << in_line;
-
 		SW_HW_Config->File_Name = SW_HW_Config_File_Name;
 		SW_HW_Config->Line_Nb   = line_nb;
 
-		while (!in_str_stream.eof()) {
-			nb_of_read_values ++;
-			switch (nb_of_read_values) {
-				case  1: in_str_stream >> SW_HW_Config->NB_OF_THREADS;                   break;
-				case  2: in_str_stream >> SW_HW_Config->NB_OF_KERNELS;                   break;
-				case  3: in_str_stream >> SW_HW_Config->NB_OF_CUs_PER_KERNEL;            break;
-				case  4: in_str_stream >> SW_HW_Config->NB_OF_PARALLEL_FUNCTIONS_PER_CU; break;
+		for (int i=0; i<nb_of_read_values; i++) {
+			switch (i+1) {
+				case  1: SW_HW_Config->NB_OF_THREADS                   = cfg_to_int(Tokens[i], SW_HW_Config_File_Name, line_nb); break;
+				case  2: SW_HW_Config->SW_ENGINE                       = Tokens[i];                                              break;
+				case  3: SW_HW_Config->NB_OF_KERNELS                   = cfg_to_int(Tokens[i], SW_HW_Config_File_Name, line_nb); break;
+				case  4: SW_HW_Config->NB_OF_CUs_PER_KERNEL            = cfg_to_int(Tokens[i], SW_HW_Config_File_Name, line_nb); break;
+				case  5: SW_HW_Config->NB_OF_PARALLEL_FUNCTIONS_PER_CU = cfg_to_int(Tokens[i], SW_HW_Config_File_Name, line_nb); break;
 				default: break;
 			}
-			if (nb_of_read_values == Nb_Of_Values_To_Read_Per_Line) break;
 		}
 
 		break;
@@ -237,8 +297,6 @@ void  read_sw_hw_config_file(const char* SW_HW_Config_File_Name, sw_hw_config_t*
 		cout <<         "            Line " << line_nb << " contains " << nb_of_read_values << " values instead of " << Nb_Of_Values_To_Read_Per_Line << endl;
 		exit(1);
 	}
-
-	Config_File.close();
 }
 
 
@@ -252,6 +310,7 @@ void print_sw_hw_config_info(sw_hw_config_t SW_HW_Config) {
 	cout << "HOST-Info: Software Resources"                                                                 << endl;
 	cout << "HOST-Info: ------------------"                                                                 << endl;
     cout << "HOST-Info: NB_OF_THREADS                   = " << SW_HW_Config.NB_OF_THREADS                   << endl;
+    cout << "HOST-Info: SW_ENGINE                       = " << SW_HW_Config.SW_ENGINE                       << endl;
 
 	cout << "HOST-Info: "                                                                                   << endl;
     cout << "HOST-Info: Hardware Resources"                                                                 << endl;
@@ -286,6 +345,15 @@ void process_configurations(string sw_hw, sw_hw_config_t* SW_HW_Config, vector<t
 			exit(1);
 		}
 
+		if (!sw_engine_supported(SW_HW_Config->SW_ENGINE)) {
+			vector<string> names = sw_engine_names();
+			cout << endl << "HOST-Error: " <<  (*SW_HW_Config).File_Name << " (line " << (*SW_HW_Config).Line_Nb << "):  Incorrect value SW_ENGINE=" << SW_HW_Config->SW_ENGINE << endl;
+			cout <<         "            Supported values are:";
+			for (unsigned i=0; i<names.size(); i++) cout << " " << names[i];
+			cout << endl;
+			exit(1);
+		}
+
 	} else { // (sw_hw == "hw")
 
 		if (SW_HW_Config->NB_OF_KERNELS <= 0) {
@@ -325,32 +393,30 @@ void process_configurations(string sw_hw, sw_hw_config_t* SW_HW_Config, vector<t
 		// ..................
 		// Check NB_OF_TESTS
 		// ..................
-		if (((*Test_Config)[i].NB_OF_TESTS <= 0) || ((*Test_Config)[i].NB_OF_TESTS > (*SW_HW_Config).MAX_NB_OF_TESTS)) {
+		if ((*Test_Config)[i].NB_OF_TESTS <= 0) {
 			cout << endl << "HOST-Error: " <<  (*Test_Config)[i].File_Name << " (line " << (*Test_Config)[i].Line_Nb << "):  Incorrect value NB_OF_TESTS=" << (*Test_Config)[i].NB_OF_TESTS << endl;
-			cout <<         "            The value should be in the following range: [1...MAX_NB_OF_TESTS(" << (*SW_HW_Config).MAX_NB_OF_TESTS << ")]" << endl;
+			cout <<         "            The value should be >0" << endl;
+			exit(1);
+		}
+
+		if ((*DEFINED_NB_OF_TESTS) > INT_MAX - (*Test_Config)[i].NB_OF_TESTS) {
+			cout << endl << "HOST-Error: Total number of tests specified in the " << (*Test_Config)[i].File_Name << " file exceeds " << INT_MAX << endl;
 			exit(1);
 		}
 		(*DEFINED_NB_OF_TESTS) += (*Test_Config)[i].NB_OF_TESTS;
 
 	}
 
-	// --------------------------------------------------------
-	// Check DEFINED_NB_OF_TESTS <= MAX_NB_OF_TESTS
-	// --------------------------------------------------------
-	if ((*DEFINED_NB_OF_TESTS) > (*SW_HW_Config).MAX_NB_OF_TESTS) {
-		cout << endl << "HOST-Error: Total number of tests (" << (*DEFINED_NB_OF_TESTS) << ") specified in the " << (*Test_Config)[0].File_Name << " file exceeds MAX_NB_OF_TESTS(" << (*SW_HW_Config).MAX_NB_OF_TESTS << ")" << endl;
-	}
-
 	// -----------------------------------------------------------------------------------------
 	// In our solution we equally distribute calculation across specified
-	//    o) Number of Threads (SW) or
 	//    o) implemented kernels, CUs, Number of parallel functions pur CU
 	// Therefore we need to calculate a final number of tests, stored in ROUNDED_NB_OF_TESTS
+	// The SW thread pool balances any number of tests across the threads (no rounding).
 	// -----------------------------------------------------------------------------------------
 	int BASE;
 
 	if (sw_hw == "sw") {
-		BASE = SW_HW_Config->NB_OF_THREADS;
+		BASE = 1;
 	} else {
 		BASE = (*SW_HW_Config).NB_OF_KERNELS * (*SW_HW_Config).NB_OF_CUs_PER_KERNEL * (*SW_HW_Config).NB_OF_PARALLEL_FUNCTIONS_PER_CU;
 	}
@@ -360,9 +426,12 @@ void process_configurations(string sw_hw, sw_hw_config_t* SW_HW_Config, vector<t
 	else
 		(*ROUNDED_NB_OF_TESTS) = (*DEFINED_NB_OF_TESTS);
 
+	// --------------------------------------------------------
+	// More than MAX_NB_OF_TESTS tests are streamed in chunks
+	// --------------------------------------------------------
 	if ((*ROUNDED_NB_OF_TESTS) > (*SW_HW_Config).MAX_NB_OF_TESTS) {
-		cout << endl << "HOST-Error: Rounded number of tests " << *ROUNDED_NB_OF_TESTS << " exceeds MAX_NB_OF_TESTS(" << (*SW_HW_Config).MAX_NB_OF_TESTS << ")" << endl;
-		exit(1);
+		cout << endl << "HOST-Info: Rounded number of tests " << *ROUNDED_NB_OF_TESTS << " exceeds MAX_NB_OF_TESTS(" << (*SW_HW_Config).MAX_NB_OF_TESTS << ")" << endl;
+		cout <<         "           Tests will be streamed in chunks" << endl;
 	}
 
 }
@@ -374,28 +443,41 @@ void process_configurations(string sw_hw, sw_hw_config_t* SW_HW_Config, vector<t
 // Generate Test Vectors
 // ==============================================
 void generate_test_vectors(t_in_data* host_IN_DATA, vector<test_config_t> Test_Config, int ROUNDED_NB_OF_TESTS) {
-	int indx = 0;
-
 	cout << "HOST-Info: Generating Test Vectors in host_IN_DATA ... " << endl;
 
-	for (unsigned i=0; i<Test_Config.size(); i++ ) {
-		for (int k=0; k<Test_Config[i].NB_OF_TESTS; k++) {
-			host_IN_DATA[indx].T         = Test_Config[i].T;
-			host_IN_DATA[indx].S         = Test_Config[i].S;
-			host_IN_DATA[indx].K         = Test_Config[i].K + Test_Config[i].K_Step*k;
-			host_IN_DATA[indx].r         = Test_Config[i].r;
-			host_IN_DATA[indx].sigma     = Test_Config[i].sigma;
-			host_IN_DATA[indx].q         = Test_Config[i].q;
-			host_IN_DATA[indx].n         = Test_Config[i].n;
+	generate_test_vectors(host_IN_DATA, &Test_Config, 0, ROUNDED_NB_OF_TESTS);
+}
+
+// ----------------------------------------------------------------------------
+// Generate test vectors [Start_Index ... Start_Index+Nb_Of_Tests-1] in
+// host_IN_DATA[0 ... Nb_Of_Tests-1]. Tests beyond the tests defined in
+// Test_Config are dummy tests (required to run the kernels).
+// ----------------------------------------------------------------------------
+void generate_test_vectors(t_in_data* host_IN_DATA, vector<test_config_t>* Test_Config, int Start_Index, int Nb_Of_Tests) {
+	int indx        = 0;
+	int Config_Base = 0;     // Global index of the first test of (*Test_Config)[i]
+
+	for (unsigned i=0; (i<(*Test_Config).size()) && (indx<Nb_Of_Tests); i++ ) {
+		test_config_t* Config = &(*Test_Config)[i];
+
+		for (int k=max(0,Start_Index+indx-Config_Base); (k<Config->NB_OF_TESTS) && (indx<Nb_Of_Tests); k++) {
+			host_IN_DATA[indx].T         = Config->T;
+			host_IN_DATA[indx].S         = Config->S;
+			host_IN_DATA[indx].K         = Config->K + Config->K_Step*k;
+			host_IN_DATA[indx].r         = Config->r;
+			host_IN_DATA[indx].sigma     = Config->sigma;
+			host_IN_DATA[indx].q         = Config->q;
+			host_IN_DATA[indx].n         = Config->n;
 			host_IN_DATA[indx].dummy_val = 0.0f;
 			indx ++;
 		}
+		Config_Base += Config->NB_OF_TESTS;
 	}
 
 	// ----------------------------------------------
 	// Generate additional dummy tests to run kernels
 	// ----------------------------------------------
-	for (int i=indx; i<ROUNDED_NB_OF_TESTS; i++) {
+	for (int i=indx; i<Nb_Of_Tests; i++) {
 		host_IN_DATA[i].T         = 1;
 		host_IN_DATA[i].S         = 1;
 		host_IN_DATA[i].K         = 1;
@@ -403,6 +485,7 @@ void generate_test_vectors(t_in_data* host_IN_DATA, vector<test_config_t> Test_C
 		host_IN_DATA[i].sigma     = 1;
 		host_IN_DATA[i].q         = 1;
 		host_IN_DATA[i].n         = 1; // We specify min Tree height , because the results will be ignored
+		host_IN_DATA[i].dummy_val = 0.0f;
 	}
 
 }
@@ -605,6 +688,7 @@ int compare_results(float* sw_RES, float* hw_RES, int Nb_of_Results, int Nb_Of_E
 #define CMP_ERROR 0.001f
 
 int cmp_floats(float val1, float val2) {
+	if (val1 == val2) return (1);            // Also covers 0.0 (worthless options): no 0/0
 	float cmp_res = abs((val1 - val2)/max(val1,val2));
 	// cout << endl << setprecision (10) << cmp_res << endl;
     if (cmp_res <= CMP_ERROR) return (1);
@@ -613,70 +697,250 @@ int cmp_floats(float val1, float val2) {
 
 
 // ============================================================================
-// Sore results in a File
+// Store results in a File
+//   o) open_results_file  : creates the file and writes the report header
+//   o) store_results_chunk: appends results [Start_Index ... Start_Index+Nb_Of_Results-1]
+//                           host_IN_DATA and hw_RES hold these results only
+//   o) close_results_file : writes the last block and closes the file
+//   Chunks should be stored in order. A company table header is written when
+//   the chunk reaches the first test of a company.
+//
+//   The report is formatted in a RESULTS_BUFFER_SIZE block which is written
+//   with one write() when full (same text as the former setw/setprecision
+//   formatting). With BINOMIAL_RESULTS_FORMAT=bin the file is <name>.bin:
+//   a t_results_header followed by one float per test.
 // ============================================================================
-void store_results(string SW_HW_Mode, string Out_File_Name, t_in_data* host_IN_DATA, float* hw_RES, vector<test_config_t>* Test_Config) {
-	fstream out_file;
-	vector<string> column_names = {"T","S","K","r","sigma","q","n","BOPM_Result"};
+static void results_flush(t_results_file* out_file) {
+	size_t Written = 0;
+
+	while (Written < out_file->Used) {
+		ssize_t Status = write(out_file->fd, out_file->Buffer + Written, out_file->Used - Written);
+		if (Status < 0) {
+			if (errno == EINTR) continue;
+			cout << "HOST_ERROR: Unable to write the " << out_file->File_Name << " file (" << strerror(errno) << ")" << endl << endl;
+			exit(1);
+		}
+		Written += Status;
+	}
+	out_file->Used = 0;
+}
+
+// Room for Size bytes in the block
+static char* results_reserve(t_results_file* out_file, size_t Size) {
+	if (out_file->Used + Size > RESULTS_BUFFER_SIZE) results_flush(out_file);
+	return out_file->Buffer + out_file->Used;
+}
+
+void results_write_str(t_results_file* out_file, const char* Str, size_t Size) {
+	while (Size > 0) {
+		size_t Part = min(Size, (size_t)RESULTS_BUFFER_SIZE);
+		memcpy(results_reserve(out_file, Part), Str, Part);
+		out_file->Used += Part;
+		Str            += Part;
+		Size           -= Part;
+	}
+}
+
+void results_write_str(t_results_file* out_file, string Str) {
+	results_write_str(out_file, Str.data(), Str.size());
+}
+
+static void results_write_padded(t_results_file* out_file, const char* Str, int Len, int Width) {
+	int   Pad = max(0, Width - Len);
+	char* p   = results_reserve(out_file, Pad + Len);
+
+	memset(p, ' ', Pad);
+	memcpy(p + Pad, Str, Len);
+	out_file->Used += Pad + Len;
+}
+
+// Right-aligned in Width characters (setw)
+void results_write_int(t_results_file* out_file, long Value, int Width) {
+	char  Digits[24];
+	char* p        = Digits + sizeof(Digits);
+	unsigned long Abs_Value = (Value < 0) ? 0UL - (unsigned long)Value : (unsigned long)Value;
+
+	do { *--p = '0' + (Abs_Value % 10); Abs_Value /= 10; } while (Abs_Value != 0);
+	if (Value < 0) *--p = '-';
+
+	results_write_padded(out_file, p, Digits + sizeof(Digits) - p, Width);
+}
+
+// Right-aligned in Width characters with Precision decimals (setw, fixed, setprecision)
+//   A float scaled by 10^Precision (Precision <= 6) is exact in a double, so
+//   rounding it to the nearest integer (ties to even) gives the digits printf prints
+void results_write_fixed(t_results_file* out_file, float Value, int Width, int Precision) {
+	static const double Scale[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6};
+	char  Digits[64];
+	char* p;
+	int   Len;
+
+	double Scaled = fabs((double)Value) * Scale[min(max(Precision, 0), 6)];
+
+	if ((Precision < 0) || (Precision > 6) || !(Scaled < 9.0e18)) {
+		// Large values, inf and nan
+		Len = snprintf(Digits, sizeof(Digits), "%.*f", Precision, (double)Value);
+		p   = Digits;
+	} else {
+		unsigned long long Integer = (unsigned long long)nearbyint(Scaled);
+
+		p = Digits + sizeof(Digits);
+		for (int i=0; i<Precision; i++) { *--p = '0' + (Integer % 10); Integer /= 10; }
+		if (Precision > 0) *--p = '.';
+		do { *--p = '0' + (Integer % 10); Integer /= 10; } while (Integer != 0);
+		if (signbit(Value)) *--p = '-';
+		Len = Digits + sizeof(Digits) - p;
+	}
+
+	results_write_padded(out_file, p, Len, Width);
+}
+
+void results_write_bin(t_results_file* out_file, float* RES, int Nb_Of_Results) {
+	results_write_str(out_file, (const char*)RES, Nb_Of_Results * sizeof(float));
+	out_file->Nb_Of_Results += Nb_Of_Results;
+}
+
+void open_results_file(string SW_HW_Mode, string Out_File_Name, t_results_file* out_file) {
 	string Report_Type;
-	unsigned nb_of_columns = column_names.size();
 
 	if (SW_HW_Mode == "sw") Report_Type = "SW Model results";
 	else Report_Type = "HW results";
 
-	out_file.open(Out_File_Name,ios::out);
-    if (!out_file.is_open()) {
-    	cout << "HOST_ERROR: Unable to open a file for write: " << Out_File_Name << endl << endl;
+	const char* Format = getenv("BINOMIAL_RESULTS_FORMAT");
+	if ((Format != NULL) && (strcmp(Format, "table") != 0) && (strcmp(Format, "bin") != 0)) {
+		cout << endl << "HOST-Error: BINOMIAL_RESULTS_FORMAT does not support the following value: " << Format << endl;
+		cout <<         "            Supported values are: table, bin" << endl << endl;
+		exit(1);
+	}
+
+	out_file->Binary        = (Format != NULL) && (strcmp(Format, "bin") == 0);
+	out_file->File_Name     = Out_File_Name;
+	out_file->Nb_Of_Results = 0;
+	out_file->Used          = 0;
+
+	if (out_file->Binary) {
+		size_t Dot = Out_File_Name.rfind('.');
+		out_file->File_Name = ((Dot == string::npos) ? Out_File_Name : Out_File_Name.substr(0, Dot)) + ".bin";
+		cout << "HOST-Info: BINOMIAL_RESULTS_FORMAT=bin: results are written to the " << out_file->File_Name << " file" << endl;
+	}
+
+	out_file->fd = open(out_file->File_Name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out_file->fd < 0) {
+    	cout << "HOST_ERROR: Unable to open a file for write: " << out_file->File_Name << endl << endl;
     	exit(1);
     }
+	out_file->Buffer = allocate_host_mem<char>(RESULTS_BUFFER_SIZE, "the results buffer", false);
+
+	if (out_file->Binary) {
+		// Nb_Of_Results is set by close_results_file
+		t_results_header Header;
+		memset(&Header, 0, sizeof(Header));
+		memcpy(Header.Magic, RESULTS_MAGIC, sizeof(Header.Magic));
+		Header.Record_Size = sizeof(float);
+		results_write_str(out_file, (const char*)&Header, sizeof(Header));
+		return;
+	}
+
+	results_write_str(out_file, "===================================================\n");
+	results_write_str(out_file, " Binomial Options Pricing Model: " + Report_Type + "\n");
+	results_write_str(out_file, "===================================================\n");
+	results_write_str(out_file, "\n");
+}
+
+void close_results_file(t_results_file* out_file) {
+	results_flush(out_file);
 
-    out_file << "===================================================" << endl;
-    out_file << " Binomial Options Pricing Model: " + Report_Type << endl;
-    out_file << "===================================================" << endl;
-    out_file << endl;
-
-    int global_indx = 0;
-    for (unsigned i=0; i<(*Test_Config).size(); i++) {
-    	out_file << fixed << setprecision(3);
-
-    	for(unsigned k=0; k<nb_of_columns*12; k++)
-    		out_file << "-";
-
-    	out_file << endl;
-    	out_file << "Company: " << (*Test_Config)[i].Company_Name;
-    	out_file << " (K_Step=" << (*Test_Config)[i].K_Step;
-    	out_file << " #tests="<< (*Test_Config)[i].NB_OF_TESTS << ")" << endl;
-
-    	// -------------------
-    	// Print Table Header
-    	// -------------------
-    	for(unsigned k=0; k<nb_of_columns*12; k++)
-    		out_file << "-";
-    	out_file << endl;
-    	for(unsigned k=0; k<nb_of_columns;    k++)
-    		out_file << setw(12) << column_names[k]+ " | ";
-    	out_file << endl;
-    	for(unsigned k=0; k<nb_of_columns*12; k++)
-    		out_file << "-";
-    	out_file << endl;
+	if (out_file->Binary) {
+		uint64_t Nb_Of_Results = out_file->Nb_Of_Results;
+		if (pwrite(out_file->fd, &Nb_Of_Results, sizeof(Nb_Of_Results), offsetof(t_results_header, Nb_Of_Results)) != sizeof(Nb_Of_Results)) {
+			cout << "HOST_ERROR: Unable to write the " << out_file->File_Name << " file (" << strerror(errno) << ")" << endl << endl;
+			exit(1);
+		}
+	}
+
+	close(out_file->fd);
+	free(out_file->Buffer);
+	out_file->Buffer = NULL;
+}
+
+// Table header line ("----...") of nb_of_columns*12 characters
+static void results_write_rule(t_results_file* out_file, unsigned nb_of_columns) {
+	char* p = results_reserve(out_file, nb_of_columns*12 + 1);
+	memset(p, '-', nb_of_columns*12);
+	p[nb_of_columns*12] = '\n';
+	out_file->Used += nb_of_columns*12 + 1;
+}
+
+void store_results_chunk(t_results_file* out_file, t_in_data* host_IN_DATA, float* hw_RES, vector<test_config_t>* Test_Config, int Start_Index, int Nb_Of_Results) {
+	vector<string> column_names = {"T","S","K","r","sigma","q","n","BOPM_Result"};
+	unsigned nb_of_columns = column_names.size();
+
+	if (out_file->Binary) {
+		results_write_bin(out_file, hw_RES, Nb_Of_Results);
+		return;
+	}
+
+    int indx        = 0;
+    int Config_Base = 0;     // Global index of the first test of (*Test_Config)[i]
+
+    for (unsigned i=0; (i<(*Test_Config).size()) && (indx<Nb_Of_Results); i++) {
+    	test_config_t* Config = &(*Test_Config)[i];
+    	int k = Start_Index + indx - Config_Base;
+
+    	if (k >= Config->NB_OF_TESTS) {
+    		Config_Base += Config->NB_OF_TESTS;
+    		continue;
+    	}
+
+    	if (k == 0) {
+	    	results_write_rule(out_file, nb_of_columns);
+	    	results_write_str  (out_file, "Company: " + Config->Company_Name + " (K_Step=");
+	    	results_write_fixed(out_file, Config->K_Step, 0, 3);
+	    	results_write_str  (out_file, " #tests=");
+	    	results_write_int  (out_file, Config->NB_OF_TESTS, 0);
+	    	results_write_str  (out_file, ")\n");
+
+	    	// -------------------
+	    	// Print Table Header
+	    	// -------------------
+	    	results_write_rule(out_file, nb_of_columns);
+	    	for(unsigned c=0; c<nb_of_columns;    c++) {
+	    		string Name = column_names[c] + " | ";
+	    		results_write_padded(out_file, Name.data(), Name.size(), 12);
+	    	}
+	    	results_write_str(out_file, "\n");
+	    	results_write_rule(out_file, nb_of_columns);
+    	}
 
     	// -------------------------------
     	// Print Test Vectors and Results
     	// -------------------------------
-    	for (int k=0; k<(*Test_Config)[i].NB_OF_TESTS; k++) {
-    		out_file << fixed;
-    		out_file <<   setw(9)                    << (*Test_Config)[i].T;
-    		out_file <<  setw(12) << setprecision(3) << (*Test_Config)[i].S;
-    		out_file <<  setw(12) << setprecision(3) << host_IN_DATA[global_indx].K;
-    		out_file <<  setw(12) << setprecision(3) << (*Test_Config)[i].r;
-    		out_file <<  setw(12) << setprecision(3) << (*Test_Config)[i].sigma;
-    		out_file <<  setw(12) << setprecision(3) << (*Test_Config)[i].q;
-    		out_file <<  setw(12)                    << (*Test_Config)[i].n;
-    		out_file <<  setw(14) << setprecision(5) << hw_RES[global_indx];
-    		out_file << endl;
-    		global_indx++;
+    	for (; (k<Config->NB_OF_TESTS) && (indx<Nb_Of_Results); k++) {
+    		results_write_int  (out_file, Config->T,          9);
+    		results_write_fixed(out_file, Config->S,         12, 3);
+    		results_write_fixed(out_file, host_IN_DATA[indx].K, 12, 3);
+    		results_write_fixed(out_file, Config->r,         12, 3);
+    		results_write_fixed(out_file, Config->sigma,     12, 3);
+    		results_write_fixed(out_file, Config->q,         12, 3);
+    		results_write_int  (out_file, Config->n,         12);
+    		results_write_fixed(out_file, hw_RES[indx],      14, 5);
+    		results_write_str  (out_file, "\n");
+    		indx++;
     	}
-    	out_file << endl;
+    	if (k == Config->NB_OF_TESTS)
+    		results_write_str(out_file, "\n");
+
+    	Config_Base += Config->NB_OF_TESTS;
     }
-    out_file.close();
+}
+
+void store_results(string SW_HW_Mode, string Out_File_Name, t_in_data* host_IN_DATA, float* hw_RES, vector<test_config_t>* Test_Config) {
+	t_results_file out_file;
+	int            Nb_Of_Results = 0;
+
+	for (unsigned i=0; i<(*Test_Config).size(); i++) Nb_Of_Results += (*Test_Config)[i].NB_OF_TESTS;
+
+	open_results_file(SW_HW_Mode, Out_File_Name, &out_file);
+	store_results_chunk(&out_file, host_IN_DATA, hw_RES, Test_Config, 0, Nb_Of_Results);
+	close_results_file(&out_file);
 }
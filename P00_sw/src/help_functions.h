@@ -25,6 +25,7 @@
 #include <cstring>
 #include <stdlib.h>
 #include <vector>
+#include <stdint.h>
 
 #include <CL/cl.h>
 #include "kernel.h"
@@ -56,11 +57,17 @@ typedef struct {
 } test_config_t;
 
 
+// Number of tests priced at once by the streaming SW model (runs larger than MAX_NB_OF_TESTS)
+#ifndef SW_STREAM_CHUNK_SIZE
+#define SW_STREAM_CHUNK_SIZE 65536
+#endif
+
 typedef struct {
     // ------------------------------------------------
     // SW Resources to be used
     // ------------------------------------------------
     int   NB_OF_THREADS;                      // set in a SW_HW_config file
+    string SW_ENGINE;                         // set in a SW_HW_config file
 
     // ------------------------------------------------
     // Hardware Resources: Available & to be used
@@ -68,8 +75,8 @@ typedef struct {
     int   NB_OF_KERNELS;                      // set in a SW_HW_config file
     int   NB_OF_CUs_PER_KERNEL;               // set in a SW_HW_config file
     int   NB_OF_PARALLEL_FUNCTIONS_PER_CU;    // set in a SW_HW_config file
-    int   MAX_TREE_HEIGHT;                    // Set during Host Code execution. Max height of a Binomial tree supported by a Kernel (defined during kernel implementation)
-    int   MAX_NB_OF_TESTS;                    // Set during Host Code execution. Max number of test vectors supported by the application
+    int   MAX_TREE_HEIGHT;                    // Set during Host Code execution. Max height of a Binomial tree supported by a Kernel (defined during kernel implementation) or by the SW model
+    int   MAX_NB_OF_TESTS;                    // Set during Host Code execution. Max number of test vectors processed at once (larger runs are streamed in chunks)
 
     // ------------------------------------------------
     // Debug Information
@@ -80,6 +87,16 @@ typedef struct {
 
 
 
+// Config file tokenizer: whole file in one '\0' terminated buffer, lines cut in place
+#define CFG_MAX_TOKENS_PER_LINE 16
+
+void   cfg_read_file  (const char* File_Name, vector<char>* Buffer);
+char*  cfg_next_line  (char** Pos, char* End);
+int    cfg_split_line (char* Line, char** Tokens, int Max_Tokens);
+string cfg_line_string(char** Tokens, int Nb_Of_Tokens);
+int    cfg_to_int     (const char* Token, const char* File_Name, int Line_Nb);
+float  cfg_to_float   (const char* Token, const char* File_Name, int Line_Nb);
+
 void read_sw_hw_config_file (const char* SW_HW_Config_File_Name, sw_hw_config_t* SW_HW_Config);
 void print_sw_hw_config_info(sw_hw_config_t SW_HW_Config);
 
@@ -88,6 +105,7 @@ void print_test_config_info(vector<test_config_t>  *Test_Config);
 
 void process_configurations(string sw_hw, sw_hw_config_t* SW_HW_Config, vector<test_config_t>* Test_Config, int *DEFINED_NB_OF_TESTS, int *ROUNDED_NB_OF_TESTS);
 void generate_test_vectors(t_in_data* host_IN_DATA, vector<test_config_t> Test_Config, int ROUNDED_NB_OF_TESTS);
+void generate_test_vectors(t_in_data* host_IN_DATA, vector<test_config_t>* Test_Config, int Start_Index, int Nb_Of_Tests);
 
 // =======================================================
 // Helper Function: Allocate HOST Memory aligned to 4096
@@ -111,5 +129,38 @@ double run_custom_profiling (int Nb_Of_Kernels, int Nb_Of_Memory_Tranfers, cl_ev
 int compare_results(float* sw_Res, float* hw_Res, int Nb_of_Results, int Nb_Of_Errors_To_Reports);
 int cmp_floats(float val1, float val2);
 
+// ----------------------------------------------------------------------------
+// Results files: report table (default) or, with BINOMIAL_RESULTS_FORMAT=bin,
+// a binary file: t_results_header followed by one float per test
+// ----------------------------------------------------------------------------
+#define RESULTS_MAGIC       "BOPM_RS1"
+#define RESULTS_BUFFER_SIZE (1 << 20)           // Results are written in blocks of this size
+
+typedef struct {
+	char     Magic[8];                          // RESULTS_MAGIC (no '\0')
+	uint32_t Record_Size;                       // sizeof(float)
+	uint32_t Reserved;
+	uint64_t Nb_Of_Results;
+} t_results_header;
+
+typedef struct {
+	string   File_Name;
+	int      fd;
+	bool     Binary;
+	uint64_t Nb_Of_Results;                     // Binary file: results written so far
+	char*    Buffer;                            // RESULTS_BUFFER_SIZE bytes block
+	size_t   Used;
+} t_results_file;
+
 void store_results(string SW_HW_Mode, string Out_File_Name, t_in_data* host_IN_DATA, float* hw_res, vector<test_config_t>* Test_Config);
+void open_results_file  (string SW_HW_Mode, string Out_File_Name, t_results_file* out_file);
+void close_results_file (t_results_file* out_file);
+void store_results_chunk(t_results_file* out_file, t_in_data* host_IN_DATA, float* hw_RES, vector<test_config_t>* Test_Config, int Start_Index, int Nb_Of_Results);
+
+// Buffered formatting (same text as setw / fixed / setprecision)
+void results_write_str  (t_results_file* out_file, const char* Str, size_t Size);
+void results_write_str  (t_results_file* out_file, string Str);
+void results_write_int  (t_results_file* out_file, long Value, int Width);
+void results_write_fixed(t_results_file* out_file, float Value, int Width, int Precision);
+void results_write_bin  (t_results_file* out_file, float* RES, int Nb_Of_Results);
 #endif
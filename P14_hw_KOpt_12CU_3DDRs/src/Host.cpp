@@ -42,6 +42,14 @@ using namespace std;
 #include "help_functions.h"
 #include "host_functions.h"
 #include "kernel.h"
+#include "stream_functions.h"
+#include "server_functions.h"
+#include "scheduler_functions.h"
+#include "portfolio_functions.h"
+#include "trace_functions.h"
+#include "cache_functions.h"
+#include "time_functions.h"
+#include "tree_functions.h"
 
 #define ALL_MESSAGES
 
@@ -72,6 +80,7 @@ int main(int argc, char* argv[])
 	//    o) argv[3] SW_HW_Mode
     //    o) argv[4] Test_Config_File Name (FULL Version)
     //    o) argv[5] Test_Config_File Name (HW Emu Version)
+    //       (a .bin or .csv file is a portfolio: one contract per record)
     //    o) argv[6] SW_HW_Config_File Name
 	// ============================================================================
 	#ifdef ALL_MESSAGES
@@ -109,12 +118,15 @@ int main(int argc, char* argv[])
 	cout << "HOST-Info: Test_Config_File_Name   : " << Test_Config_File_Name  << endl;
 	cout << "HOST-Info: SW_HW_Config_File_Name  : " << SW_HW_Config_File_Name << endl;
 
+	// Timeline trace (written at exit)
+	trace_open(getenv("BINOMIAL_TRACE"));
+
     // ---------------------------------------------------------
     // Check SW_HW_Mode value
     // ---------------------------------------------------------
-	if ((SW_HW_Mode!="sw") && (SW_HW_Mode!="hw")) {
+	if ((SW_HW_Mode!="sw") && (SW_HW_Mode!="hw") && (SW_HW_Mode!="sw_server") && (SW_HW_Mode!="hw_server") && (SW_HW_Mode!="client") && (SW_HW_Mode!="hw_dynamic") && (SW_HW_Mode!="hybrid")) {
 		cout << endl << "HOST-Error: SW_HW_Mode option does not support the following value: " << SW_HW_Mode << endl;
-		cout <<         "            Supported values are: sw, hw" << endl << endl;
+		cout <<         "            Supported values are: sw, hw, hw_dynamic, hybrid, sw_server, hw_server, client" << endl << endl;
 		return EXIT_FAILURE;
 	}
 
@@ -127,21 +139,300 @@ int main(int argc, char* argv[])
     sw_hw_config_t         SW_HW_Config;
 
     SW_HW_Config.MAX_NB_OF_TESTS = CONST_MAX_NB_OF_TESTS;
-    SW_HW_Config.MAX_TREE_HEIGHT = CONST_MAX_TREE_HEIGHT;
+    SW_HW_Config.MAX_TREE_HEIGHT = CONST_MAX_TILED_TREE_HEIGHT;
 
+    double Trace_Start = trace_now_us();
     read_sw_hw_config_file(SW_HW_Config_File_Name, &SW_HW_Config);
+    trace_host_phase("read_sw_hw_config_file", Trace_Start);
+
+    // The dataflow kernels do not store the test vectors in BRAM
+    if (SW_HW_Config.KERNEL_TYPE == "dataflow") SW_HW_Config.MAX_NB_OF_TESTS = CONST_MAX_DF_NB_OF_TESTS;
     print_sw_hw_config_info(SW_HW_Config);
 
+    int DEFINED_NB_OF_TESTS;
+    int ROUNDED_NB_OF_TESTS;
+
+	// =========================================================================
+	// Step: Run Pricing Server (test vectors are received over the socket)
+	// =========================================================================
+	if ((SW_HW_Mode == "sw_server") || (SW_HW_Mode == "hw_server")) {
+		string      Backend = SW_HW_Mode.substr(0,2);
+		t_hw_pricer Pricer;
+		double      tstart, tstop;
+
+		process_configurations(Backend, &SW_HW_Config, &Test_Config, &DEFINED_NB_OF_TESTS, &ROUNDED_NB_OF_TESTS);
+
+		cout << endl;
+		cout << "HOST-Info: ============================================================= " << endl;
+		cout << "HOST-Info: Step: Run Pricing Server                                      " << endl;
+		cout << "HOST-Info: ============================================================= " << endl;
+
+		tstart = get_time_ms();
+
+		if ((Backend == "hw") && (hw_pricer_init(&Pricer, &SW_HW_Config, Target_Platform_Vendor, Target_Device_Name, xclbinFilename) != 1))
+			return EXIT_FAILURE;
+
+		tstop = get_time_ms();
+
+		cout << "HOST-Info: Server initialized in " << fixed << setprecision(1) << (tstop-tstart) << " ms" << endl;
+
+		int Status = run_pricing_server(&SW_HW_Config, (Backend == "hw") ? &Pricer : NULL);
+
+		if (Backend == "hw")
+			hw_pricer_release(&Pricer);
+
+		if (Status != 1)
+			return EXIT_FAILURE;
+
+		cout << endl << "HOST-Info: Application Completed" << endl << endl;
+		return EXIT_SUCCESS;
+	}
+
+	// -------------------------------------------------------------
+	// Result cache of the batch modes (BINOMIAL_RESULT_CACHE)
+	// -------------------------------------------------------------
+	t_result_cache* Result_Cache = new t_result_cache;
+	result_cache_init(Result_Cache, result_cache_capacity());
+
+	if (result_cache_enabled(Result_Cache))
+		cout << "HOST-Info: Result cache enabled (" << Result_Cache->Capacity << " results)" << endl;
+
+	// =========================================================================
+	// Step: Price a Portfolio File (one contract per record)
+	// =========================================================================
+	if (is_portfolio_file(Test_Config_File_Name)) {
+		if (SW_HW_Mode == "client") {
+			cout << endl << "HOST-Error: Portfolio files are not supported in client mode" << endl;
+			cout <<         "            Supported modes are: sw, hw, hw_dynamic, hybrid" << endl << endl;
+			return EXIT_FAILURE;
+		}
+
+		process_configurations(SW_HW_Mode, &SW_HW_Config, &Test_Config, &DEFINED_NB_OF_TESTS, &ROUNDED_NB_OF_TESTS);
+
+		if (run_portfolio(SW_HW_Mode, &SW_HW_Config, Result_Cache, Test_Config_File_Name, Target_Platform_Vendor, Target_Device_Name, xclbinFilename) != 1)
+			return EXIT_FAILURE;
+
+		cout << endl << "HOST-Info: Application Completed" << endl << endl;
+		return EXIT_SUCCESS;
+	}
+
+    Trace_Start = trace_now_us();
     read_test_config_file (Test_Config_File_Name,  &Test_Config);
+    trace_host_phase("read_test_config_file", Trace_Start);
     print_test_config_info(&Test_Config);
 
     // -----------------------------------------------------------
     // Check command line options
     // Calculate ROUNDED_NB_OF_TESTS
+    // The client checks the server results with the SW model
     // ------------------------------------------------------------
-    int DEFINED_NB_OF_TESTS;
-    int ROUNDED_NB_OF_TESTS;
-    process_configurations(SW_HW_Mode, &SW_HW_Config, &Test_Config, &DEFINED_NB_OF_TESTS, &ROUNDED_NB_OF_TESTS);
+    process_configurations((SW_HW_Mode == "client") ? "sw" : SW_HW_Mode, &SW_HW_Config, &Test_Config, &DEFINED_NB_OF_TESTS, &ROUNDED_NB_OF_TESTS);
+
+
+	// =========================================================================
+	// Step: Send the test vectors to the Pricing Server
+	// =========================================================================
+	if (SW_HW_Mode == "client") {
+		cout << endl;
+		cout << "HOST-Info: ============================================================= " << endl;
+		cout << "HOST-Info: Step: Run Pricing Client                                      " << endl;
+		cout << "HOST-Info: ============================================================= " << endl;
+
+		double Latency_ms;
+
+		t_in_data* host_IN_DATA = allocate_host_mem<t_in_data>(DEFINED_NB_OF_TESTS,"host_IN_DATA",true);
+		float*     sw_RES       = allocate_host_mem<float>(DEFINED_NB_OF_TESTS,"sw_RES",true);
+		float*     server_RES   = allocate_host_mem<float>(DEFINED_NB_OF_TESTS,"server_RES",true);
+
+		generate_test_vectors(host_IN_DATA, &Test_Config, 0, DEFINED_NB_OF_TESTS);
+
+		if (run_pricing_client(host_IN_DATA, server_RES, DEFINED_NB_OF_TESTS, &Latency_ms) != 1)
+			return EXIT_FAILURE;
+
+		K_americanPut_sw_model(host_IN_DATA, sw_RES, DEFINED_NB_OF_TESTS, SW_HW_Config.NB_OF_THREADS);
+
+		int Nb_Of_Errors = compare_results(sw_RES, server_RES, DEFINED_NB_OF_TESTS, 5);
+
+		cout << endl;
+		cout << "HOST-Info:     NB_OF_TESTS            :  " << right << setw(10) << DEFINED_NB_OF_TESTS << endl;
+		cout << "HOST-Info:     Round Trip (ms)        :  " << right << setw(10) << fixed << setprecision(1) << Latency_ms << endl;
+		cout << "HOST-Info: " << string(62, '-') << endl;
+
+		store_results(SW_HW_Mode, "Client_Res.txt", host_IN_DATA, server_RES, &Test_Config);
+
+		free(host_IN_DATA);
+		free(sw_RES);
+		free(server_RES);
+
+		if (Nb_Of_Errors == 0) {
+			cout << "HOST_Info: Test Passed" << endl;
+		} else {
+			cout << "HOST_Info: Test Failed (#Errors=" << Nb_Of_Errors << ")" << endl << endl;
+			return EXIT_FAILURE;
+		}
+		cout << "HOST-Info: Results stored in the Client_Res.txt file" << endl;
+
+		cout << endl << "HOST-Info: Application Completed" << endl << endl;
+		return EXIT_SUCCESS;
+	}
+
+
+	// =========================================================================
+	// Step: Price the tests with the dynamic CU scheduler
+	//       (hybrid: SW threads price part of the tests next to the CUs)
+	// =========================================================================
+	if ((SW_HW_Mode == "hw_dynamic") || (SW_HW_Mode == "hybrid")) {
+		cout << endl;
+		cout << "HOST-Info: ============================================================= " << endl;
+		cout << "HOST-Info: Step: " << ((SW_HW_Mode == "hybrid") ? "Run Hybrid CPU + HW Implementation" : "Run HW Implementation (Dynamic CU Scheduling)") << endl;
+		cout << "HOST-Info: ============================================================= " << endl;
+
+		double tstart, tstop;
+
+		t_in_data* host_IN_DATA = allocate_host_mem<t_in_data>(DEFINED_NB_OF_TESTS,"host_IN_DATA",true);
+		float*     sw_RES       = allocate_host_mem<float>(DEFINED_NB_OF_TESTS,"sw_RES",true);
+		float*     hw_RES       = allocate_host_mem<float>(DEFINED_NB_OF_TESTS,"hw_RES",true);
+
+		generate_test_vectors(host_IN_DATA, &Test_Config, 0, DEFINED_NB_OF_TESTS);
+
+		K_americanPut_sw_model(host_IN_DATA, sw_RES, DEFINED_NB_OF_TESTS, SW_HW_Config.NB_OF_THREADS);
+
+		cl_platform_id      *Platform_IDs, Target_Platform_ID;
+		cl_device_id        *Device_IDs,   Target_Device_ID;
+		cl_context          Context;
+		cl_command_queue    Command_Queue;
+		cl_program          Program;
+
+		Platform_IDs = NULL; Device_IDs = NULL;
+		if ( select_platform(Platform_IDs,&Target_Platform_ID, Target_Platform_Vendor) != 1)                  return EXIT_FAILURE;
+		if ( select_device(Device_IDs,&Target_Device_ID, Target_Platform_ID, Target_Device_Name) != 1)        return EXIT_FAILURE;
+		if ( create_context(&Context, Target_Device_ID) != 1)                                                 return EXIT_FAILURE;
+		if ( create_command_queue(&Context, &Command_Queue, CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE | CL_QUEUE_PROFILING_ENABLE, Target_Device_ID) != 1) return EXIT_FAILURE;
+		if ( build_program(&Program, xclbinFilename, Target_Device_ID, Context) != 1)                         return EXIT_FAILURE;
+
+		tstart = get_time_ms();
+
+		Trace_Start = trace_now_us();
+		result_cache_price(Result_Cache, host_IN_DATA, hw_RES, DEFINED_NB_OF_TESTS,
+			[&](t_in_data* Batch_IN_DATA, float* Batch_RES, int Nb_Of_Tests) {
+				K_americanPut_hw_dynamic(Context, Command_Queue, Program, &SW_HW_Config, Batch_IN_DATA, Batch_RES, Nb_Of_Tests, (SW_HW_Mode == "hybrid") ? SW_HW_Config.NB_OF_THREADS : 0);
+			});
+		trace_host_phase("K_americanPut_hw_dynamic", Trace_Start);
+
+		tstop = get_time_ms();
+
+		clReleaseProgram(Program);
+		clReleaseCommandQueue(Command_Queue);
+		clReleaseContext(Context);
+		clReleaseDevice(Target_Device_ID);
+
+		int Nb_Of_Errors = compare_results(sw_RES, hw_RES, DEFINED_NB_OF_TESTS, 5);
+
+		cout << endl;
+		cout << "HOST-Info:     NUMBER_OF_KERNELS      :  " << right << setw(10) << (SW_HW_Config).NB_OF_KERNELS << endl;
+		cout << "HOST-Info:     NB_OF_TESTS            :  " << right << setw(10) << DEFINED_NB_OF_TESTS << endl;
+		cout << "HOST-Info:     Runtime (ms)           :  " << right << setw(10) << fixed << setprecision(1) << (tstop-tstart) << endl;
+		print_result_cache_stats(Result_Cache);
+		cout << "HOST-Info: " << string(62, '-') << endl;
+
+		store_results(SW_HW_Mode, "HW_Res.txt", host_IN_DATA, hw_RES, &Test_Config);
+
+		free(host_IN_DATA);
+		free(sw_RES);
+		free(hw_RES);
+
+		if (Nb_Of_Errors == 0) {
+			cout << "HOST_Info: Test Passed" << endl;
+		} else {
+			cout << "HOST_Info: Test Failed (#Errors=" << Nb_Of_Errors << ")" << endl << endl;
+			return EXIT_FAILURE;
+		}
+		cout << "HOST-Info: Results stored in the HW_Res.txt file" << endl;
+
+		cout << endl << "HOST-Info: Application Completed" << endl << endl;
+		return EXIT_SUCCESS;
+	}
+
+
+	// =========================================================================
+	// Step: Stream the tests in chunks when they do not fit MAX_NB_OF_TESTS
+	// =========================================================================
+	if (ROUNDED_NB_OF_TESTS > SW_HW_Config.MAX_NB_OF_TESTS) {
+		double tstart, tstop;
+
+		if (SW_HW_Mode == "sw") {
+			cout << endl;
+			cout << "HOST-Info: ============================================================= " << endl;
+			cout << "HOST-Info: Step: Run SW Model (Streaming)                                " << endl;
+			cout << "HOST-Info: ============================================================= " << endl;
+
+			tstart = get_time_ms();
+
+			Trace_Start = trace_now_us();
+			K_americanPut_sw_stream(&SW_HW_Config, &Test_Config, Result_Cache, DEFINED_NB_OF_TESTS, ROUNDED_NB_OF_TESTS, "SW_Res.txt");
+			trace_host_phase("K_americanPut_sw_stream", Trace_Start);
+
+			tstop = get_time_ms();
+
+			cout << "HOST_Info: SW Model Execution"                                                       << endl;
+			cout << "HOST_Info:     # Threads    = " <<  SW_HW_Config.NB_OF_THREADS                       << endl;
+			cout << "HOST_Info:     # Tests      = " <<  DEFINED_NB_OF_TESTS                              << endl;
+			cout << "HOST_Info:     Runtime (ms) = " << fixed << setprecision(1) << (tstop-tstart) << endl << endl;
+			print_result_cache_stats(Result_Cache);
+			cout << "HOST-Info: Results stored in the SW_Res.txt file" << endl;
+
+			cout << endl << "HOST-Info: Application Completed" << endl << endl;
+			return EXIT_SUCCESS;
+		}
+
+		cout << endl;
+		cout << "HOST-Info: ============================================================= " << endl;
+		cout << "HOST-Info: Step: Run HW Implementation (Streaming)                       " << endl;
+		cout << "HOST-Info: ============================================================= " << endl;
+
+		cl_platform_id      *Platform_IDs, Target_Platform_ID;
+		cl_device_id        *Device_IDs,   Target_Device_ID;
+		cl_context          Context;
+		cl_command_queue    Command_Queue;
+		cl_program          Program;
+
+		Platform_IDs = NULL; Device_IDs = NULL;
+		if ( select_platform(Platform_IDs,&Target_Platform_ID, Target_Platform_Vendor) != 1)                  return EXIT_FAILURE;
+		if ( select_device(Device_IDs,&Target_Device_ID, Target_Platform_ID, Target_Device_Name) != 1)        return EXIT_FAILURE;
+		if ( create_context(&Context, Target_Device_ID) != 1)                                                 return EXIT_FAILURE;
+		if ( create_command_queue(&Context, &Command_Queue, CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE | CL_QUEUE_PROFILING_ENABLE, Target_Device_ID) != 1) return EXIT_FAILURE;
+		if ( build_program(&Program, xclbinFilename, Target_Device_ID, Context) != 1)                         return EXIT_FAILURE;
+
+		tstart = get_time_ms();
+
+		Trace_Start = trace_now_us();
+		int Nb_Of_Errors = K_americanPut_hw_stream(Context, Command_Queue, Program, &SW_HW_Config, &Test_Config, DEFINED_NB_OF_TESTS, ROUNDED_NB_OF_TESTS, "HW_Res.txt");
+		trace_host_phase("K_americanPut_hw_stream", Trace_Start);
+
+		tstop = get_time_ms();
+
+		clReleaseProgram(Program);
+		clReleaseCommandQueue(Command_Queue);
+		clReleaseContext(Context);
+		clReleaseDevice(Target_Device_ID);
+
+		cout << endl;
+		cout << "HOST-Info:     NUMBER_OF_KERNELS      :  " << right << setw(10) << (SW_HW_Config).NB_OF_KERNELS << endl;
+		cout << "HOST-Info:     NB_OF_TESTS            :  " << right << setw(10) << DEFINED_NB_OF_TESTS << endl;
+		cout << "HOST-Info:     Runtime (ms)           :  " << right << setw(10) << fixed << setprecision(1) << (tstop-tstart) << endl;
+		cout << "HOST-Info: " << string(62, '-') << endl;
+
+		if (Nb_Of_Errors == 0) {
+			cout << "HOST_Info: Test Passed" << endl;
+		} else {
+			cout << "HOST_Info: Test Failed (#Errors=" << Nb_Of_Errors << ")" << endl << endl;
+			return EXIT_FAILURE;
+		}
+		cout << "HOST-Info: Results stored in the HW_Res.txt file" << endl;
+
+		cout << endl << "HOST-Info: Application Completed" << endl << endl;
+		return EXIT_SUCCESS;
+	}
 
 
 	// =========================================================================
@@ -159,8 +450,10 @@ int main(int argc, char* argv[])
 	// ---------------------------------------------------------------------------------
 	// Allocate Memory for host_IN_DATA and initialize it (t_in_data)
 	// ---------------------------------------------------------------------------------
+	Trace_Start = trace_now_us();
 	host_IN_DATA = allocate_host_mem<t_in_data>(ROUNDED_NB_OF_TESTS,"host_IN_DATA",true);
     generate_test_vectors(host_IN_DATA, Test_Config, ROUNDED_NB_OF_TESTS);
+    trace_host_phase("generate_test_vectors", Trace_Start);
 
 	// ---------------------------------------------------------------------------------
 	// Allocate Memory for sw_RES and hw_RES to store SW and HW results
@@ -182,26 +475,31 @@ int main(int argc, char* argv[])
 		cout << "HOST-Info: ============================================================= " << endl;
 
 		double tstart, tstop;
-		struct timeval t;
 
-		gettimeofday(&t, NULL);
-		tstart = 1.0e-6*t.tv_usec + t.tv_sec;
+		tstart = get_time_ms();
+		Trace_Start = trace_now_us();
 
-		K_americanPut_sw_model(host_IN_DATA, sw_RES, ROUNDED_NB_OF_TESTS, SW_HW_Config.NB_OF_THREADS);
+		result_cache_price(Result_Cache, host_IN_DATA, sw_RES, ROUNDED_NB_OF_TESTS,
+			[&](t_in_data* Batch_IN_DATA, float* Batch_RES, int Nb_Of_Tests) {
+				K_americanPut_sw_model(Batch_IN_DATA, Batch_RES, Nb_Of_Tests, SW_HW_Config.NB_OF_THREADS);
+			});
 
-		gettimeofday(&t, NULL);
-		tstop = 1.0e-6*t.tv_usec + t.tv_sec;
+		trace_host_phase("K_americanPut_sw_model", Trace_Start);
+		tstop = get_time_ms();
 
 		cout << "HOST_Info: SW Model Execution"                                                       << endl;
 		cout << "HOST_Info:     # Threads    = " <<  SW_HW_Config.NB_OF_THREADS                       << endl;
-		cout << "HOST_Info:     Runtime (ms) = " << fixed << setprecision(1) << (tstop-tstart)*1000.0 << endl << endl;
+		cout << "HOST_Info:     Runtime (ms) = " << fixed << setprecision(1) << (tstop-tstart) << endl << endl;
+		print_result_cache_stats(Result_Cache);
 
 		// ============================================================================
 		// Step: Store results in a file
 		// ============================================================================
 	    string HW_Out_File_Name = "SW_Res.txt";
 	    cout << "HOST-Info: Results stored in the " + HW_Out_File_Name + " file ..." << endl;
-	    store_results(SW_HW_Mode, HW_Out_File_Name, host_IN_DATA, hw_RES, &Test_Config);
+	    Trace_Start = trace_now_us();
+	    store_results(SW_HW_Mode, HW_Out_File_Name, host_IN_DATA, sw_RES, &Test_Config);
+	    trace_host_phase("store_results", Trace_Start);
 
 		cout << endl << "HOST-Info: Application Completed" << endl << endl;
 		return EXIT_SUCCESS;
@@ -217,7 +515,9 @@ int main(int argc, char* argv[])
 	cout << "HOST-Info: Step: Generate Reference Data                                 " << endl;
 	cout << "HOST-Info: ============================================================= " << endl;
 
+	Trace_Start = trace_now_us();
 	K_americanPut_sw_model(host_IN_DATA, sw_RES, ROUNDED_NB_OF_TESTS, 1);
+	trace_host_phase("K_americanPut_sw_model (reference)", Trace_Start);
 
 	// ============================================================================
 	// Step: Detect Target Platform and Target Device in a system.
@@ -240,6 +540,7 @@ int main(int argc, char* argv[])
 
 	#define Command_Queue_Properties CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE | CL_QUEUE_PROFILING_ENABLE
 
+	Trace_Start = trace_now_us();
 	Platform_IDs = NULL; Device_IDs = NULL;
 	if ( select_platform(Platform_IDs,&Target_Platform_ID, Target_Platform_Vendor) != 1)                  return EXIT_FAILURE;
 	if ( select_device(Device_IDs,&Target_Device_ID, Target_Platform_ID, Target_Device_Name) != 1)        return EXIT_FAILURE;
@@ -263,42 +564,92 @@ int main(int argc, char* argv[])
 	cl_program Program;
 
 	if ( build_program(&Program, xclbinFilename, Target_Device_ID, Context) != 1) return EXIT_FAILURE;
+	trace_host_phase("OpenCL setup (context, program)", Trace_Start);
 
 	// -------------------------------------------------------------
 	// Step: Create Array to store Kernels info
 	//       Note: each kernel may have multiple CUs
+	//       The test vectors of a kernel are split in slices of up to
+	//       HW_SLICE_TESTS_PER_CU tests per CU. Every kernel has a ring
+	//       of QUEUE_DEPTH sets of buffers (slots): slice s uses slot
+	//       s%QUEUE_DEPTH, which is refilled as soon as the results of
+	//       slice s-QUEUE_DEPTH are read back.
 	// -------------------------------------------------------------
+	typedef struct {
+			int              Start_Index;           // First test vector of the slice (in the test vectors of the kernel)
+			int              Nb_Of_Test_Vectors;    // Number of test vectors and results of the slice
+	} t_slice;
+
+	typedef struct {
+			t_in_option*     host_IBuf;             // In Buffer in Host Mem associated with a slot (one record per test)
+			t_tree_params*   host_TBuf;             // Tree Buffer in Host Mem associated with a slot (one record per tree)
+			float*           host_OBuf;             // OUT Buffer in Host Mem associated with a slot
+
+			cl_mem           GlobMem_IBuf;          // In Buffer in Global Mem associated with a slot
+			cl_mem_ext_ptr_t GlobMem_IBuf_EXT;
+			cl_mem           GlobMem_TBuf;          // Tree Buffer in Global Mem associated with a slot
+			cl_mem_ext_ptr_t GlobMem_TBuf_EXT;
+			cl_mem           GlobMem_OBuf;          // OUT Buffer in Global Mem associated with a slot
+			cl_mem_ext_ptr_t GlobMem_OBuf_EXT;
+			cl_mem           GlobMem_CBuf;          // p columns of the trees taller than CONST_MAX_TREE_HEIGHT (Global Mem only)
+			cl_mem_ext_ptr_t GlobMem_CBuf_EXT;
+	} t_slot;
+
 	typedef struct {
 			string           name;                  // {"K_americanPut_0", "K_americanPut_1", ... };
 			cl_kernel        kernel;
 
-			int              Nb_Of_Test_Vectors;    // Defines the number of test vectors and results, buffers will store
+			int              Nb_Of_Test_Vectors;    // Defines the number of test vectors and results, the kernel slices will store
 			                                        // This value is setup manually in the code, depending on the Host Code implementation strategy
+			t_slot*          Slot;                  // Ring of NB_OF_SLOTS sets of buffers
+	} t_kernel;
 
-			t_in_data*       host_IBuf;             // In Buffer in Host Mem associated with a kernel
+	// ....................................................................
+	// The tests which hit the result cache are not sent to the kernels:
+	// the kernels price the HW_NB_OF_TESTS tests of Cache_Batch (the misses
+	// rounded up to a multiple of the kernels, CUs and parallel functions).
+	// Without cache, Cache_Batch is host_IN_DATA/hw_RES.
+	// ....................................................................
+	t_result_cache_batch Cache_Batch;
+	result_cache_gather(Result_Cache, host_IN_DATA, hw_RES, DEFINED_NB_OF_TESTS, ROUNDED_NB_OF_TESTS,
+	                    (SW_HW_Config).NB_OF_KERNELS * (SW_HW_Config).NB_OF_CUs_PER_KERNEL * (SW_HW_Config).NB_OF_PARALLEL_FUNCTIONS_PER_CU, &Cache_Batch);
 
-			cl_mem           GlobMem_IBuf;          // In Buffer in Global Mem associated with a kernel
-			cl_mem_ext_ptr_t GlobMem_IBuf_EXT;
-			cl_mem           GlobMem_OBuf;          // OUT Buffer in Global Mem associated with a kernel
-			cl_mem_ext_ptr_t GlobMem_OBuf_EXT;
+	int HW_NB_OF_TESTS = Cache_Batch.Nb_Of_Tests;
 
-			float*           host_OBuf;             // OUT Buffer in Host Mem associated with a kernel
-	} t_kernel;
+	// ....................................................................
+	// A slice holds a multiple of NB_OF_CUs_PER_KERNEL*NB_OF_PARALLEL_FUNCTIONS_PER_CU test vectors
+	// (the slices are the same for all kernels)
+	// ....................................................................
+	int Slice_Unit   = (SW_HW_Config).NB_OF_CUs_PER_KERNEL * (SW_HW_Config).NB_OF_PARALLEL_FUNCTIONS_PER_CU;
+	int Nb_Of_Units  = HW_NB_OF_TESTS / (SW_HW_Config).NB_OF_KERNELS / Slice_Unit;
+	int Slice_Units  = max(1, HW_SLICE_TESTS_PER_CU / (SW_HW_Config).NB_OF_PARALLEL_FUNCTIONS_PER_CU);
+	int NB_OF_SLICES = (Nb_Of_Units + Slice_Units - 1) / Slice_Units;
+	int NB_OF_SLOTS  = min((SW_HW_Config).QUEUE_DEPTH, NB_OF_SLICES);
+	int Slot_Size    = min(Slice_Units, Nb_Of_Units) * Slice_Unit;
+
+	t_slice *Slices = new t_slice[NB_OF_SLICES];
+
+	for (int s=0; s<NB_OF_SLICES; s++) {
+		Slices[s].Start_Index        = s * Slice_Units * Slice_Unit;
+		Slices[s].Nb_Of_Test_Vectors = min(Slice_Units, Nb_Of_Units - s*Slice_Units) * Slice_Unit;
+	}
+
+	cout << "HOST-Info: " << NB_OF_SLICES << " slices of up to " << Slot_Size << " tests per kernel, " << NB_OF_SLOTS << " slices in flight per kernel" << endl;
 
 	// ....................................................................
 	// Create Kernel related objects for EACH kernel implemented on Alveo
 	//   o) Allocate memory to store kernel information
 	//   o) Generate Kernel Name and Kernel object
-	//   o) Allocate In/Out Host   Memory buffers
-	//   o) Allocate In/Out Global Memory buffers
+	//   o) Allocate In/Out Host   Memory buffers of each slot
 	// ....................................................................
+	Trace_Start = trace_now_us();
 	t_kernel *HW_Kernels = new t_kernel[(SW_HW_Config).NB_OF_KERNELS];
 
 	for (int i=0; i<(SW_HW_Config).NB_OF_KERNELS; i++) {
 
 		// Create Kernel Name
 		//............................................................
-		HW_Kernels[i].name= "K_americanPut_" + to_string(i);
+		HW_Kernels[i].name= kernel_name(&SW_HW_Config, i);
 
 		// Create Kernel Object
 		//............................................................
@@ -307,52 +658,97 @@ int main(int argc, char* argv[])
 
 		// Define number of test vectors/results buffers will store
 		//............................................................
-		HW_Kernels[i].Nb_Of_Test_Vectors = ROUNDED_NB_OF_TESTS / (SW_HW_Config).NB_OF_KERNELS;   // This value is specific for the implementation strategy
+		HW_Kernels[i].Nb_Of_Test_Vectors = HW_NB_OF_TESTS / (SW_HW_Config).NB_OF_KERNELS;   // This value is specific for the implementation strategy
 
-		// Allocate In/Out Host buffers
+		// Allocate In/Out Host buffers of the ring
 		//............................................................
-		HW_Kernels[i].host_IBuf = allocate_host_mem<t_in_data>(HW_Kernels[i].Nb_Of_Test_Vectors,HW_Kernels[i].name+".host_IBuf",true);
-		HW_Kernels[i].host_OBuf = allocate_host_mem<float>(HW_Kernels[i].Nb_Of_Test_Vectors,HW_Kernels[i].name+".host_OBuf",true);
+		HW_Kernels[i].Slot = new t_slot[NB_OF_SLOTS];
+
+		for (int b=0; b<NB_OF_SLOTS; b++) {
+			t_slot* Slot     = &HW_Kernels[i].Slot[b];
+			string  Buf_Name = HW_Kernels[i].name + ".Slot[" + to_string(b) + "]";
+
+			Slot->host_IBuf = allocate_host_mem<t_in_option>(Slot_Size,Buf_Name+".host_IBuf",true);
+			Slot->host_TBuf = allocate_host_mem<t_tree_params>(Slot_Size,Buf_Name+".host_TBuf",true);
+			Slot->host_OBuf = allocate_host_mem<float>(Slot_Size,Buf_Name+".host_OBuf",true);
+		}
 	}
 
+	// ....................................................................
+	// Every parallel function of a CU stores its p column in GlobMem_CBuf
+	// (only used by trees taller than CONST_MAX_TREE_HEIGHT)
+	// ....................................................................
+	int Col_Stride = get_max_tree_height(&Test_Config);
+	if (Col_Stride <= CONST_MAX_TREE_HEIGHT) Col_Stride = 1;
+
+	int Nb_Of_Cols = (SW_HW_Config).NB_OF_CUs_PER_KERNEL * (SW_HW_Config).NB_OF_PARALLEL_FUNCTIONS_PER_CU;
+
 	// ....................................................................
 	// Configure DDRs (using Xilinx Extension)
-	// Note: DDR Banks should be set for each implementation strategy
+	// Note: the memory bank of each kernel is set by the MEM_BANK lines of
+	//       the SW_HW_config file (same mapping as the --sp options)
 	// ....................................................................
 	for (int i=0; i<(SW_HW_Config).NB_OF_KERNELS; i++) {
-		HW_Kernels[i].GlobMem_IBuf_EXT.obj   = HW_Kernels[i].host_IBuf;
-		HW_Kernels[i].GlobMem_IBuf_EXT.param = 0;
-		HW_Kernels[i].GlobMem_OBuf_EXT.obj   = HW_Kernels[i].host_OBuf;
-		HW_Kernels[i].GlobMem_OBuf_EXT.param = 0;
+		for (int b=0; b<NB_OF_SLOTS; b++) {
+			t_slot* Slot = &HW_Kernels[i].Slot[b];
+
+			Slot->GlobMem_IBuf_EXT.obj   = Slot->host_IBuf;
+			Slot->GlobMem_IBuf_EXT.param = 0;
+			Slot->GlobMem_IBuf_EXT.flags = kernel_mem_flags(&SW_HW_Config, i);
+			Slot->GlobMem_TBuf_EXT.obj   = Slot->host_TBuf;
+			Slot->GlobMem_TBuf_EXT.param = 0;
+			Slot->GlobMem_TBuf_EXT.flags = kernel_mem_flags(&SW_HW_Config, i);
+			Slot->GlobMem_OBuf_EXT.obj   = Slot->host_OBuf;
+			Slot->GlobMem_OBuf_EXT.param = 0;
+			Slot->GlobMem_OBuf_EXT.flags = kernel_mem_flags(&SW_HW_Config, i);
+			Slot->GlobMem_CBuf_EXT.obj   = NULL;
+			Slot->GlobMem_CBuf_EXT.param = 0;
+			Slot->GlobMem_CBuf_EXT.flags = kernel_mem_flags(&SW_HW_Config, i);
+		}
 	}
 
-	HW_Kernels[0].GlobMem_IBuf_EXT.flags  = XCL_MEM_DDR_BANK0;
-	HW_Kernels[0].GlobMem_OBuf_EXT.flags  = XCL_MEM_DDR_BANK0;
-	HW_Kernels[1].GlobMem_IBuf_EXT.flags  = XCL_MEM_DDR_BANK2;
-	HW_Kernels[1].GlobMem_OBuf_EXT.flags  = XCL_MEM_DDR_BANK2;
-	HW_Kernels[2].GlobMem_IBuf_EXT.flags  = XCL_MEM_DDR_BANK3;
-	HW_Kernels[2].GlobMem_OBuf_EXT.flags  = XCL_MEM_DDR_BANK3;
-
 
 	for (int i=0; i<(SW_HW_Config).NB_OF_KERNELS; i++) {
-
-		// GlobMem_IBuf
-		// .....................
-		cout << "HOST-Info: Allocating Global Memory for " + HW_Kernels[i].name + ".GlobMem_IBuf ..." << endl;
-		HW_Kernels[i].GlobMem_IBuf = clCreateBuffer(Context, CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR | CL_MEM_EXT_PTR_XILINX, HW_Kernels[i].Nb_Of_Test_Vectors * sizeof(t_in_data),  &(HW_Kernels[i].GlobMem_IBuf_EXT), &errCode);
-		ocl_check_status(errCode,"Failed to allocate Global Memory for " + HW_Kernels[i].name + ".GlobMem_IBuf");
-
-		errCode = clEnqueueMigrateMemObjects(Command_Queue, 1, &(HW_Kernels[i].GlobMem_IBuf), CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED, 0, NULL, NULL);
-		ocl_check_status(errCode,"Failed to Migrate " + HW_Kernels[i].name + ".GlobMem_IBuf from Host Memory");
-
-		// GlobMem_OBuf
-		// .....................
-		cout << "HOST-Info: Allocating Global Memory for " + HW_Kernels[i].name + ".GlobMem_OBuf ..." << endl;
-		HW_Kernels[i].GlobMem_OBuf = clCreateBuffer(Context, CL_MEM_WRITE_ONLY | CL_MEM_USE_HOST_PTR | CL_MEM_EXT_PTR_XILINX, HW_Kernels[i].Nb_Of_Test_Vectors * sizeof(float), &(HW_Kernels[i].GlobMem_OBuf_EXT), &errCode);		ocl_check_status(errCode,"Failed to allocate Global Memory for " + HW_Kernels[i].name+".GlobMem_OBuf");
-
-		errCode = clEnqueueMigrateMemObjects(Command_Queue, 1, &(HW_Kernels[i].GlobMem_OBuf), CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED, 0, NULL, NULL);
-		ocl_check_status(errCode,"Failed to Migrate " + HW_Kernels[i].name + ".GlobMem_OBuf from Host Memory");
+		for (int b=0; b<NB_OF_SLOTS; b++) {
+			t_slot* Slot     = &HW_Kernels[i].Slot[b];
+			string  Buf_Name = HW_Kernels[i].name + ".Slot[" + to_string(b) + "]";
+
+			// GlobMem_IBuf
+			// .....................
+			cout << "HOST-Info: Allocating Global Memory for " + Buf_Name + ".GlobMem_IBuf ..." << endl;
+			Slot->GlobMem_IBuf = clCreateBuffer(Context, CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR | CL_MEM_EXT_PTR_XILINX, Slot_Size * sizeof(t_in_option),  &(Slot->GlobMem_IBuf_EXT), &errCode);
+			ocl_check_status(errCode,"Failed to allocate Global Memory for " + Buf_Name + ".GlobMem_IBuf");
+
+			errCode = clEnqueueMigrateMemObjects(Command_Queue, 1, &(Slot->GlobMem_IBuf), CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED, 0, NULL, NULL);
+			ocl_check_status(errCode,"Failed to Migrate " + Buf_Name + ".GlobMem_IBuf from Host Memory");
+
+			// GlobMem_TBuf
+			// .....................
+			cout << "HOST-Info: Allocating Global Memory for " + Buf_Name + ".GlobMem_TBuf ..." << endl;
+			Slot->GlobMem_TBuf = clCreateBuffer(Context, CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR | CL_MEM_EXT_PTR_XILINX, Slot_Size * sizeof(t_tree_params),  &(Slot->GlobMem_TBuf_EXT), &errCode);
+			ocl_check_status(errCode,"Failed to allocate Global Memory for " + Buf_Name + ".GlobMem_TBuf");
+
+			errCode = clEnqueueMigrateMemObjects(Command_Queue, 1, &(Slot->GlobMem_TBuf), CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED, 0, NULL, NULL);
+			ocl_check_status(errCode,"Failed to Migrate " + Buf_Name + ".GlobMem_TBuf from Host Memory");
+
+			// GlobMem_OBuf
+			// .....................
+			cout << "HOST-Info: Allocating Global Memory for " + Buf_Name + ".GlobMem_OBuf ..." << endl;
+			Slot->GlobMem_OBuf = clCreateBuffer(Context, CL_MEM_WRITE_ONLY | CL_MEM_USE_HOST_PTR | CL_MEM_EXT_PTR_XILINX, Slot_Size * sizeof(float), &(Slot->GlobMem_OBuf_EXT), &errCode);
+			ocl_check_status(errCode,"Failed to allocate Global Memory for " + Buf_Name + ".GlobMem_OBuf");
+
+			errCode = clEnqueueMigrateMemObjects(Command_Queue, 1, &(Slot->GlobMem_OBuf), CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED, 0, NULL, NULL);
+			ocl_check_status(errCode,"Failed to Migrate " + Buf_Name + ".GlobMem_OBuf from Host Memory");
+
+			// GlobMem_CBuf (the CUs of different slots may run at the same time)
+			// .....................
+			cout << "HOST-Info: Allocating Global Memory for " + Buf_Name + ".GlobMem_CBuf ..." << endl;
+			Slot->GlobMem_CBuf = clCreateBuffer(Context, CL_MEM_READ_WRITE | CL_MEM_EXT_PTR_XILINX, Nb_Of_Cols * Col_Stride * sizeof(float), &(Slot->GlobMem_CBuf_EXT), &errCode);
+			ocl_check_status(errCode,"Failed to allocate Global Memory for " + Buf_Name + ".GlobMem_CBuf");
+		}
 	}
+	clFinish(Command_Queue);
+	trace_host_phase("Create kernels and buffers", Trace_Start);
 
 	// ============================================================================
 	// Step: Run Application
@@ -365,92 +761,126 @@ int main(int argc, char* argv[])
 
 	// ---------------------------------------------------------
 	// Allocate memory to store Memory R/W and Kernel Exe events
+	// (one set per slice, kept for the profiling)
 	// ---------------------------------------------------------
 	int NB_OF_MEM_RD_EVENTS, NB_OF_MEM_WR_EVENTS, NB_OF_EXE_EVENTS;
 
-	NB_OF_MEM_RD_EVENTS = (SW_HW_Config).NB_OF_KERNELS;
-	NB_OF_MEM_WR_EVENTS = (SW_HW_Config).NB_OF_KERNELS;
-	NB_OF_EXE_EVENTS    = (SW_HW_Config).NB_OF_KERNELS * (SW_HW_Config).NB_OF_CUs_PER_KERNEL;
+	NB_OF_MEM_RD_EVENTS = (SW_HW_Config).NB_OF_KERNELS * NB_OF_SLICES;
+	NB_OF_MEM_WR_EVENTS = (SW_HW_Config).NB_OF_KERNELS * NB_OF_SLICES;
+	NB_OF_EXE_EVENTS    = (SW_HW_Config).NB_OF_KERNELS * NB_OF_SLICES * (SW_HW_Config).NB_OF_CUs_PER_KERNEL;
 
 	cl_event *Mem_rd_event = new cl_event[NB_OF_MEM_RD_EVENTS];
 	cl_event *Mem_wr_event = new cl_event[NB_OF_MEM_WR_EVENTS];
 	cl_event *K_exe_event  = new cl_event[NB_OF_EXE_EVENTS];
 
+	int      *Slice_Trees  = new int[NB_OF_MEM_WR_EVENTS];       // Number of trees sent with each slice
+
 	// ------------------------------------------------------------------------------------------------
 	// Run Test Vectors
+	//   Each slice: host_IN_DATA -> host_IBuf/host_TBuf (options and trees) -> GlobMem_IBuf/GlobMem_TBuf -> CUs
+	//               -> GlobMem_OBuf -> host_OBuf -> hw_RES
+	//   Each step only waits for the events of the previous step of the same slice, so writes, kernel
+	//   runs and reads of the NB_OF_SLOTS slices in flight overlap.
+	//   Iteration s retires slice s-NB_OF_SLOTS (waits for its results and copies them to hw_RES) and
+	//   refills its slot with slice s, so NB_OF_SLOTS slices stay in flight until all slices are enqueued.
 	// ------------------------------------------------------------------------------------------------
 	cout << endl << "HOST_Info: Waiting for application to be completed ..." << endl << endl;
 
-	// ---------------------------------------------------------
-	// Copy test vectors: host_IN_DATA -> host_IBuf
-	// ---------------------------------------------------------
-	for (int k_index=0; k_index<(SW_HW_Config).NB_OF_KERNELS; k_index++)
-		for (int i=0; i<HW_Kernels[k_index].Nb_Of_Test_Vectors; i++)
-			HW_Kernels[k_index].host_IBuf[i] = host_IN_DATA[k_index*HW_Kernels[k_index].Nb_Of_Test_Vectors + i];
+	size_t globalSize[1]; globalSize[0] = 1;
+	size_t localSize[1];  localSize[0]  = 1;
 
+	Trace_Start = trace_now_us();
+	trace_device_sync();
 
-	// .....................................................................
-	// Copy ALL test vectors: host_IBuf -> GlobMem_IBuf
-	// .....................................................................
-	for (int k_index=0; k_index<(SW_HW_Config).NB_OF_KERNELS; k_index++) {
-		errCode = clEnqueueMigrateMemObjects(Command_Queue, 1, &(HW_Kernels[k_index].GlobMem_IBuf), 0,
-											   0, NULL,                 &Mem_wr_event[k_index]);
-		ocl_check_status(errCode,"Failed to write: " + HW_Kernels[k_index].name+".Host_IBuf -> " + HW_Kernels[k_index].name + ".GlobMem_IBuf");
+	for (int s=0; s<NB_OF_SLICES+NB_OF_SLOTS; s++) {
 
-	}
-	clFinish(Command_Queue);
+		// .....................................................................
+		// Retire slice s-NB_OF_SLOTS: host_OBuf -> hw_RES
+		// .....................................................................
+		if (s >= NB_OF_SLOTS) {
+			t_slice* Slice = &Slices[s-NB_OF_SLOTS];
 
-	// .................................................................
-	// Submit Kernel for execution
-	// .................................................................
-	size_t globalSize[1]; globalSize[0] = 1;
-	size_t localSize[1];  localSize[0]  = 1;
+			for (int k_index=0; k_index<(SW_HW_Config).NB_OF_KERNELS; k_index++) {
+				t_slot* Slot = &HW_Kernels[k_index].Slot[(s-NB_OF_SLOTS) % NB_OF_SLOTS];
 
-	for (int k_index=0; k_index<(SW_HW_Config).NB_OF_KERNELS; k_index++) {
-		for (int cu_index=0; cu_index<(SW_HW_Config).NB_OF_CUs_PER_KERNEL; cu_index++) {
-
-			// ........................
-			// Setup Kernel Arguments
-			// ........................
-			int Nb_Of_Test_Vectors_Per_CU = HW_Kernels[k_index].Nb_Of_Test_Vectors / (SW_HW_Config).NB_OF_CUs_PER_KERNEL;
-			int Start_Index = cu_index * Nb_Of_Test_Vectors_Per_CU;
-
-			int arg_indx = 0;
-			errCode = CL_SUCCESS;
-			errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_mem),    &(HW_Kernels[k_index].GlobMem_IBuf));
-			errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_mem),    &(HW_Kernels[k_index].GlobMem_OBuf));
-			errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_int),    &(Nb_Of_Test_Vectors_Per_CU));
-			errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_int),    &Start_Index);
-
-		    ocl_check_status(errCode,"Unable to setup Kernel Arguments");
-
-			// ........................
-			// Submit CU
-			// ........................
-			errCode = clEnqueueNDRangeKernel(Command_Queue, HW_Kernels[k_index].kernel, 1, NULL, globalSize, localSize,
-					                                0, NULL, &K_exe_event[(k_index*(SW_HW_Config).NB_OF_CUs_PER_KERNEL) + cu_index]);
-		    ocl_check_status(errCode,"Failed to submit kernel for execution: " + HW_Kernels[k_index].name);
-		}
-	}
-	clFinish(Command_Queue);
+				clWaitForEvents(1, &Mem_rd_event[k_index*NB_OF_SLICES + s-NB_OF_SLOTS]);
 
-	// .................................................................
-	// Copy ALL results: GlobMem_OBuf -> host_OBuf
-	// .................................................................
-	for (int k_index=0; k_index<(SW_HW_Config).NB_OF_KERNELS; k_index++) {
-		errCode = clEnqueueMigrateMemObjects(Command_Queue, 1, &(HW_Kernels[k_index].GlobMem_OBuf), CL_MIGRATE_MEM_OBJECT_HOST,
-											   0, NULL,                 &Mem_rd_event[k_index]);
-	    ocl_check_status(errCode,"Failed to write: " + HW_Kernels[k_index].name + ".GlobMem_OBuf -> " + HW_Kernels[k_index].name + ".Host_OBuf");
+				for (int i=0; i<Slice->Nb_Of_Test_Vectors; i++)
+					Cache_Batch.RES[k_index*HW_Kernels[k_index].Nb_Of_Test_Vectors + Slice->Start_Index + i] = Slot->host_OBuf[i];
+			}
+		}
 
+		if (s >= NB_OF_SLICES) continue;
+
+		// .....................................................................
+		// Enqueue slice s in slot s%NB_OF_SLOTS of every kernel
+		// .....................................................................
+		t_slice* Slice = &Slices[s];
+
+		for (int k_index=0; k_index<(SW_HW_Config).NB_OF_KERNELS; k_index++) {
+			t_slot* Slot       = &HW_Kernels[k_index].Slot[s % NB_OF_SLOTS];
+			int     Slice_Indx = k_index*NB_OF_SLICES + s;
+
+			// ---------------------------------------------------------
+			// Pack test vectors: host_IN_DATA -> host_IBuf, host_TBuf
+			// ---------------------------------------------------------
+			Slice_Trees[Slice_Indx] = pack_kernel_inputs(&Cache_Batch.IN_DATA[k_index*HW_Kernels[k_index].Nb_Of_Test_Vectors + Slice->Start_Index],
+			                                             Slice->Nb_Of_Test_Vectors, Slot->host_IBuf, Slot->host_TBuf, 0);
+
+			// .....................................................................
+			// Copy test vectors: host_IBuf -> GlobMem_IBuf, host_TBuf -> GlobMem_TBuf
+			// .....................................................................
+			cl_mem IN_Bufs[2] = {Slot->GlobMem_IBuf, Slot->GlobMem_TBuf};
+
+			errCode = clEnqueueMigrateMemObjects(Command_Queue, 2, IN_Bufs, 0,
+												   0, NULL,                 &Mem_wr_event[Slice_Indx]);
+			ocl_check_status(errCode,"Failed to write: " + HW_Kernels[k_index].name+".Host_IBuf/Host_TBuf -> " + HW_Kernels[k_index].name + ".GlobMem_IBuf/GlobMem_TBuf");
+
+			// .................................................................
+			// Submit Kernel for execution
+			// .................................................................
+			for (int cu_index=0; cu_index<(SW_HW_Config).NB_OF_CUs_PER_KERNEL; cu_index++) {
+
+				// ........................
+				// Setup Kernel Arguments
+				// ........................
+				int Nb_Of_Test_Vectors_Per_CU = Slice->Nb_Of_Test_Vectors / (SW_HW_Config).NB_OF_CUs_PER_KERNEL;
+				int Start_Index = cu_index * Nb_Of_Test_Vectors_Per_CU;
+				int Col_Base    = cu_index * (SW_HW_Config).NB_OF_PARALLEL_FUNCTIONS_PER_CU * Col_Stride;
+
+				int arg_indx = 0;
+				errCode = CL_SUCCESS;
+				errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_mem),    &(Slot->GlobMem_IBuf));
+				errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_mem),    &(Slot->GlobMem_TBuf));
+				errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_mem),    &(Slot->GlobMem_OBuf));
+				errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_int),    &(Nb_Of_Test_Vectors_Per_CU));
+				errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_int),    &Start_Index);
+				errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_mem),    &(Slot->GlobMem_CBuf));
+				errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_int),    &Col_Base);
+				errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_int),    &Col_Stride);
+
+			    ocl_check_status(errCode,"Unable to setup Kernel Arguments");
+
+				// ........................
+				// Submit CU
+				// ........................
+				errCode = clEnqueueNDRangeKernel(Command_Queue, HW_Kernels[k_index].kernel, 1, NULL, globalSize, localSize,
+						                                1, &Mem_wr_event[Slice_Indx], &K_exe_event[(Slice_Indx*(SW_HW_Config).NB_OF_CUs_PER_KERNEL) + cu_index]);
+			    ocl_check_status(errCode,"Failed to submit kernel for execution: " + HW_Kernels[k_index].name);
+			}
+
+			// .................................................................
+			// Copy results: GlobMem_OBuf -> host_OBuf
+			// .................................................................
+			errCode = clEnqueueMigrateMemObjects(Command_Queue, 1, &(Slot->GlobMem_OBuf), CL_MIGRATE_MEM_OBJECT_HOST,
+												   (SW_HW_Config).NB_OF_CUs_PER_KERNEL, &K_exe_event[Slice_Indx*(SW_HW_Config).NB_OF_CUs_PER_KERNEL], &Mem_rd_event[Slice_Indx]);
+		    ocl_check_status(errCode,"Failed to write: " + HW_Kernels[k_index].name + ".GlobMem_OBuf -> " + HW_Kernels[k_index].name + ".Host_OBuf");
+		}
+		clFlush(Command_Queue);
 	}
-	clFinish(Command_Queue);
+	trace_host_phase("Run slices (ring of QUEUE_DEPTH slots)", Trace_Start);
 
-	// .....................................................................
-	// Copy ALL results: host_OBuf -> hw_RES[i]
-	// .....................................................................
-	for (int k_index=0; k_index<(SW_HW_Config).NB_OF_KERNELS; k_index++)
-		for (int i=0; i<HW_Kernels[k_index].Nb_Of_Test_Vectors; i++)
-			hw_RES[k_index*HW_Kernels[k_index].Nb_Of_Test_Vectors + i] = HW_Kernels[k_index].host_OBuf[i];
+	result_cache_scatter(Result_Cache, &Cache_Batch, hw_RES);
 
 
 	#ifdef DEBUG_PRINT_SW_HW_RESULTS
@@ -466,7 +896,9 @@ int main(int argc, char* argv[])
 	// Step: Check Results
 	//       IMPORTANT: We compare only DEFINED_NB_OF_TESTS
 	// ============================================================================
+	Trace_Start = trace_now_us();
 	int Nb_Of_Errors = compare_results(sw_RES, hw_RES, DEFINED_NB_OF_TESTS, 5);
+	trace_host_phase("compare_results", Trace_Start);
 
 	if (Nb_Of_Errors == 0) {
 		cout << "HOST_Info: Test Passed" << endl;
@@ -480,30 +912,65 @@ int main(int argc, char* argv[])
 	// ============================================================================
     string HW_Out_File_Name = "HW_Res.txt";
     cout << "HOST-Info: Results stored in the " + HW_Out_File_Name + " file ..." << endl << endl;
+    Trace_Start = trace_now_us();
     store_results(SW_HW_Mode, HW_Out_File_Name, host_IN_DATA, hw_RES, &Test_Config);
+    trace_host_phase("store_results", Trace_Start);
 
 	// ============================================================================
 	// Step: Custom Profiling
+	//       (always run when the timeline trace is enabled: it exports the events)
 	// ============================================================================
-    if (((emulation_mode != NULL) && strcmp(Print_Custom_Profiling,"yes") == 0) || (emulation_mode == NULL)) {
+    if (((emulation_mode != NULL) && strcmp(Print_Custom_Profiling,"yes") == 0) || (emulation_mode == NULL) || trace_enabled()) {
 
 		cout << "HOST-Info: ============================================================= " << endl;
 		cout << "HOST-Info: Step: Profiling                                        " << endl;
 		cout << "HOST-Info: ============================================================= " << endl;
-		int Nb_Of_Kernels = (SW_HW_Config).NB_OF_KERNELS;
+		int Nb_Of_Kernels = NB_OF_EXE_EVENTS;
 		int Nb_Of_Memory_Tranfers = NB_OF_MEM_RD_EVENTS + NB_OF_MEM_WR_EVENTS;
 
-		string TMP_List_OF_Kernel_Names[(SW_HW_Config).NB_OF_KERNELS];
-		for (int i=0; i<(SW_HW_Config).NB_OF_KERNELS; i++) TMP_List_OF_Kernel_Names[i] = HW_Kernels[i].name;
+		string TMP_List_OF_Kernel_Names[NB_OF_EXE_EVENTS];
+		for (int i=0; i<NB_OF_EXE_EVENTS; i++)
+			TMP_List_OF_Kernel_Names[i] = HW_Kernels[i/(NB_OF_SLICES*(SW_HW_Config).NB_OF_CUs_PER_KERNEL)].name + "." + to_string(i%(NB_OF_SLICES*(SW_HW_Config).NB_OF_CUs_PER_KERNEL));
 
 		cl_event *Mem_op_event = new cl_event[Nb_Of_Memory_Tranfers];
 		for (int i=0; i<NB_OF_MEM_RD_EVENTS; i++) 	Mem_op_event[i]                     = Mem_rd_event[i];
 		for (int i=0; i<NB_OF_MEM_WR_EVENTS; i++) 	Mem_op_event[NB_OF_MEM_RD_EVENTS+i] = Mem_wr_event[i];
 
-		double Kernels_EXE_Time = run_custom_profiling (Nb_Of_Kernels,Nb_Of_Memory_Tranfers,K_exe_event,Mem_op_event,TMP_List_OF_Kernel_Names);
+		// Trace tracks: one per CU (K_exe_event[Slice_Indx*NB_OF_CUs_PER_KERNEL + cu]) and one per memory bank
+		string *Transfer_Names = new string[Nb_Of_Memory_Tranfers];
+		string *Trace_Tracks   = new string[Nb_Of_Kernels + Nb_Of_Memory_Tranfers];
+		for (int i=0; i<NB_OF_EXE_EVENTS; i++)
+			Trace_Tracks[i] = HW_Kernels[i/(NB_OF_SLICES*(SW_HW_Config).NB_OF_CUs_PER_KERNEL)].name + " CU" + to_string(i%(SW_HW_Config).NB_OF_CUs_PER_KERNEL);
+		for (int i=0; i<NB_OF_MEM_RD_EVENTS; i++) {
+			string Slice_Name = HW_Kernels[i/NB_OF_SLICES].name + ".Slice[" + to_string(i%NB_OF_SLICES) + "]";
+			Transfer_Names[i]                     = "G->H " + Slice_Name;
+			Transfer_Names[NB_OF_MEM_RD_EVENTS+i] = "H->G " + Slice_Name;
+			Trace_Tracks[Nb_Of_Kernels+i]                     = (SW_HW_Config).MEM_BANK[i/NB_OF_SLICES];
+			Trace_Tracks[Nb_Of_Kernels+NB_OF_MEM_RD_EVENTS+i] = (SW_HW_Config).MEM_BANK[i/NB_OF_SLICES];
+		}
+
+		double Kernels_EXE_Time = run_custom_profiling (Nb_Of_Kernels,Nb_Of_Memory_Tranfers,K_exe_event,Mem_op_event,TMP_List_OF_Kernel_Names,Transfer_Names,Trace_Tracks);
+		delete[] Transfer_Names;
+		delete[] Trace_Tracks;
+
+		// Per-bank bandwidth: Mem_op_event[k*NB_OF_SLICES+s] reads the results of slice s of kernel k, the write events follow
+		int    *Transfer_Kernel = new int[Nb_Of_Memory_Tranfers];
+		size_t *Transfer_Bytes  = new size_t[Nb_Of_Memory_Tranfers];
+		for (int i=0; i<NB_OF_MEM_RD_EVENTS; i++) {
+			int Nb_Of_Test_Vectors = Slices[i%NB_OF_SLICES].Nb_Of_Test_Vectors;
+			Transfer_Kernel[i]                     = i/NB_OF_SLICES;
+			Transfer_Bytes[i]                      = Nb_Of_Test_Vectors * sizeof(float);
+			Transfer_Kernel[NB_OF_MEM_RD_EVENTS+i] = i/NB_OF_SLICES;
+			Transfer_Bytes[NB_OF_MEM_RD_EVENTS+i]  = Nb_Of_Test_Vectors * sizeof(t_in_option) + Slice_Trees[i] * sizeof(t_tree_params);
+		}
+		print_mem_bank_bandwidth(&SW_HW_Config, Nb_Of_Memory_Tranfers, Mem_op_event, Transfer_Kernel, Transfer_Bytes);
+		delete[] Transfer_Kernel;
+		delete[] Transfer_Bytes;
+
 		cout << "HOST-Info:     NUMBER_OF_KERNELS      :  " << right << setw(10) << (SW_HW_Config).NB_OF_KERNELS << endl;
 		cout << "HOST-Info:     NB_OF_TESTS            :  " << right << setw(10) << DEFINED_NB_OF_TESTS << endl;
 		cout << "HOST-Info:     HW Execution Time (ms) :  " << right << setw(10) << fixed << setprecision(1) << Kernels_EXE_Time << endl;
+		print_result_cache_stats(Result_Cache);
 		cout << "HOST-Info: " << string(62, '-') << endl;
     }
 
@@ -522,9 +989,16 @@ int main(int argc, char* argv[])
 		clReleaseEvent(K_exe_event[event_index]);
 
 	for (int i=0; i<(SW_HW_Config).NB_OF_KERNELS; i++) {
-		clReleaseMemObject(HW_Kernels[i].GlobMem_IBuf);
-		clReleaseMemObject(HW_Kernels[i].GlobMem_OBuf);
+		for (int b=0; b<NB_OF_SLOTS; b++) {
+			clReleaseMemObject(HW_Kernels[i].Slot[b].GlobMem_IBuf);
+			clReleaseMemObject(HW_Kernels[i].Slot[b].GlobMem_TBuf);
+			clReleaseMemObject(HW_Kernels[i].Slot[b].GlobMem_OBuf);
+			clReleaseMemObject(HW_Kernels[i].Slot[b].GlobMem_CBuf);
+		}
+		delete[] HW_Kernels[i].Slot;
 	}
+	delete[] Slices;
+	delete[] Slice_Trees;
 
 	for (int i=0; i<(SW_HW_Config).NB_OF_KERNELS; i++) {
 		clReleaseKernel(HW_Kernels[i].kernel);
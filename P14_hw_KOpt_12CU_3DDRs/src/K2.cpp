@@ -19,34 +19,135 @@
 #include "kernel.h"
 #include "math.h"
 
+#ifdef SW_OCL_BACKEND
+#include "hls_stream_sw.h"    // plain C++ build of the kernels
+#else
+#include "hls_stream.h"
+#endif
+
 // ============================================================================================================ //
 // ------------------------------------------------------------------------------------------------------------ //
 //                                              HW Implementation
 // ------------------------------------------------------------------------------------------------------------ //
 // ============================================================================================================ //
 
-float hw_calc_p0_2 (t_in_data in_d) {
+// ---------------------------------------------------------------------------------
+// Trees taller than CONST_MAX_TREE_HEIGHT
+//   o) the p column (n values) is stored in Col (Global Memory)
+//   o) rows are calculated in bands of CONST_TILE_HEIGHT rows, each band
+//      in tiles of CONST_TILE_WIDTH values from left to right
+//   o) in the row j = J-s, the tile starting at a updates
+//      p[a-s ... a+CONST_TILE_WIDTH-s-1], therefore the tile only reads and
+//      writes Col[a-H+1 ... a+CONST_TILE_WIDTH]. This range is copied to the
+//      p BRAM buffer, calculated in place and copied back.
+//   o) the nodes of a tile use the exponents 2*i - j = [k_lo ... k_hi]: their
+//      exercise values are calculated once per tile in exercise_lut
+// ---------------------------------------------------------------------------------
+float hw_calc_p0_tiled_2 (float p[CONST_MAX_TREE_HEIGHT], float exercise_lut[CONST_EXERCISE_LUT_SIZE], float* Col, float S, float K, int n, float up, float p0, float p1) {
+    #pragma HLS INLINE
+
+    float exercise;
+
+    loop_init_col: for (int i = 0; i < n; i++) {
+        #pragma HLS LOOP_TRIPCOUNT min=4096 max=4096 avg=4096
+        #pragma HLS PIPELINE
+
+        float p_i = K - S * powf(up,(2*i - n)); // up^(2*i - n)
+        if (p_i < 0) p_i = 0;
+        Col[i] = p_i;
+    }
+
+    loop_band: for (int J = n-1; J > 0; J -= CONST_TILE_HEIGHT) {
+        #pragma HLS LOOP_TRIPCOUNT min=16 max=16 avg=16
+
+        int H = (J < CONST_TILE_HEIGHT) ? J : CONST_TILE_HEIGHT;
+
+        loop_tile: for (int a = 0; a < J; a += CONST_TILE_WIDTH) {
+            #pragma HLS LOOP_TRIPCOUNT min=3 max=3 avg=3
+
+            int col_lo = (a - H + 1 > 0) ? (a - H + 1) : 0;
+            int col_hi = (a + CONST_TILE_WIDTH < J) ? (a + CONST_TILE_WIDTH + 1) : (J + 1);
+
+            loop_rd_tile: for (int x = 0; x < col_hi - col_lo; x++) {
+                #pragma HLS LOOP_TRIPCOUNT min=1024 max=1024 avg=1024
+                #pragma HLS PIPELINE
+                p[x] = Col[col_lo + x];
+            }
+
+            // i = [col_lo ... col_hi-2], j = [J-H+1 ... J]
+            int k_lo = 2*col_lo - J;
+            int k_hi = 2*(col_hi - 2) - (J - H + 1);
+
+            loop_tile_lut: for (int k = k_lo; k <= k_hi; k++) {
+                #pragma HLS LOOP_TRIPCOUNT min=2300 max=2300 avg=2300
+                #pragma HLS PIPELINE
+                exercise_lut[k - k_lo] = K - S * powf(up,k); // up^k
+            }
+
+            loop_s: for (int s = 0; s < H; s++) {
+                #pragma HLS LOOP_TRIPCOUNT min=256 max=256 avg=256
+
+                int j  = J - s;
+                int lo = (a - s > 0) ? (a - s) : 0;
+                int hi = (a + CONST_TILE_WIDTH - s < j) ? (a + CONST_TILE_WIDTH - s) : j;
+
+                loop_tile_i: for (int i = lo; i < hi; i++) {
+                    #pragma HLS LOOP_TRIPCOUNT min=768 max=768 avg=768
+
+                    p[i-col_lo] = p0 * p[i-col_lo+1] + p1 * p[i-col_lo];  // binomial value
+                    exercise = exercise_lut[2*i - j - k_lo];                // exercise value // up^(2*i - j)
+                    if (p[i-col_lo] < exercise) p[i-col_lo] = exercise;
+                }
+            }
+
+            loop_wr_tile: for (int x = 0; x < col_hi - col_lo; x++) {
+                #pragma HLS LOOP_TRIPCOUNT min=1024 max=1024 avg=1024
+                #pragma HLS PIPELINE
+                Col[col_lo + x] = p[x];
+            }
+        }
+    }
+
+    return(Col[0]);
+}
+
+float hw_calc_p0_2 (t_in_option in_o, t_tree_params in_t, float* Col) {
     #pragma HLS INLINE off
-	#pragma HLS DATA_PACK variable=in_d
+	#pragma HLS DATA_PACK variable=in_o
+	#pragma HLS DATA_PACK variable=in_t
 
     float p[CONST_MAX_TREE_HEIGHT];
+    float exercise_lut[CONST_EXERCISE_LUT_SIZE];
+    // Not partitioned: loop_i (UNROLL factor=2) reads 2 values per cycle, one per BRAM port (see kernel.h for the size)
+    #pragma HLS RESOURCE variable=exercise_lut core=RAM_2P_BRAM
 
-    int T; float S; float K; float r; float sigma; float q; int n;
-    float deltaT, up, p0, p1, exercise;
+    float S; float K; int n;
+    float up, p0, p1, exercise;
 
     // -------------------------------
-    // in_d -> individual variables
+    // in_o, in_t -> individual variables
+    // (up, p0 and p1 are calculated by
+    // the Host once per tree)
     // -------------------------------
-    T = in_d.T; S = in_d.S; K = in_d.K; r = in_d.r; sigma = in_d.sigma; q = in_d.q; n = in_d.n;
+    S = in_o.S; K = in_o.K; n = in_t.n; up = in_t.up; p0 = in_t.p0; p1 = in_t.p1;
 
     // -------------------------------
     // Start Calculation
     // -------------------------------
-    deltaT = (float) T / n;
-    up = expf(sigma * sqrtf(deltaT));
+    if (n > CONST_MAX_TREE_HEIGHT) return(hw_calc_p0_tiled_2(p, exercise_lut, Col, S, K, n, up, p0, p1));
 
-    p0 = (up*expf(-q * deltaT) - expf(-r * deltaT)) / (powf(up,2) - 1); // up^2
-    p1 = expf(-r * deltaT) - p0;
+    // -------------------------------
+    // exercise values K - S * up^(2*i - j)
+    // only depend on 2*i - j (-n ... n):
+    // 2n+1 powf per tree instead of one
+    // per node, read from BRAM below
+    // -------------------------------
+    loop_exercise_lut: for (int k = 0; k <= 2*n; k++) {
+        #pragma HLS LOOP_TRIPCOUNT min=201 max=201 avg=201
+        #pragma HLS PIPELINE
+
+        exercise_lut[k] = K - S * powf(up,(k - n)); // up^(k - n)
+    }
 
     // -------------------------------
     // initial values at time T
@@ -55,7 +156,7 @@ float hw_calc_p0_2 (t_in_data in_d) {
         #pragma HLS LOOP_TRIPCOUNT min=100 max=100 avg=100
 		#pragma HLS UNROLL factor=2
 
-        p[i] = K - S * powf(up,(2*i - n)); // up^(2*i - n)
+        p[i] = exercise_lut[2*i]; // up^(2*i - n)
         if (p[i] < 0) p[i] = 0;
     }
 
@@ -70,7 +171,7 @@ float hw_calc_p0_2 (t_in_data in_d) {
 			#pragma HLS UNROLL factor=2
 
             p[i] = p0 * p[i+1] + p1 * p[i];        // binomial value
-            exercise = K - S * powf(up,(2*i - j));  // exercise value // up^(2*i - j)
+            exercise = exercise_lut[2*i - j + n];   // exercise value // up^(2*i - j)
             if (p[i] < exercise) p[i] = exercise;
         }
     }
@@ -82,45 +183,73 @@ float hw_calc_p0_2 (t_in_data in_d) {
 // ================================================================================ //
 
 extern "C" {
-void K_americanPut_2(t_in_data* IN_Data, float* Res,
-                     int Nb_of_Tests, int Start_Index ) {
+void K_americanPut_2(t_in_option* IN_Option, t_tree_params* IN_Tree, float* Res,
+                     int Nb_of_Tests, int Start_Index,
+                     float* Col, int Col_Base, int Col_Stride ) {
 
     // ---------------------------------------------------------------------------- //
-	#pragma HLS INTERFACE s_axilite port=IN_Data        bundle=control
+	#pragma HLS INTERFACE s_axilite port=IN_Option      bundle=control
+	#pragma HLS INTERFACE s_axilite port=IN_Tree        bundle=control
 	#pragma HLS INTERFACE s_axilite port=Res            bundle=control
 	#pragma HLS INTERFACE s_axilite port=Nb_of_Tests    bundle=control
 	#pragma HLS INTERFACE s_axilite port=Start_Index    bundle=control
+	#pragma HLS INTERFACE s_axilite port=Col            bundle=control
+	#pragma HLS INTERFACE s_axilite port=Col_Base       bundle=control
+	#pragma HLS INTERFACE s_axilite port=Col_Stride     bundle=control
 	#pragma HLS INTERFACE s_axilite port=return         bundle=control
 
-	#pragma HLS INTERFACE m_axi port=IN_Data            offset=slave bundle=gmem_0
+	#pragma HLS INTERFACE m_axi port=IN_Option          offset=slave bundle=gmem_0
+	#pragma HLS INTERFACE m_axi port=IN_Tree            offset=slave bundle=gmem_3
 	#pragma HLS INTERFACE m_axi port=Res                offset=slave bundle=gmem_1
+	#pragma HLS INTERFACE m_axi port=Col                offset=slave bundle=gmem_2
 
-	#pragma HLS DATA_PACK variable=IN_Data
+	#pragma HLS DATA_PACK variable=IN_Option
+	#pragma HLS DATA_PACK variable=IN_Tree
 	// ---------------------------------------------------------------------------- //
 
-    t_in_data  tmp_IN_Data[CONST_MAX_NB_OF_TESTS];
-    #pragma HLS DATA_PACK variable=tmp_IN_Data
-    #pragma HLS ARRAY_PARTITION variable=tmp_IN_Data cyclic factor=2 dim=1
+    t_in_option   tmp_IN_Option[CONST_MAX_NB_OF_TESTS];
+    #pragma HLS DATA_PACK variable=tmp_IN_Option
+    #pragma HLS ARRAY_PARTITION variable=tmp_IN_Option cyclic factor=CONST_PARTITION_FACTOR dim=1
+
+    t_tree_params tmp_IN_Tree[CONST_MAX_NB_OF_TESTS];
+    #pragma HLS DATA_PACK variable=tmp_IN_Tree
+    #pragma HLS ARRAY_PARTITION variable=tmp_IN_Tree   cyclic factor=CONST_PARTITION_FACTOR dim=1
 
-    float      tmp_Res[CONST_MAX_NB_OF_TESTS];
-    #pragma HLS ARRAY_PARTITION variable=tmp_Res     cyclic factor=2 dim=1
+    float         tmp_Res[CONST_MAX_NB_OF_TESTS];
+    #pragma HLS ARRAY_PARTITION variable=tmp_Res       cyclic factor=CONST_PARTITION_FACTOR dim=1
 
     // -------------------------------------
     // Transfer data: Global Memory -> BRAM
+    // (the tests of a tree are consecutive:
+    // IN_Tree is only read when the tree
+    // index changes)
     // -------------------------------------
-    read_in_data_loop: for (int i = 0; i < Nb_of_Tests; i++)
+    t_tree_params Tree       = {0, 0.0f, 0.0f, 0.0f};
+    int           Tree_Index = -1;
+
+    read_in_data_loop: for (int i = 0; i < Nb_of_Tests; i++) {
         #pragma HLS LOOP_TRIPCOUNT min=100 max=100 avg=100
-        tmp_IN_Data[i] = IN_Data[Start_Index+i];
+        t_in_option Option = IN_Option[Start_Index+i];
+        if (Option.Tree != Tree_Index) {
+            Tree       = IN_Tree[Option.Tree];
+            Tree_Index = Option.Tree;
+        }
+        tmp_IN_Option[i] = Option;
+        tmp_IN_Tree[i]   = Tree;
+    }
 
     // -------------------------------------
     // Calculate
     // -------------------------------------
-    calcualte_i: for (int i = 0; i < Nb_of_Tests/4; i++) {
+    //   (the functions without a test in the last group price the first test of the group,
+    //    their results are not written back)
+    calcualte_i: for (int i = 0; i < (Nb_of_Tests + CONST_NB_OF_PARALLEL_FUNCTIONS - 1)/CONST_NB_OF_PARALLEL_FUNCTIONS; i++) {
         #pragma HLS LOOP_TRIPCOUNT min=25 max=25 avg=25
 
-        calcualte_sub_i: for (int sub_i = 0; sub_i < 4; sub_i++) {
+        calcualte_sub_i: for (int sub_i = 0; sub_i < CONST_NB_OF_PARALLEL_FUNCTIONS; sub_i++) {
             #pragma HLS UNROLL
-            tmp_Res[ i*4 + sub_i ] = hw_calc_p0_2(tmp_IN_Data[ i*4 + sub_i ]);
+            int indx = (i*CONST_NB_OF_PARALLEL_FUNCTIONS + sub_i < Nb_of_Tests) ? i*CONST_NB_OF_PARALLEL_FUNCTIONS + sub_i : i*CONST_NB_OF_PARALLEL_FUNCTIONS;
+            tmp_Res[ i*CONST_NB_OF_PARALLEL_FUNCTIONS + sub_i ] = hw_calc_p0_2(tmp_IN_Option[ indx ], tmp_IN_Tree[ indx ], &Col[Col_Base + sub_i*Col_Stride]);
         }
     }
 
@@ -135,6 +264,123 @@ void K_americanPut_2(t_in_data* IN_Data, float* Res,
 }
 
 
+// ================================================================================ //
+// Dataflow variant
+//   read -> calculate -> write processes connected by streams: the AXI reads and
+//   writes overlap the calculation and the test vectors are not staged in BRAM,
+//   so Nb_of_Tests is not limited by CONST_MAX_NB_OF_TESTS.
+//   Nb_of_Tests may be any value: in the last group of CONST_NB_OF_PARALLEL_FUNCTIONS
+//   tests, the functions without a test price a copy of the first test of the group
+//   and their results are not written, so every stream is read exactly Nb_of_Tests times.
+// ================================================================================ //
+
+// The tests of a tree are consecutive: IN_Tree is only read when the tree index changes
+void df_read_2 (t_in_option* IN_Option, t_tree_params* IN_Tree, int Nb_of_Tests, int Start_Index,
+                hls::stream<t_in_option>& IN_Stream, hls::stream<t_tree_params>& Tree_Stream) {
+
+    t_tree_params Tree       = {0, 0.0f, 0.0f, 0.0f};
+    int           Tree_Index = -1;
+
+    df_read_loop: for (int i = 0; i < Nb_of_Tests; i++) {
+        #pragma HLS LOOP_TRIPCOUNT min=100 max=100 avg=100
+        #pragma HLS PIPELINE II=1
+        t_in_option Option = IN_Option[Start_Index+i];
+        if (Option.Tree != Tree_Index) {
+            Tree       = IN_Tree[Option.Tree];
+            Tree_Index = Option.Tree;
+        }
+        IN_Stream.write(Option);
+        Tree_Stream.write(Tree);
+    }
+}
+
+void df_calculate_2 (hls::stream<t_in_option>& IN_Stream, hls::stream<t_tree_params>& Tree_Stream, hls::stream<float>& Res_Stream, int Nb_of_Tests,
+                     float* Col, int Col_Base, int Col_Stride) {
+
+    df_calculate_i: for (int i = 0; i < (Nb_of_Tests + CONST_NB_OF_PARALLEL_FUNCTIONS - 1)/CONST_NB_OF_PARALLEL_FUNCTIONS; i++) {
+        #pragma HLS LOOP_TRIPCOUNT min=25 max=25 avg=25
+
+        int Nb_Of_Valid = Nb_of_Tests - i*CONST_NB_OF_PARALLEL_FUNCTIONS;   // < CONST_NB_OF_PARALLEL_FUNCTIONS in the last group only
+
+        t_in_option in_o[CONST_NB_OF_PARALLEL_FUNCTIONS];
+        #pragma HLS DATA_PACK variable=in_o
+        #pragma HLS ARRAY_PARTITION variable=in_o complete dim=1
+
+        t_tree_params in_t[CONST_NB_OF_PARALLEL_FUNCTIONS];
+        #pragma HLS DATA_PACK variable=in_t
+        #pragma HLS ARRAY_PARTITION variable=in_t complete dim=1
+
+        float res[CONST_NB_OF_PARALLEL_FUNCTIONS];
+        #pragma HLS ARRAY_PARTITION variable=res  complete dim=1
+
+        df_rd_sub_i: for (int sub_i = 0; sub_i < CONST_NB_OF_PARALLEL_FUNCTIONS; sub_i++) {
+            #pragma HLS PIPELINE II=1
+            if (sub_i < Nb_Of_Valid) { in_o[sub_i] = IN_Stream.read(); in_t[sub_i] = Tree_Stream.read(); }
+            else                     { in_o[sub_i] = in_o[0];          in_t[sub_i] = in_t[0]; }
+        }
+
+        df_calculate_sub_i: for (int sub_i = 0; sub_i < CONST_NB_OF_PARALLEL_FUNCTIONS; sub_i++) {
+            #pragma HLS UNROLL
+            res[sub_i] = hw_calc_p0_2(in_o[sub_i], in_t[sub_i], &Col[Col_Base + sub_i*Col_Stride]);
+        }
+
+        df_wr_sub_i: for (int sub_i = 0; sub_i < CONST_NB_OF_PARALLEL_FUNCTIONS; sub_i++) {
+            #pragma HLS PIPELINE II=1
+            if (sub_i < Nb_Of_Valid) Res_Stream.write(res[sub_i]);
+        }
+    }
+}
+
+void df_write_2 (hls::stream<float>& Res_Stream, float* Res, int Nb_of_Tests, int Start_Index) {
+
+    df_write_loop: for (int i = 0; i < Nb_of_Tests; i++) {
+        #pragma HLS LOOP_TRIPCOUNT min=100 max=100 avg=100
+        #pragma HLS PIPELINE II=1
+        Res[Start_Index+i] = Res_Stream.read();
+    }
+}
+
+extern "C" {
+void K_americanPut_df_2(t_in_option* IN_Option, t_tree_params* IN_Tree, float* Res,
+                        int Nb_of_Tests, int Start_Index,
+                        float* Col, int Col_Base, int Col_Stride ) {
+
+    // ---------------------------------------------------------------------------- //
+	#pragma HLS INTERFACE s_axilite port=IN_Option      bundle=control
+	#pragma HLS INTERFACE s_axilite port=IN_Tree        bundle=control
+	#pragma HLS INTERFACE s_axilite port=Res            bundle=control
+	#pragma HLS INTERFACE s_axilite port=Nb_of_Tests    bundle=control
+	#pragma HLS INTERFACE s_axilite port=Start_Index    bundle=control
+	#pragma HLS INTERFACE s_axilite port=Col            bundle=control
+	#pragma HLS INTERFACE s_axilite port=Col_Base       bundle=control
+	#pragma HLS INTERFACE s_axilite port=Col_Stride     bundle=control
+	#pragma HLS INTERFACE s_axilite port=return         bundle=control
+
+	#pragma HLS INTERFACE m_axi port=IN_Option          offset=slave bundle=gmem_0
+	#pragma HLS INTERFACE m_axi port=IN_Tree            offset=slave bundle=gmem_3
+	#pragma HLS INTERFACE m_axi port=Res                offset=slave bundle=gmem_1
+	#pragma HLS INTERFACE m_axi port=Col                offset=slave bundle=gmem_2
+
+	#pragma HLS DATA_PACK variable=IN_Option
+	#pragma HLS DATA_PACK variable=IN_Tree
+	// ---------------------------------------------------------------------------- //
+
+    #pragma HLS DATAFLOW
 
+    hls::stream<t_in_option>   IN_Stream("IN_Stream");
+    #pragma HLS STREAM variable=IN_Stream   depth=CONST_DF_STREAM_DEPTH
+    #pragma HLS DATA_PACK variable=IN_Stream
 
+    hls::stream<t_tree_params> Tree_Stream("Tree_Stream");
+    #pragma HLS STREAM variable=Tree_Stream depth=CONST_DF_STREAM_DEPTH
+    #pragma HLS DATA_PACK variable=Tree_Stream
 
+    hls::stream<float>         Res_Stream("Res_Stream");
+    #pragma HLS STREAM variable=Res_Stream  depth=CONST_DF_STREAM_DEPTH
+
+    df_read_2      (IN_Option, IN_Tree, Nb_of_Tests, Start_Index, IN_Stream, Tree_Stream);
+    df_calculate_2 (IN_Stream, Tree_Stream, Res_Stream, Nb_of_Tests, Col, Col_Base, Col_Stride);
+    df_write_2     (Res_Stream, Res, Nb_of_Tests, Start_Index);
+
+}
+}
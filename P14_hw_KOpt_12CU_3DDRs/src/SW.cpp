@@ -19,6 +19,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <thread>
+#include <vector>
+#include <algorithm>
 
 #include "kernel.h"
 #include "help_functions.h"
@@ -31,6 +33,8 @@
 // ------------------------------------------------------------------------------------------------------------ //
 // ============================================================================================================ //
 
+float sw_calc_p0_tiled(int T, float S, float K, float r, float sigma, float q, int n);
+
 float sw_calc_p0(int T, float S, float K, float r, float sigma, float q, int n) {
 	//    T... expiration time
 	//    S... stock price
@@ -41,6 +45,8 @@ float sw_calc_p0(int T, float S, float K, float r, float sigma, float q, int n)
 	float deltaT, up, p0, p1, exercise;
 	float p[CONST_MAX_TREE_HEIGHT];
 
+	if (n > CONST_MAX_TREE_HEIGHT) return sw_calc_p0_tiled(T, S, K, r, sigma, q, n);
+
 	deltaT = (float) T / n;
 	up = expf(sigma * sqrtf(deltaT));
 
@@ -66,6 +72,62 @@ float sw_calc_p0(int T, float S, float K, float r, float sigma, float q, int n)
 }
 
 
+// ============================================================================================================ //
+// ------------------------------------------------------------------------------------------------------------ //
+//                                      SW MODEL - Tiled Backward Induction
+// ------------------------------------------------------------------------------------------------------------ //
+// ============================================================================================================ //
+// Used for trees taller than CONST_MAX_TREE_HEIGHT. The p column (n values) is kept in heap memory and the
+// triangle is processed in bands of CONST_TILE_HEIGHT rows, each band in tiles of CONST_TILE_WIDTH values
+// processed from left to right. In the row j = J-s of a band, the tile starting at a updates p[a-s ... a+W-s-1],
+// therefore the rows of a tile are calculated in place (same scheme as in the kernels).
+// Every node is calculated with the same operations as in sw_calc_p0.
+// ============================================================================================================ //
+float sw_calc_p0_tiled(int T, float S, float K, float r, float sigma, float q, int n) {
+	static thread_local vector<float> Col;        // p column, reused by all options priced by a thread
+
+	float deltaT, up, p0, p1, exercise;
+
+	if ((int)Col.size() < n) Col.resize(n);
+	float* p = Col.data();
+
+	deltaT = (float) T / n;
+	up = expf(sigma * sqrtf(deltaT));
+
+	p0 = (up*expf(-q * deltaT) - expf(-r * deltaT)) / (powf(up,2) - 1); // up^2
+	p1 = expf(-r * deltaT) - p0;
+
+	// initial values at time T
+	for (int i = 0; i < n; i++) {
+		p[i] = K - S * powf(up,(2*i - n)); // up^(2*i - n)
+		if (p[i] < 0) p[i] = 0;
+	}
+
+	// move to earlier times: bands of rows J ... J-H+1
+	for (int J = n-1; J > 0; ) {
+		int H = min(CONST_TILE_HEIGHT, J);
+
+		for (int a = 0; a < J; a += CONST_TILE_WIDTH) {
+			for (int s = 0; s < H; s++) {
+				int j  = J - s;
+				int lo = max(0, a - s);
+				int hi = min(j, a + CONST_TILE_WIDTH - s);
+
+				for (int i = lo; i < hi; i++) {
+					p[i] = p0 * p[i+1] + p1 * p[i];         // binomial value
+					exercise = K - S * powf(up,(2*i - j));  // exercise value // up^(2*i - j)
+					if (p[i] < exercise) p[i] = exercise;
+				}
+			}
+		}
+
+		J -= H;
+	}
+
+	return (p[0]);
+}
+
+
 // ============================================================================================================ //
 // ------------------------------------------------------------------------------------------------------------ //
 //                               SW MODEL - Multi-threading Implementation
@@ -85,8 +147,10 @@ void K_americanPut_sw_model(t_in_data* host_IN_DATA, float* sw_RES, int NB_OF_TE
 	int Nb_of_Test_Vectors_per_Task = NB_OF_TESTS/Nb_Of_Threads;
 	thread* t = new thread[Nb_Of_Threads];
 
+	// The last thread also prices the remaining NB_OF_TESTS % Nb_Of_Threads tests
 	for (int i=0; i<Nb_Of_Threads; i++) {
-		t[i] = thread(K_americanPut_sw_model_task, host_IN_DATA, sw_RES, Nb_of_Test_Vectors_per_Task, i*Nb_of_Test_Vectors_per_Task);
+		int Nb_Of_Tests = (i == Nb_Of_Threads-1) ? NB_OF_TESTS - i*Nb_of_Test_Vectors_per_Task : Nb_of_Test_Vectors_per_Task;
+		t[i] = thread(K_americanPut_sw_model_task, host_IN_DATA, sw_RES, Nb_Of_Tests, i*Nb_of_Test_Vectors_per_Task);
 	}
 
 	for (int i=0; i<Nb_Of_Threads; i++) {
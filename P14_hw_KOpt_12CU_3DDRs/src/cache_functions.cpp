@@ -0,0 +1,270 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace std;
+
+#include "help_functions.h"
+#include "cache_functions.h"
+
+static t_result_cache_key result_cache_key(const t_in_data* IN_DATA) {
+	t_result_cache_key Key;
+
+	memcpy(&Key.Word[0], &IN_DATA->T,     4);
+	memcpy(&Key.Word[1], &IN_DATA->S,     4);
+	memcpy(&Key.Word[2], &IN_DATA->K,     4);
+	memcpy(&Key.Word[3], &IN_DATA->r,     4);
+	memcpy(&Key.Word[4], &IN_DATA->sigma, 4);
+	memcpy(&Key.Word[5], &IN_DATA->q,     4);
+	memcpy(&Key.Word[6], &IN_DATA->n,     4);
+	return Key;
+}
+
+// 64-bit mix of the key words (the top bits select the shard, the map uses all of them)
+size_t t_result_cache_key_hash::operator()(const t_result_cache_key& Key) const {
+	uint64_t h = 0x9E3779B97F4A7C15ULL;
+	for (int i=0; i<RESULT_CACHE_KEY_WORDS; i++) {
+		h ^= Key.Word[i];
+		h *= 0xFF51AFD7ED558CCDULL;
+		h ^= h >> 32;
+	}
+	return (size_t)h;
+}
+
+bool t_result_cache_key_equal::operator()(const t_result_cache_key& a, const t_result_cache_key& b) const {
+	return (memcmp(a.Word, b.Word, sizeof(a.Word)) == 0);
+}
+
+static t_result_cache_shard* result_cache_shard(t_result_cache* Cache, size_t Hash) {
+	return &Cache->Shards[(Hash >> 58) % Cache->Nb_Of_Shards];
+}
+
+
+// ============================================================================
+// Capacity: BINOMIAL_RESULT_CACHE environment variable (number of results)
+// ============================================================================
+size_t result_cache_capacity() {
+	char* Value = getenv("BINOMIAL_RESULT_CACHE");
+	if ((Value == NULL) || (Value[0] == '\0')) return 0;
+
+	char* End;
+	long long Capacity = strtoll(Value, &End, 10);
+	if ((End == Value) || (*End != '\0') || (Capacity < 0)) {
+		cout << endl << "HOST-Error: Incorrect value BINOMIAL_RESULT_CACHE=" << Value << " (number of results expected)" << endl << endl;
+		exit(1);
+	}
+	return (size_t)Capacity;
+}
+
+void result_cache_init(t_result_cache* Cache, size_t Capacity) {
+	Cache->Capacity     = Capacity;
+	Cache->Nb_Of_Shards = (int)max((size_t)1, min((size_t)RESULT_CACHE_NB_OF_SHARDS, Capacity));
+	Cache->Hits         = 0;
+	Cache->Misses       = 0;
+	Cache->Evictions    = 0;
+
+	// Capacity split over the shards: the first Capacity % Nb_Of_Shards shards hold one more result
+	for (int i=0; i<RESULT_CACHE_NB_OF_SHARDS; i++) {
+		t_result_cache_shard* Shard = &Cache->Shards[i];
+
+		Shard->Entries.clear();
+		Shard->Index.clear();
+		Shard->Hand     = 0;
+		Shard->Capacity = (i < Cache->Nb_Of_Shards) ? Capacity / Cache->Nb_Of_Shards + (((size_t)i < Capacity % Cache->Nb_Of_Shards) ? 1 : 0) : 0;
+		if (Shard->Capacity > 0) {
+			Shard->Entries.reserve(Shard->Capacity);
+			Shard->Index.reserve(Shard->Capacity);
+		}
+	}
+}
+
+bool result_cache_enabled(t_result_cache* Cache) {
+	return (Cache->Capacity > 0);
+}
+
+static bool result_cache_lookup_key(t_result_cache* Cache, const t_result_cache_key& Key, float* RES) {
+	size_t                Hash  = t_result_cache_key_hash()(Key);
+	t_result_cache_shard* Shard = result_cache_shard(Cache, Hash);
+
+	lock_guard<mutex> Lock(Shard->Mutex);
+
+	auto it = Shard->Index.find(Key);
+	if (it == Shard->Index.end()) {
+		Cache->Misses ++;
+		return false;
+	}
+
+	t_result_cache_entry* Entry = &Shard->Entries[it->second];
+	Entry->Referenced = true;
+	*RES = Entry->Result;
+	Cache->Hits ++;
+	return true;
+}
+
+bool result_cache_lookup(t_result_cache* Cache, const t_in_data* IN_DATA, float* RES) {
+	return result_cache_lookup_key(Cache, result_cache_key(IN_DATA), RES);
+}
+
+void result_cache_insert(t_result_cache* Cache, const t_in_data* IN_DATA, float RES) {
+	t_result_cache_key    Key   = result_cache_key(IN_DATA);
+	size_t                Hash  = t_result_cache_key_hash()(Key);
+	t_result_cache_shard* Shard = result_cache_shard(Cache, Hash);
+
+	lock_guard<mutex> Lock(Shard->Mutex);
+
+	// Already cached (the same contract priced twice in a batch)
+	auto it = Shard->Index.find(Key);
+	if (it != Shard->Index.end()) {
+		Shard->Entries[it->second].Result = RES;
+		return;
+	}
+
+	// Shard not full yet
+	if (Shard->Entries.size() < Shard->Capacity) {
+		t_result_cache_entry Entry = {Key, RES, false};
+		Shard->Index[Key] = Shard->Entries.size();
+		Shard->Entries.push_back(Entry);
+		return;
+	}
+
+	// CLOCK: the hand skips (and clears) the entries read since it last passed
+	while (Shard->Entries[Shard->Hand].Referenced) {
+		Shard->Entries[Shard->Hand].Referenced = false;
+		Shard->Hand = (Shard->Hand + 1) % Shard->Entries.size();
+	}
+
+	t_result_cache_entry* Victim = &Shard->Entries[Shard->Hand];
+	Shard->Index.erase(Victim->Key);
+	Cache->Evictions ++;
+
+	Victim->Key        = Key;
+	Victim->Result     = RES;
+	Victim->Referenced = false;
+	Shard->Index[Key]  = Shard->Hand;
+	Shard->Hand        = (Shard->Hand + 1) % Shard->Entries.size();
+}
+
+void result_cache_gather(t_result_cache* Cache, t_in_data* IN_DATA, float* RES, int NB_OF_TESTS, int NB_OF_ROUNDED_TESTS, int Base, t_result_cache_batch* Batch) {
+	Batch->Miss_Index.clear();
+
+	if (!result_cache_enabled(Cache)) {
+		Batch->IN_DATA      = IN_DATA;
+		Batch->RES          = RES;
+		Batch->Nb_Of_Tests  = NB_OF_ROUNDED_TESTS;
+		Batch->Nb_Of_Misses = NB_OF_TESTS;
+		Batch->Gathered     = false;
+		return;
+	}
+
+	// ---------------------------------
+	// Lookup and gather the misses
+	// (a repeat of a miss is priced once)
+	// ---------------------------------
+	unordered_map<t_result_cache_key, int, t_result_cache_key_hash, t_result_cache_key_equal> Pending;   // Key -> miss
+
+	Batch->Dup_Index.clear();
+	for (int i=0; i<NB_OF_TESTS; i++) {
+		t_result_cache_key Key = result_cache_key(&IN_DATA[i]);
+
+		auto it = Pending.find(Key);
+		if (it != Pending.end()) {
+			Batch->Dup_Index.push_back(make_pair(i, it->second));
+			Cache->Hits ++;
+		} else if (!result_cache_lookup_key(Cache, Key, &RES[i])) {
+			Pending[Key] = Batch->Miss_Index.size();
+			Batch->Miss_Index.push_back(i);
+		}
+	}
+
+	Batch->Nb_Of_Misses = Batch->Miss_Index.size();
+	Batch->Nb_Of_Tests  = max(Base, ((Batch->Nb_Of_Misses + Base - 1) / Base) * Base);
+	Batch->IN_DATA      = allocate_host_mem<t_in_data>(Batch->Nb_Of_Tests,"Miss_IN_DATA",false);
+	Batch->RES          = allocate_host_mem<float>(Batch->Nb_Of_Tests,"Miss_RES",false);
+	Batch->Gathered     = true;
+
+	for (int i=0; i<Batch->Nb_Of_Misses; i++) Batch->IN_DATA[i] = IN_DATA[Batch->Miss_Index[i]];
+
+	// Rounding: copies of the last miss, or dummy tests when all tests hit (results not used)
+	t_in_data Dummy  = {1, 1, 1, 1, 1, 1, 1, 0.0f};
+	t_in_data Filler = (Batch->Nb_Of_Misses > 0) ? Batch->IN_DATA[Batch->Nb_Of_Misses-1] : Dummy;
+	for (int i=Batch->Nb_Of_Misses; i<Batch->Nb_Of_Tests; i++) Batch->IN_DATA[i] = Filler;
+}
+
+void result_cache_scatter(t_result_cache* Cache, t_result_cache_batch* Batch, float* RES) {
+	if (!Batch->Gathered) return;
+
+	for (int i=0; i<Batch->Nb_Of_Misses; i++) {
+		RES[Batch->Miss_Index[i]] = Batch->RES[i];
+		result_cache_insert(Cache, &Batch->IN_DATA[i], Batch->RES[i]);
+	}
+	for (size_t d=0; d<Batch->Dup_Index.size(); d++)
+		RES[Batch->Dup_Index[d].first] = Batch->RES[Batch->Dup_Index[d].second];
+
+	free(Batch->IN_DATA);
+	free(Batch->RES);
+	Batch->IN_DATA  = NULL;
+	Batch->RES      = NULL;
+	Batch->Gathered = false;
+}
+
+int result_cache_price(t_result_cache* Cache, t_in_data* IN_DATA, float* RES, int NB_OF_TESTS, const function<void(t_in_data*, float*, int)>& Price) {
+	t_result_cache_batch Batch;
+
+	if (!result_cache_enabled(Cache)) {
+		Price(IN_DATA, RES, NB_OF_TESTS);
+		return 0;
+	}
+
+	// ---------------------------------
+	// Price the misses, scatter and insert the results
+	// ---------------------------------
+	result_cache_gather(Cache, IN_DATA, RES, NB_OF_TESTS, NB_OF_TESTS, 1, &Batch);
+
+	if (Batch.Nb_Of_Misses > 0)
+		Price(Batch.IN_DATA, Batch.RES, Batch.Nb_Of_Misses);
+
+	result_cache_scatter(Cache, &Batch, RES);
+
+	return NB_OF_TESTS - Batch.Nb_Of_Misses;
+}
+
+void print_result_cache_stats(t_result_cache* Cache) {
+	if (!result_cache_enabled(Cache)) return;
+
+	uint64_t Hits    = Cache->Hits;
+	uint64_t Lookups = Hits + Cache->Misses;
+	size_t   Size    = 0;
+
+	for (int i=0; i<Cache->Nb_Of_Shards; i++) {
+		lock_guard<mutex> Lock(Cache->Shards[i].Mutex);
+		Size += Cache->Shards[i].Entries.size();
+	}
+
+	cout << "HOST-Info: Result Cache" << endl;
+	cout << "HOST-Info:     Capacity               :  " << right << setw(10) << Cache->Capacity << endl;
+	cout << "HOST-Info:     Cached Results         :  " << right << setw(10) << Size << endl;
+	cout << "HOST-Info:     Hits                   :  " << right << setw(10) << Hits << endl;
+	cout << "HOST-Info:     Misses                 :  " << right << setw(10) << Cache->Misses << endl;
+	cout << "HOST-Info:     Evictions              :  " << right << setw(10) << Cache->Evictions << endl;
+	cout << "HOST-Info:     Hit Rate (%)           :  " << right << setw(10) << fixed << setprecision(1) << ((Lookups > 0) ? 100.0 * Hits / Lookups : 0.0) << endl;
+}
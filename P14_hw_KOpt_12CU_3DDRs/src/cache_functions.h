@@ -0,0 +1,119 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#ifndef __CACHE_FUNCTIONS_H__
+#define __CACHE_FUNCTIONS_H__
+
+#include <stdint.h>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <functional>
+
+#include "kernel.h"
+
+using namespace std;
+
+// ============================================================================
+// Result Cache
+//   Bounded cache of prices keyed on the exact bit pattern of the pricing
+//   fields of a t_in_data record (T, S, K, r, sigma, q, n; dummy_val is not
+//   used). Unchanged contracts priced again cost a hash lookup instead of a
+//   tree.
+//   o) up to RESULT_CACHE_NB_OF_SHARDS shards (never more than Capacity),
+//      each with its own mutex, so several threads can use the cache at the
+//      same time
+//   o) the Capacity is split over the shards (the first Capacity % shards
+//      shards hold one more result), so the cache never holds more than
+//      Capacity results; each shard evicts with the CLOCK algorithm (second
+//      chance on the entries read since the hand last passed)
+//   The capacity (number of results) is set by the BINOMIAL_RESULT_CACHE
+//   environment variable, the cache is disabled when it is not set or 0.
+// ============================================================================
+#define RESULT_CACHE_NB_OF_SHARDS 64
+#define RESULT_CACHE_KEY_WORDS    7
+
+typedef struct {
+	uint32_t Word[RESULT_CACHE_KEY_WORDS];
+} t_result_cache_key;
+
+struct t_result_cache_key_hash {
+	size_t operator()(const t_result_cache_key& Key) const;
+};
+
+struct t_result_cache_key_equal {
+	bool operator()(const t_result_cache_key& a, const t_result_cache_key& b) const;
+};
+
+typedef struct {
+	t_result_cache_key Key;
+	float              Result;
+	bool               Referenced;          // Read since the CLOCK hand last passed
+} t_result_cache_entry;
+
+typedef struct {
+	mutex                                                                        Mutex;
+	vector<t_result_cache_entry>                                                 Entries;    // CLOCK ring
+	unordered_map<t_result_cache_key, int, t_result_cache_key_hash, t_result_cache_key_equal> Index;   // Key -> entry
+	size_t                                                                       Hand;
+	size_t                                                                       Capacity;
+} t_result_cache_shard;
+
+typedef struct {
+	size_t                Capacity;             // 0: cache disabled
+	int                   Nb_Of_Shards;         // min(RESULT_CACHE_NB_OF_SHARDS, Capacity)
+	t_result_cache_shard  Shards[RESULT_CACHE_NB_OF_SHARDS];
+
+	atomic<uint64_t>      Hits;
+	atomic<uint64_t>      Misses;
+	atomic<uint64_t>      Evictions;
+} t_result_cache;
+
+size_t result_cache_capacity();                 // BINOMIAL_RESULT_CACHE environment variable
+
+void result_cache_init   (t_result_cache* Cache, size_t Capacity);
+bool result_cache_enabled(t_result_cache* Cache);
+bool result_cache_lookup (t_result_cache* Cache, const t_in_data* IN_DATA, float* RES);
+void result_cache_insert (t_result_cache* Cache, const t_in_data* IN_DATA, float RES);
+
+// Tests of a batch which missed the cache, gathered for a pricer which needs a multiple of Base tests
+typedef struct {
+	t_in_data*          IN_DATA;                // Nb_Of_Tests tests to price (the misses, then copies of the last one)
+	float*              RES;
+	int                 Nb_Of_Tests;            // Nb_Of_Misses rounded up to a multiple of Base (at least Base)
+	int                 Nb_Of_Misses;
+	vector<int>         Miss_Index;             // Index of every miss in the batch
+	vector<pair<int,int>> Dup_Index;            // (index in the batch, miss) of the repeats of a miss of the same batch
+	bool                Gathered;               // false: IN_DATA/RES are the arrays of the batch (cache disabled)
+} t_result_cache_batch;
+
+// Looks up the NB_OF_TESTS tests of a batch: the hits are written to RES, the misses are gathered in Batch
+// (a contract repeated in the batch is gathered once and counted as a hit).
+// When the cache is disabled, Batch points to IN_DATA and RES (NB_OF_ROUNDED_TESTS tests, no copy).
+void result_cache_gather (t_result_cache* Cache, t_in_data* IN_DATA, float* RES, int NB_OF_TESTS, int NB_OF_ROUNDED_TESTS, int Base, t_result_cache_batch* Batch);
+// Scatters the results of the misses to RES, inserts them in the cache and frees the gathered tests
+void result_cache_scatter(t_result_cache* Cache, t_result_cache_batch* Batch, float* RES);
+
+// Prices NB_OF_TESTS tests through the cache: the tests which miss are gathered and priced by Price(IN_DATA, RES, Nb_Of_Tests),
+// then inserted. Returns the number of hits.
+int  result_cache_price  (t_result_cache* Cache, t_in_data* IN_DATA, float* RES, int NB_OF_TESTS, const function<void(t_in_data*, float*, int)>& Price);
+
+void print_result_cache_stats(t_result_cache* Cache);
+
+#endif
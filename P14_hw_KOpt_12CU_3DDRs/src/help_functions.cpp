@@ -23,12 +23,114 @@
 #include <vector>
 #include <cmath>
 #include <cstring>
-#include <regex>
+#include <cstdio>
+#include <cerrno>
 #include <typeinfo>
+#include <climits>
+#include <algorithm>
+#include <cstddef>
+#include <fcntl.h>
+#include <unistd.h>
 
 using namespace std;
 
+#include <CL/cl_ext.h>
 #include "help_functions.h"
+#include "trace_functions.h"
+
+// ==================================================
+// Config File Tokenizer
+//   The whole file is read into one buffer and parsed
+//   in place: every line is cut at '\n' and at the
+//   comment ('#'), tokens are delimited by spaces/tabs
+//   and terminated with '\0' in the buffer, and numbers
+//   are converted with strtol/strtof. No string is
+//   built per line or per value.
+// ==================================================
+void cfg_read_file(const char* File_Name, vector<char>* Buffer) {
+	FILE* File = fopen(File_Name, "rb");
+	if (File == NULL) {
+	    cout << endl << "HOST-Error: Failed to open the " <<  File_Name << " for read" << endl << endl;
+	    exit(1);
+	}
+
+	fseek(File, 0, SEEK_END);
+	long Size = ftell(File);
+	fseek(File, 0, SEEK_SET);
+
+	Buffer->resize(Size + 1);
+	if ((Size > 0) && (fread(Buffer->data(), 1, Size, File) != (size_t)Size)) {
+	    cout << endl << "HOST-Error: Failed to read the " <<  File_Name << " file" << endl << endl;
+	    exit(1);
+	}
+	(*Buffer)[Size] = '\0';
+	fclose(File);
+}
+
+// Returns the next line ('\0' terminated, NULL at the end of the buffer) and moves *Pos to the following one
+char* cfg_next_line(char** Pos, char* End) {
+	if (*Pos >= End) return NULL;
+
+	char* Line = *Pos;
+	char* Eol  = (char*)memchr(Line, '\n', End - Line);
+	if (Eol == NULL) Eol = End;
+	*Eol = '\0';
+	*Pos = Eol + 1;
+	return Line;
+}
+
+// Splits a line into '\0' terminated tokens (the comment is removed). Returns the number of tokens (at most Max_Tokens)
+int cfg_split_line(char* Line, char** Tokens, int Max_Tokens) {
+	int   Nb_Of_Tokens = 0;
+	char* p            = Line;
+
+	while ((*p != '\0') && (*p != '#')) {
+		while ((*p == ' ') || (*p == '\t') || (*p == '\r')) p++;
+		if ((*p == '\0') || (*p == '#')) break;
+
+		if (Nb_Of_Tokens == Max_Tokens) break;
+		Tokens[Nb_Of_Tokens++] = p;
+
+		while ((*p != '\0') && (*p != '#') && (*p != ' ') && (*p != '\t') && (*p != '\r')) p++;
+		if (*p == '#') { *p = '\0'; break; }
+		if (*p != '\0') *p++ = '\0';
+	}
+	return Nb_Of_Tokens;
+}
+
+// Line as read (tokens separated by a single space), only built for the error messages
+string cfg_line_string(char** Tokens, int Nb_Of_Tokens) {
+	string Line;
+	for (int i=0; i<Nb_Of_Tokens; i++) {
+		if (i > 0) Line += " ";
+		Line += Tokens[i];
+	}
+	return Line;
+}
+
+static void cfg_value_error(const char* File_Name, int Line_Nb, const char* Token, const char* Type) {
+	cout << endl << "HOST-Error: " <<  File_Name << " (line " << Line_Nb << "):  Incorrect value " << Token << endl;
+	cout <<         "            The value should be of type " << Type << endl;
+	exit(1);
+}
+
+int cfg_to_int(const char* Token, const char* File_Name, int Line_Nb) {
+	char* End;
+	errno = 0;
+	long Value = strtol(Token, &End, 10);
+	if ((End == Token) || (*End != '\0') || (errno == ERANGE) || (Value < INT_MIN) || (Value > INT_MAX))
+		cfg_value_error(File_Name, Line_Nb, Token, "int");
+	return (int)Value;
+}
+
+float cfg_to_float(const char* Token, const char* File_Name, int Line_Nb) {
+	char* End;
+	float Value = strtof(Token, &End);
+	if ((End == Token) || (*End != '\0'))
+		cfg_value_error(File_Name, Line_Nb, Token, "float");
+	return Value;
+}
+
 
 // ==================================================
 // Read Test Config File
@@ -36,68 +138,31 @@ using namespace std;
 //   test configuration. If not, then Error and exit
 // ==================================================
 void  read_test_config_file(const char* Test_Config_File_Name, vector<test_config_t> *Test_Config) {
-    fstream Config_File;
-    string	in_line;
+    vector<char> Buffer;
+    char*   Tokens[CFG_MAX_TOKENS_PER_LINE];
+    char*   in_line;
     int     line_nb = 0;
     int     nb_of_read_values;
     int     Nb_Of_Values_To_Read_Per_Line = 10;
     test_config_t Current_Test_Confguration;
 
-    Config_File.open(Test_Config_File_Name,ios::in);
-	if (! Config_File.is_open()) {
-	    cout << endl << "HOST-Error: Failed to open the " <<  Test_Config_File_Name << " for read" << endl << endl;
-	    exit(1);
-	}
+    cfg_read_file(Test_Config_File_Name, &Buffer);
 
-	while (getline (Config_File,in_line)) {
-		line_nb ++;
+	char* Pos = Buffer.data();
+	char* End = Buffer.data() + Buffer.size() - 1;
 
-		// -----------------------------------
-		// If comment exists, then remove it
-		// -----------------------------------
-		int comment_index = in_line.find("#");
-		if (comment_index != -1) {
-			in_line = in_line.substr(0,comment_index);
-		}
+	(*Test_Config).reserve((*Test_Config).size() + count(Pos, End, '\n') + 1);
 
-		// ---------------------------------------------------------------
-		// If a string contains only space characters then read next line
-		// ---------------------------------------------------------------
-		int start_str = in_line.find_first_not_of(" \t");
-		if (start_str == -1) continue;
+	Current_Test_Confguration.File_Name = Test_Config_File_Name;
 
-		// --------------------------------------------------------
-		// Remove all leading, trailing and extra spaces
-		// --------------------------------------------------------
-		in_line = regex_replace(in_line, regex("^ +| +$|( ) +"), "$1");
+	while ((in_line = cfg_next_line(&Pos, End)) != NULL) {
+		line_nb ++;
 
-		// --------------------------------------------------------
-		// Read All values from the line
-		// --------------------------------------------------------
-		stringstream in_str_stream;
-		in_str_stream << in_line;
-
-		Current_Test_Confguration.File_Name = Test_Config_File_Name;
-		Current_Test_Confguration.Line_Nb   = line_nb;
-
-		nb_of_read_values = 0;
-		while (!in_str_stream.eof()) {
-			nb_of_read_values ++;
-			switch (nb_of_read_values) {
-				case  1: in_str_stream >> Current_Test_Confguration.Company_Name; break;
-				case  2: in_str_stream >> Current_Test_Confguration.T;            break;
-				case  3: in_str_stream >> Current_Test_Confguration.S;            break;
-				case  4: in_str_stream >> Current_Test_Confguration.K;            break;
-				case  5: in_str_stream >> Current_Test_Confguration.r;            break;
-				case  6: in_str_stream >> Current_Test_Confguration.sigma;        break;
-				case  7: in_str_stream >> Current_Test_Confguration.q;            break;
-				case  8: in_str_stream >> Current_Test_Confguration.n;            break;
-				case  9: in_str_stream >> Current_Test_Confguration.K_Step;       break;
-				case 10: in_str_stream >> Current_Test_Confguration.NB_OF_TESTS;  break;
-				default: break;
-			}
-			if (nb_of_read_values == Nb_Of_Values_To_Read_Per_Line) break;
-		}
+		// ---------------------------------------------------------------
+		// Split the line (comment removed); skip lines without any value
+		// ---------------------------------------------------------------
+		nb_of_read_values = cfg_split_line(in_line, Tokens, Nb_Of_Values_To_Read_Per_Line);
+		if (nb_of_read_values == 0) continue;
 
 		if (nb_of_read_values != Nb_Of_Values_To_Read_Per_Line) {
 			cout << endl << "HOST-Error: The " <<  Test_Config_File_Name << " file is incomplete." << endl;
@@ -105,11 +170,24 @@ void  read_test_config_file(const char* Test_Config_File_Name, vector<test_confi
 			exit(1);
 		}
 
+		// --------------------------------------------------------
+		// Read All values from the line
+		// --------------------------------------------------------
+		Current_Test_Confguration.Line_Nb      = line_nb;
+		Current_Test_Confguration.Company_Name = Tokens[0];
+		Current_Test_Confguration.T            = cfg_to_int  (Tokens[1], Test_Config_File_Name, line_nb);
+		Current_Test_Confguration.S            = cfg_to_float(Tokens[2], Test_Config_File_Name, line_nb);
+		Current_Test_Confguration.K            = cfg_to_float(Tokens[3], Test_Config_File_Name, line_nb);
+		Current_Test_Confguration.r            = cfg_to_float(Tokens[4], Test_Config_File_Name, line_nb);
+		Current_Test_Confguration.sigma        = cfg_to_float(Tokens[5], Test_Config_File_Name, line_nb);
+		Current_Test_Confguration.q            = cfg_to_float(Tokens[6], Test_Config_File_Name, line_nb);
+		Current_Test_Confguration.n            = cfg_to_int  (Tokens[7], Test_Config_File_Name, line_nb);
+		Current_Test_Confguration.K_Step       = cfg_to_float(Tokens[8], Test_Config_File_Name, line_nb);
+		Current_Test_Confguration.NB_OF_TESTS  = cfg_to_int  (Tokens[9], Test_Config_File_Name, line_nb);
+
 		(*Test_Config).push_back(Current_Test_Confguration);
 	}
 
-	Config_File.close();
-
 	if ((*Test_Config).size() == 0) {
 		cout << endl << "HOST-Error: No Test configurations were found in the " <<  Test_Config_File_Name << " file." << endl;
 		exit(1);
@@ -164,81 +242,131 @@ void print_test_config_info(vector<test_config_t>  *Test_Config) {
 }
 
 
+// ==================================================
+// Memory bank "DDR[i]" / "HBM[i]" -> i (-1: bad syntax)
+// ==================================================
+static int mem_bank_index(string Bank, string* Bank_Type) {
+	size_t Open  = Bank.find('[');
+	size_t Close = Bank.find(']');
+
+	if ((Open == string::npos) || (Close != Bank.size()-1) || (Close <= Open+1)) return -1;
+
+	string Type  = Bank.substr(0, Open);
+	string Index = Bank.substr(Open+1, Close-Open-1);
+	if ((Type != "DDR") && (Type != "HBM"))                       return -1;
+	if (Index.find_first_not_of("0123456789") != string::npos)   return -1;
+
+	if (Bank_Type != NULL) (*Bank_Type) = Type;
+	return(atoi(Index.c_str()));
+}
+
 // ==================================================
 // Read SW_HW_Config File
 //   We check that we read all values.
 //   f not, then Error and exit
+//   The resources line may be followed by
+//   "MEM_BANK <Kernel_Index> <DDR[i] | HBM[i]>" lines
+//   and a "KERNEL <bram | dataflow>" line
 // ==================================================
 
 void  read_sw_hw_config_file(const char* SW_HW_Config_File_Name, sw_hw_config_t* SW_HW_Config) {
-    fstream Config_File;
-    string	in_line;
+    vector<char> Buffer;
+    char*   Tokens[CFG_MAX_TOKENS_PER_LINE];
+    char*   in_line;
+    int     nb_of_tokens;
     int     line_nb = 0;
     int     nb_of_read_values = 0;
-    int     Nb_Of_Values_To_Read_Per_Line = 4;
+    int     Nb_Of_Values_To_Read_Per_Line = 5;
+    int     Nb_Of_Required_Values         = 4;      // QUEUE_DEPTH is optional
+    bool    Resources_Read                = false;
 
-    Config_File.open(SW_HW_Config_File_Name,ios::in);
-	if (! Config_File.is_open()) {
-	    cout << endl << "HOST-Error: Failed to open the " <<  SW_HW_Config_File_Name << " for read" << endl << endl;
-	    exit(1);
-	}
+    cfg_read_file(SW_HW_Config_File_Name, &Buffer);
 
-	while (getline (Config_File,in_line)) {
-		line_nb ++;
+	SW_HW_Config->File_Name   = SW_HW_Config_File_Name;
+	SW_HW_Config->Line_Nb     = 0;
+	SW_HW_Config->QUEUE_DEPTH = DEFAULT_QUEUE_DEPTH;
+	SW_HW_Config->MEM_BANK.clear();
+	SW_HW_Config->KERNEL_TYPE = "bram";
 
-		// -----------------------------------
-		// If comment exists, then remove it
-		// -----------------------------------
-		int comment_index = in_line.find("#");
-		if (comment_index != -1) {
-			in_line = in_line.substr(0,comment_index);
-		}
+	char* Pos = Buffer.data();
+	char* End = Buffer.data() + Buffer.size() - 1;
+
+	while ((in_line = cfg_next_line(&Pos, End)) != NULL) {
+		line_nb ++;
 
 		// ---------------------------------------------------------------
-		// If a string contains only space characters then read next line
+		// Split the line (comment removed); skip lines without any value
 		// ---------------------------------------------------------------
-		int start_str = in_line.find_first_not_of(" \t");
-		if (start_str == -1) continue;
+		nb_of_tokens = cfg_split_line(in_line, Tokens, CFG_MAX_TOKENS_PER_LINE);
+		if (nb_of_tokens == 0) continue;
+
+		// --------------------------------------------------------
+		// Memory Topology: MEM_BANK <Kernel_Index> <Bank>
+		//   (after the resources line, Kernel_Index < NB_OF_KERNELS)
+		// --------------------------------------------------------
+		if (strcmp(Tokens[0], "MEM_BANK") == 0) {
+			char* Index_End    = NULL;
+			long  Kernel_Index = (nb_of_tokens >= 3) ? strtol(Tokens[1], &Index_End, 10) : -1;
+
+			if ((nb_of_tokens < 3) || (*Index_End != '\0') || (Kernel_Index < 0) || (!Resources_Read) || (Kernel_Index >= SW_HW_Config->NB_OF_KERNELS) || (mem_bank_index(Tokens[2], NULL) < 0)) {
+				cout << endl << "HOST-Error: " <<  SW_HW_Config_File_Name << " (line " << line_nb << "):  Incorrect MEM_BANK line: " << cfg_line_string(Tokens, nb_of_tokens) << endl;
+				cout <<         "            Expected: MEM_BANK <Kernel_Index> <DDR[i] | HBM[i]> after the resources line, Kernel_Index in [0...NB_OF_KERNELS-1]" << endl;
+				exit(1);
+			}
+
+			if (Kernel_Index >= (int)SW_HW_Config->MEM_BANK.size()) SW_HW_Config->MEM_BANK.resize(Kernel_Index+1);
+			SW_HW_Config->MEM_BANK[Kernel_Index] = Tokens[2];
+			continue;
+		}
 
 		// --------------------------------------------------------
-		// Remove all leading, trailing and extra spaces
+		// Kernel Implementation: KERNEL <bram | dataflow>
 		// --------------------------------------------------------
-		in_line = regex_replace(in_line, regex("^ +| +$|( ) +"), "$1");
+		if ((strcmp(Tokens[0], "KERNEL") == 0) && (nb_of_tokens > 1)) {
+			if ((strcmp(Tokens[1], "bram") != 0) && (strcmp(Tokens[1], "dataflow") != 0)) {
+				cout << endl << "HOST-Error: " <<  SW_HW_Config_File_Name << " (line " << line_nb << "):  Incorrect KERNEL line: " << cfg_line_string(Tokens, nb_of_tokens) << endl;
+				cout <<         "            Expected: KERNEL <bram | dataflow>" << endl;
+				exit(1);
+			}
+
+			SW_HW_Config->KERNEL_TYPE = Tokens[1];
+			continue;
+		}
+
+		if (Resources_Read) {
+			cout << endl << "HOST-Error: " <<  SW_HW_Config_File_Name << " (line " << line_nb << "):  Unexpected line: " << cfg_line_string(Tokens, nb_of_tokens) << endl;
+			exit(1);
+		}
 
 		// --------------------------------------------------------
 		// Read All values from the line
 		// --------------------------------------------------------
-		stringstream in_str_stream;
-		in_str_stream << in_line;
-
-		SW_HW_Config->File_Name = SW_HW_Config_File_Name;
-		SW_HW_Config->Line_Nb   = line_nb;
-
-		while (!in_str_stream.eof()) {
-			nb_of_read_values ++;
-			switch (nb_of_read_values) {
-				case  1: in_str_stream >> SW_HW_Config->NB_OF_THREADS;                   break;
-				case  2: in_str_stream >> SW_HW_Config->NB_OF_KERNELS;                   break;
-				case  3: in_str_stream >> SW_HW_Config->NB_OF_CUs_PER_KERNEL;            break;
-				case  4: in_str_stream >> SW_HW_Config->NB_OF_PARALLEL_FUNCTIONS_PER_CU; break;
+		SW_HW_Config->Line_Nb = line_nb;
+		nb_of_read_values     = min(nb_of_tokens, Nb_Of_Values_To_Read_Per_Line);
+
+		for (int i=0; i<nb_of_read_values; i++) {
+			int Value = cfg_to_int(Tokens[i], SW_HW_Config_File_Name, line_nb);
+			switch (i+1) {
+				case  1: SW_HW_Config->NB_OF_THREADS                   = Value; break;
+				case  2: SW_HW_Config->NB_OF_KERNELS                   = Value; break;
+				case  3: SW_HW_Config->NB_OF_CUs_PER_KERNEL            = Value; break;
+				case  4: SW_HW_Config->NB_OF_PARALLEL_FUNCTIONS_PER_CU = Value; break;
+				case  5: SW_HW_Config->QUEUE_DEPTH                     = Value; break;
 				default: break;
 			}
-			if (nb_of_read_values == Nb_Of_Values_To_Read_Per_Line) break;
 		}
 
-		break;
+		Resources_Read = true;
 	}
 
 	// --------------------------------------------------------
 	// Check All values were specified
 	// --------------------------------------------------------
-	if (nb_of_read_values != Nb_Of_Values_To_Read_Per_Line) {
+	if (nb_of_read_values < Nb_Of_Required_Values) {
 		cout << endl << "HOST-Error: The " <<  SW_HW_Config_File_Name << " file is incomplete." << endl;
-		cout <<         "            Line " << line_nb << " contains " << nb_of_read_values << " values instead of " << Nb_Of_Values_To_Read_Per_Line << endl;
+		cout <<         "            Line " << SW_HW_Config->Line_Nb << " contains " << nb_of_read_values << " values instead of " << Nb_Of_Required_Values << " (or " << Nb_Of_Values_To_Read_Per_Line << ")" << endl;
 		exit(1);
 	}
-
-	Config_File.close();
 }
 
 
@@ -259,6 +387,36 @@ void print_sw_hw_config_info(sw_hw_config_t SW_HW_Config) {
 	cout << "HOST-Info: NB_OF_KERNELS                   = " << SW_HW_Config.NB_OF_KERNELS                   << endl;
 	cout << "HOST-Info: NB_OF_CUs_PER_KERNEL            = " << SW_HW_Config.NB_OF_CUs_PER_KERNEL            << endl;
 	cout << "HOST-Info: NB_OF_PARALLEL_FUNCTIONS_PER_CU = " << SW_HW_Config.NB_OF_PARALLEL_FUNCTIONS_PER_CU << endl;
+	cout << "HOST-Info: QUEUE_DEPTH                     = " << SW_HW_Config.QUEUE_DEPTH                     << endl;
+	cout << "HOST-Info: KERNEL_TYPE                     = " << SW_HW_Config.KERNEL_TYPE                     << endl;
+
+	cout << "HOST-Info: "                                                                                   << endl;
+	cout << "HOST-Info: Memory Topology"                                                                    << endl;
+	cout << "HOST-Info: ------------------"                                                                 << endl;
+	for (int i=0; i<SW_HW_Config.NB_OF_KERNELS; i++) {
+		string Bank = (i < (int)SW_HW_Config.MEM_BANK.size()) ? SW_HW_Config.MEM_BANK[i] : "";
+		cout << "HOST-Info: " << left << setw(32) << kernel_name(&SW_HW_Config, i) << "= " << (Bank.empty() ? "(not set)" : Bank) << endl;
+	}
+
+	// ..................................................................
+	// Bandwidth estimate: the CUs of the kernels mapped to a bank share
+	// its peak bandwidth
+	// ..................................................................
+	vector<string> Banks;
+	for (int i=0; (i<SW_HW_Config.NB_OF_KERNELS) && (i<(int)SW_HW_Config.MEM_BANK.size()); i++)
+		if ((!SW_HW_Config.MEM_BANK[i].empty()) && (find(Banks.begin(), Banks.end(), SW_HW_Config.MEM_BANK[i]) == Banks.end()))
+			Banks.push_back(SW_HW_Config.MEM_BANK[i]);
+
+	for (unsigned b=0; b<Banks.size(); b++) {
+		string Type;
+		int    Nb_Of_Kernels = count(SW_HW_Config.MEM_BANK.begin(), SW_HW_Config.MEM_BANK.begin() + min(SW_HW_Config.NB_OF_KERNELS, (int)SW_HW_Config.MEM_BANK.size()), Banks[b]);
+		int    Nb_Of_CUs     = Nb_Of_Kernels * SW_HW_Config.NB_OF_CUs_PER_KERNEL;
+		mem_bank_index(Banks[b], &Type);
+		double Peak_GBps     = (Type == "HBM") ? HBM_BANK_PEAK_GBps : DDR_BANK_PEAK_GBps;
+
+		cout << "HOST-Info: " << left << setw(32) << Banks[b] << "= " << Nb_Of_Kernels << " kernel(s), " << Nb_Of_CUs << " CUs, peak "
+		     << fixed << setprecision(1) << Peak_GBps << " GB/s (" << Peak_GBps/max(Nb_Of_CUs,1) << " GB/s per CU)" << endl;
+	}
 	cout << "HOST-Info: ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~"                   << endl;
     cout << endl;
 
@@ -278,7 +436,7 @@ void process_configurations(string sw_hw, sw_hw_config_t* SW_HW_Config, vector<t
 	// --------------------------------------------------------
 	// Check SW_HW_Config
 	// --------------------------------------------------------
-	if (sw_hw == "sw") {
+	if ((sw_hw == "sw") || (sw_hw == "hybrid")) {
 
 		if (SW_HW_Config->NB_OF_THREADS <= 0) {
 			cout << endl << "HOST-Error: " <<  (*SW_HW_Config).File_Name << " (line " << (*SW_HW_Config).Line_Nb << "):  Incorrect value NB_OF_THREADS=" << SW_HW_Config->NB_OF_THREADS << endl;
@@ -286,7 +444,9 @@ void process_configurations(string sw_hw, sw_hw_config_t* SW_HW_Config, vector<t
 			exit(1);
 		}
 
-	} else { // (sw_hw == "hw")
+	}
+
+	if (sw_hw != "sw") { // hw, hw_dynamic, hybrid
 
 		if (SW_HW_Config->NB_OF_KERNELS <= 0) {
 			cout << endl << "HOST-Error: " <<  (*SW_HW_Config).File_Name << " (line " << (*SW_HW_Config).Line_Nb << "):  Incorrect value NB_OF_KERNELS=" << SW_HW_Config->NB_OF_KERNELS << endl;
@@ -300,11 +460,25 @@ void process_configurations(string sw_hw, sw_hw_config_t* SW_HW_Config, vector<t
 			exit(1);
 		}
 
-		if (SW_HW_Config->NB_OF_PARALLEL_FUNCTIONS_PER_CU <= 0) {
+		if (SW_HW_Config->NB_OF_PARALLEL_FUNCTIONS_PER_CU != CONST_NB_OF_PARALLEL_FUNCTIONS) {
 			cout << endl << "HOST-Error: " <<  (*SW_HW_Config).File_Name << " (line " << (*SW_HW_Config).Line_Nb << "):  Incorrect value NB_OF_PARALLEL_FUNCTIONS_PER_CU=" << SW_HW_Config->NB_OF_PARALLEL_FUNCTIONS_PER_CU << endl;
+			cout <<         "            The kernels are built with CONST_NB_OF_PARALLEL_FUNCTIONS=" << CONST_NB_OF_PARALLEL_FUNCTIONS << " (see kernel.h)" << endl;
+			exit(1);
+		}
+
+		if (SW_HW_Config->QUEUE_DEPTH <= 0) {
+			cout << endl << "HOST-Error: " <<  (*SW_HW_Config).File_Name << " (line " << (*SW_HW_Config).Line_Nb << "):  Incorrect value QUEUE_DEPTH=" << SW_HW_Config->QUEUE_DEPTH << endl;
 			cout <<         "            The value should be >0" << endl;
 			exit(1);
 		}
+
+		for (int i=0; i<SW_HW_Config->NB_OF_KERNELS; i++) {
+			if ((i >= (int)SW_HW_Config->MEM_BANK.size()) || SW_HW_Config->MEM_BANK[i].empty()) {
+				cout << endl << "HOST-Error: " <<  (*SW_HW_Config).File_Name << ":  No memory bank defined for kernel " << i << endl;
+				cout <<         "            Add a \"MEM_BANK " << i << " <DDR[i] | HBM[i]>\" line" << endl;
+				exit(1);
+			}
+		}
 	}
 
 	// --------------------------------------------------------
@@ -325,22 +499,20 @@ void process_configurations(string sw_hw, sw_hw_config_t* SW_HW_Config, vector<t
 		// ..................
 		// Check NB_OF_TESTS
 		// ..................
-		if (((*Test_Config)[i].NB_OF_TESTS <= 0) || ((*Test_Config)[i].NB_OF_TESTS > (*SW_HW_Config).MAX_NB_OF_TESTS)) {
+		if ((*Test_Config)[i].NB_OF_TESTS <= 0) {
 			cout << endl << "HOST-Error: " <<  (*Test_Config)[i].File_Name << " (line " << (*Test_Config)[i].Line_Nb << "):  Incorrect value NB_OF_TESTS=" << (*Test_Config)[i].NB_OF_TESTS << endl;
-			cout <<         "            The value should be in the following range: [1...MAX_NB_OF_TESTS(" << (*SW_HW_Config).MAX_NB_OF_TESTS << ")]" << endl;
+			cout <<         "            The value should be >0" << endl;
+			exit(1);
+		}
+
+		if ((*DEFINED_NB_OF_TESTS) > INT_MAX - (*Test_Config)[i].NB_OF_TESTS) {
+			cout << endl << "HOST-Error: Total number of tests specified in the " << (*Test_Config)[i].File_Name << " file exceeds " << INT_MAX << endl;
 			exit(1);
 		}
 		(*DEFINED_NB_OF_TESTS) += (*Test_Config)[i].NB_OF_TESTS;
 
 	}
 
-	// --------------------------------------------------------
-	// Check DEFINED_NB_OF_TESTS <= MAX_NB_OF_TESTS
-	// --------------------------------------------------------
-	if ((*DEFINED_NB_OF_TESTS) > (*SW_HW_Config).MAX_NB_OF_TESTS) {
-		cout << endl << "HOST-Error: Total number of tests (" << (*DEFINED_NB_OF_TESTS) << ") specified in the " << (*Test_Config)[0].File_Name << " file exceeds MAX_NB_OF_TESTS(" << (*SW_HW_Config).MAX_NB_OF_TESTS << ")" << endl;
-	}
-
 	// -----------------------------------------------------------------------------------------
 	// In our solution we equally distribute calculation across specified
 	//    o) Number of Threads (SW) or
@@ -360,9 +532,12 @@ void process_configurations(string sw_hw, sw_hw_config_t* SW_HW_Config, vector<t
 	else
 		(*ROUNDED_NB_OF_TESTS) = (*DEFINED_NB_OF_TESTS);
 
+	// --------------------------------------------------------
+	// More than MAX_NB_OF_TESTS tests are streamed in chunks
+	// --------------------------------------------------------
 	if ((*ROUNDED_NB_OF_TESTS) > (*SW_HW_Config).MAX_NB_OF_TESTS) {
-		cout << endl << "HOST-Error: Rounded number of tests " << *ROUNDED_NB_OF_TESTS << " exceeds MAX_NB_OF_TESTS(" << (*SW_HW_Config).MAX_NB_OF_TESTS << ")" << endl;
-		exit(1);
+		cout << endl << "HOST-Info: Rounded number of tests " << *ROUNDED_NB_OF_TESTS << " exceeds MAX_NB_OF_TESTS(" << (*SW_HW_Config).MAX_NB_OF_TESTS << ")" << endl;
+		cout <<         "           Tests will be streamed in chunks" << endl;
 	}
 
 }
@@ -370,32 +545,58 @@ void process_configurations(string sw_hw, sw_hw_config_t* SW_HW_Config, vector<t
 
 
 
+// ==============================================
+// Max height of the Binomial trees in Test_Config
+// ==============================================
+int get_max_tree_height(vector<test_config_t>* Test_Config) {
+	int Max_n = 1;
+
+	for (unsigned i=0; i<(*Test_Config).size(); i++)
+		Max_n = max(Max_n, (*Test_Config)[i].n);
+
+	return(Max_n);
+}
+
+
 // ==============================================
 // Generate Test Vectors
 // ==============================================
 void generate_test_vectors(t_in_data* host_IN_DATA, vector<test_config_t> Test_Config, int ROUNDED_NB_OF_TESTS) {
-	int indx = 0;
-
 	cout << "HOST-Info: Generating Test Vectors in host_IN_DATA ... " << endl;
 
-	for (unsigned i=0; i<Test_Config.size(); i++ ) {
-		for (int k=0; k<Test_Config[i].NB_OF_TESTS; k++) {
-			host_IN_DATA[indx].T         = Test_Config[i].T;
-			host_IN_DATA[indx].S         = Test_Config[i].S;
-			host_IN_DATA[indx].K         = Test_Config[i].K + Test_Config[i].K_Step*k;
-			host_IN_DATA[indx].r         = Test_Config[i].r;
-			host_IN_DATA[indx].sigma     = Test_Config[i].sigma;
-			host_IN_DATA[indx].q         = Test_Config[i].q;
-			host_IN_DATA[indx].n         = Test_Config[i].n;
+	generate_test_vectors(host_IN_DATA, &Test_Config, 0, ROUNDED_NB_OF_TESTS);
+}
+
+// ----------------------------------------------------------------------------
+// Generate test vectors [Start_Index ... Start_Index+Nb_Of_Tests-1] in
+// host_IN_DATA[0 ... Nb_Of_Tests-1]. Tests beyond the tests defined in
+// Test_Config are dummy tests (required to run the kernels).
+// ----------------------------------------------------------------------------
+void generate_test_vectors(t_in_data* host_IN_DATA, vector<test_config_t>* Test_Config, int Start_Index, int Nb_Of_Tests) {
+	int indx        = 0;
+	int Config_Base = 0;     // Global index of the first test of (*Test_Config)[i]
+
+	for (unsigned i=0; (i<(*Test_Config).size()) && (indx<Nb_Of_Tests); i++ ) {
+		test_config_t* Config = &(*Test_Config)[i];
+
+		for (int k=max(0,Start_Index+indx-Config_Base); (k<Config->NB_OF_TESTS) && (indx<Nb_Of_Tests); k++) {
+			host_IN_DATA[indx].T         = Config->T;
+			host_IN_DATA[indx].S         = Config->S;
+			host_IN_DATA[indx].K         = Config->K + Config->K_Step*k;
+			host_IN_DATA[indx].r         = Config->r;
+			host_IN_DATA[indx].sigma     = Config->sigma;
+			host_IN_DATA[indx].q         = Config->q;
+			host_IN_DATA[indx].n         = Config->n;
 			host_IN_DATA[indx].dummy_val = 0.0f;
 			indx ++;
 		}
+		Config_Base += Config->NB_OF_TESTS;
 	}
 
 	// ----------------------------------------------
 	// Generate additional dummy tests to run kernels
 	// ----------------------------------------------
-	for (int i=indx; i<ROUNDED_NB_OF_TESTS; i++) {
+	for (int i=indx; i<Nb_Of_Tests; i++) {
 		host_IN_DATA[i].T         = 1;
 		host_IN_DATA[i].S         = 1;
 		host_IN_DATA[i].K         = 1;
@@ -403,6 +604,7 @@ void generate_test_vectors(t_in_data* host_IN_DATA, vector<test_config_t> Test_C
 		host_IN_DATA[i].sigma     = 1;
 		host_IN_DATA[i].q         = 1;
 		host_IN_DATA[i].n         = 1; // We specify min Tree height , because the results will be ignored
+		host_IN_DATA[i].dummy_val = 0.0f;
 	}
 
 }
@@ -412,7 +614,8 @@ void generate_test_vectors(t_in_data* host_IN_DATA, vector<test_config_t> Test_C
 // Custom Profiling
 // ============================================================================
 #define HIDE_PROFILE_MSG 1
-double run_custom_profiling (int Nb_Of_Kernels, int Nb_Of_Memory_Tranfers, cl_event* K_exe_event, cl_event* Mem_op_event,string* list_of_kernel_names) {
+double run_custom_profiling (int Nb_Of_Kernels, int Nb_Of_Memory_Tranfers, cl_event* K_exe_event, cl_event* Mem_op_event,string* list_of_kernel_names,
+                             string* list_of_transfer_names, string* list_of_tracks) {
 	typedef struct {
 		string    action_type; // kernel, "memory (H->G)", "memory (G->H)"
 		string    name;
@@ -437,7 +640,7 @@ double run_custom_profiling (int Nb_Of_Kernels, int Nb_Of_Memory_Tranfers, cl_ev
 
 	for (int i=0; i<Nb_Of_Memory_Tranfers; i++) {
 		PROFILE[Nb_Of_Kernels+i].action_type="mem (H<->G)";
-		PROFILE[Nb_Of_Kernels+i].name="Transfer_" + to_string(i+1);
+		PROFILE[Nb_Of_Kernels+i].name=(list_of_transfer_names != NULL) ? list_of_transfer_names[i] : "Transfer_" + to_string(i+1);
 		PROFILE[Nb_Of_Kernels+i].event = Mem_op_event[i];
 	}
 
@@ -471,6 +674,14 @@ double run_custom_profiling (int Nb_Of_Kernels, int Nb_Of_Memory_Tranfers, cl_ev
 		PROFILE[i].duration = (double)(PROFILE[i].profiling_command_end - PROFILE[i].profiling_command_start) * 1.0e-6;
 	}
 
+	// -------------------------------------------------------------------------------------
+	// Export the events to the timeline trace (one track per CU / memory bank)
+	// -------------------------------------------------------------------------------------
+	if (trace_enabled() && (list_of_tracks != NULL)) {
+		for (int i=0; i<Nb_Of_Kernels + Nb_Of_Memory_Tranfers; i++)
+			trace_device_event(list_of_tracks[i], PROFILE[i].name, (i < Nb_Of_Kernels) ? "kernel" : "transfer", PROFILE[i].event);
+	}
+
 	// -------------------------------------------------------------------------------------
 	// Calculate Duration of
 	//   o) All kernels execution time
@@ -579,6 +790,88 @@ double run_custom_profiling (int Nb_Of_Kernels, int Nb_Of_Memory_Tranfers, cl_ev
 
 }
 
+// ============================================================================
+// Name of kernel Kernel_Index in the xclbin
+// ============================================================================
+string kernel_name(sw_hw_config_t* SW_HW_Config, int Kernel_Index) {
+	if ((*SW_HW_Config).KERNEL_TYPE == "dataflow") return("K_americanPut_df_" + to_string(Kernel_Index));
+	return("K_americanPut_" + to_string(Kernel_Index));
+}
+
+// ============================================================================
+// Xilinx Extension flags of the buffers of kernel Kernel_Index
+//   o) DDR[0..3]      : XCL_MEM_DDR_BANK0..3
+//   o) other banks    : XCL_MEM_TOPOLOGY | index of the bank in the memory
+//                       topology of the xclbin (HBM[i] -> i)
+// ============================================================================
+unsigned kernel_mem_flags(sw_hw_config_t* SW_HW_Config, int Kernel_Index) {
+	if ((Kernel_Index < 0) || (Kernel_Index >= (int)(*SW_HW_Config).MEM_BANK.size()) || (*SW_HW_Config).MEM_BANK[Kernel_Index].empty()) {
+		cout << endl << "HOST-Error: No memory bank defined for kernel " << Kernel_Index << endl << endl;
+		exit(1);
+	}
+
+	string Type;
+	int    Index = mem_bank_index((*SW_HW_Config).MEM_BANK[Kernel_Index], &Type);
+
+	if ((Type == "DDR") && (Index < 4)) return(XCL_MEM_DDR_BANK0 << Index);
+	return(XCL_MEM_TOPOLOGY | Index);
+}
+
+// ============================================================================
+// Measured bandwidth of each memory bank (Host <-> Global Memory transfers)
+//   Transfer i moves Transfer_Bytes[i] from/to the bank of Transfer_Kernel[i].
+//   The busy time of a bank is the union of its transfer intervals.
+// ============================================================================
+void print_mem_bank_bandwidth(sw_hw_config_t* SW_HW_Config, int Nb_Of_Transfers, cl_event* Mem_op_event, int* Transfer_Kernel, size_t* Transfer_Bytes) {
+	vector<string> Banks;
+	for (int i=0; i<Nb_Of_Transfers; i++) {
+		string Bank = (*SW_HW_Config).MEM_BANK[Transfer_Kernel[i]];
+		if (find(Banks.begin(), Banks.end(), Bank) == Banks.end()) Banks.push_back(Bank);
+	}
+
+	cout << "HOST-Info: " << left << setw(10) << "Bank" << " | " << right << setw(9) << "Transfers" << " | " << setw(9) << "MB" << " | " << setw(9) << "Busy (ms)"
+	     << " | " << setw(8) << "GB/s" << " | " << setw(9) << "Peak GB/s" << endl;
+	cout << "HOST-Info: " << string(68, '-') << endl;
+
+	for (unsigned b=0; b<Banks.size(); b++) {
+		vector<pair<cl_ulong,cl_ulong> > Intervals;
+		double Bytes = 0;
+
+		for (int i=0; i<Nb_Of_Transfers; i++) {
+			if ((*SW_HW_Config).MEM_BANK[Transfer_Kernel[i]] != Banks[b]) continue;
+
+			cl_ulong Start, End;
+			clGetEventProfilingInfo(Mem_op_event[i], CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &Start, NULL);
+			clGetEventProfilingInfo(Mem_op_event[i], CL_PROFILING_COMMAND_END,   sizeof(cl_ulong), &End,   NULL);
+			Intervals.push_back(make_pair(Start, End));
+			Bytes += Transfer_Bytes[i];
+		}
+
+		sort(Intervals.begin(), Intervals.end());
+		cl_ulong Busy_ns = 0, Cur_Start = 0, Cur_End = 0;
+		for (unsigned i=0; i<Intervals.size(); i++) {
+			if ((i == 0) || (Intervals[i].first > Cur_End)) {
+				Busy_ns  += Cur_End - Cur_Start;
+				Cur_Start = Intervals[i].first;
+				Cur_End   = Intervals[i].second;
+			} else {
+				Cur_End   = max(Cur_End, Intervals[i].second);
+			}
+		}
+		Busy_ns += Cur_End - Cur_Start;
+
+		string Type;
+		mem_bank_index(Banks[b], &Type);
+
+		cout << "HOST-Info: " << left << setw(10) << Banks[b] << " | " << right << setw(9) << Intervals.size()
+		     << " | " << setw(9) << fixed << setprecision(3) << Bytes*1.0e-6
+		     << " | " << setw(9) << fixed << setprecision(3) << Busy_ns*1.0e-6
+		     << " | " << setw(8) << fixed << setprecision(2) << ((Busy_ns > 0) ? Bytes/Busy_ns : 0.0)
+		     << " | " << setw(9) << fixed << setprecision(1) << ((Type == "HBM") ? HBM_BANK_PEAK_GBps : DDR_BANK_PEAK_GBps) << endl;
+	}
+	cout << "HOST-Info: " << string(68, '-') << endl;
+}
+
 // ============================================================================
 // Compare SW and HW Results
 // ============================================================================
@@ -605,6 +898,7 @@ int compare_results(float* sw_RES, float* hw_RES, int Nb_of_Results, int Nb_Of_E
 #define CMP_ERROR 0.001f
 
 int cmp_floats(float val1, float val2) {
+	if (val1 == val2) return (1);            // Also covers 0.0 (worthless options): no 0/0
 	float cmp_res = abs((val1 - val2)/max(val1,val2));
 	// cout << endl << setprecision (10) << cmp_res << endl;
     if (cmp_res <= CMP_ERROR) return (1);
@@ -613,70 +907,250 @@ int cmp_floats(float val1, float val2) {
 
 
 // ============================================================================
-// Sore results in a File
+// Store results in a File
+//   o) open_results_file  : creates the file and writes the report header
+//   o) store_results_chunk: appends results [Start_Index ... Start_Index+Nb_Of_Results-1]
+//                           host_IN_DATA and hw_RES hold these results only
+//   o) close_results_file : writes the last block and closes the file
+//   Chunks should be stored in order. A company table header is written when
+//   the chunk reaches the first test of a company.
+//
+//   The report is formatted in a RESULTS_BUFFER_SIZE block which is written
+//   with one write() when full (same text as the former setw/setprecision
+//   formatting). With BINOMIAL_RESULTS_FORMAT=bin the file is <name>.bin:
+//   a t_results_header followed by one float per test.
 // ============================================================================
-void store_results(string SW_HW_Mode, string Out_File_Name, t_in_data* host_IN_DATA, float* hw_RES, vector<test_config_t>* Test_Config) {
-	fstream out_file;
-	vector<string> column_names = {"T","S","K","r","sigma","q","n","BOPM_Result"};
+static void results_flush(t_results_file* out_file) {
+	size_t Written = 0;
+
+	while (Written < out_file->Used) {
+		ssize_t Status = write(out_file->fd, out_file->Buffer + Written, out_file->Used - Written);
+		if (Status < 0) {
+			if (errno == EINTR) continue;
+			cout << "HOST_ERROR: Unable to write the " << out_file->File_Name << " file (" << strerror(errno) << ")" << endl << endl;
+			exit(1);
+		}
+		Written += Status;
+	}
+	out_file->Used = 0;
+}
+
+// Room for Size bytes in the block
+static char* results_reserve(t_results_file* out_file, size_t Size) {
+	if (out_file->Used + Size > RESULTS_BUFFER_SIZE) results_flush(out_file);
+	return out_file->Buffer + out_file->Used;
+}
+
+void results_write_str(t_results_file* out_file, const char* Str, size_t Size) {
+	while (Size > 0) {
+		size_t Part = min(Size, (size_t)RESULTS_BUFFER_SIZE);
+		memcpy(results_reserve(out_file, Part), Str, Part);
+		out_file->Used += Part;
+		Str            += Part;
+		Size           -= Part;
+	}
+}
+
+void results_write_str(t_results_file* out_file, string Str) {
+	results_write_str(out_file, Str.data(), Str.size());
+}
+
+static void results_write_padded(t_results_file* out_file, const char* Str, int Len, int Width) {
+	int   Pad = max(0, Width - Len);
+	char* p   = results_reserve(out_file, Pad + Len);
+
+	memset(p, ' ', Pad);
+	memcpy(p + Pad, Str, Len);
+	out_file->Used += Pad + Len;
+}
+
+// Right-aligned in Width characters (setw)
+void results_write_int(t_results_file* out_file, long Value, int Width) {
+	char  Digits[24];
+	char* p        = Digits + sizeof(Digits);
+	unsigned long Abs_Value = (Value < 0) ? 0UL - (unsigned long)Value : (unsigned long)Value;
+
+	do { *--p = '0' + (Abs_Value % 10); Abs_Value /= 10; } while (Abs_Value != 0);
+	if (Value < 0) *--p = '-';
+
+	results_write_padded(out_file, p, Digits + sizeof(Digits) - p, Width);
+}
+
+// Right-aligned in Width characters with Precision decimals (setw, fixed, setprecision)
+//   A float scaled by 10^Precision (Precision <= 6) is exact in a double, so
+//   rounding it to the nearest integer (ties to even) gives the digits printf prints
+void results_write_fixed(t_results_file* out_file, float Value, int Width, int Precision) {
+	static const double Scale[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6};
+	char  Digits[64];
+	char* p;
+	int   Len;
+
+	double Scaled = fabs((double)Value) * Scale[min(max(Precision, 0), 6)];
+
+	if ((Precision < 0) || (Precision > 6) || !(Scaled < 9.0e18)) {
+		// Large values, inf and nan
+		Len = snprintf(Digits, sizeof(Digits), "%.*f", Precision, (double)Value);
+		p   = Digits;
+	} else {
+		unsigned long long Integer = (unsigned long long)nearbyint(Scaled);
+
+		p = Digits + sizeof(Digits);
+		for (int i=0; i<Precision; i++) { *--p = '0' + (Integer % 10); Integer /= 10; }
+		if (Precision > 0) *--p = '.';
+		do { *--p = '0' + (Integer % 10); Integer /= 10; } while (Integer != 0);
+		if (signbit(Value)) *--p = '-';
+		Len = Digits + sizeof(Digits) - p;
+	}
+
+	results_write_padded(out_file, p, Len, Width);
+}
+
+void results_write_bin(t_results_file* out_file, float* RES, int Nb_Of_Results) {
+	results_write_str(out_file, (const char*)RES, Nb_Of_Results * sizeof(float));
+	out_file->Nb_Of_Results += Nb_Of_Results;
+}
+
+void open_results_file(string SW_HW_Mode, string Out_File_Name, t_results_file* out_file) {
 	string Report_Type;
-	unsigned nb_of_columns = column_names.size();
 
 	if (SW_HW_Mode == "sw") Report_Type = "SW Model results";
 	else Report_Type = "HW results";
 
-	out_file.open(Out_File_Name,ios::out);
-    if (!out_file.is_open()) {
-    	cout << "HOST_ERROR: Unable to open a file for write: " << Out_File_Name << endl << endl;
+	const char* Format = getenv("BINOMIAL_RESULTS_FORMAT");
+	if ((Format != NULL) && (strcmp(Format, "table") != 0) && (strcmp(Format, "bin") != 0)) {
+		cout << endl << "HOST-Error: BINOMIAL_RESULTS_FORMAT does not support the following value: " << Format << endl;
+		cout <<         "            Supported values are: table, bin" << endl << endl;
+		exit(1);
+	}
+
+	out_file->Binary        = (Format != NULL) && (strcmp(Format, "bin") == 0);
+	out_file->File_Name     = Out_File_Name;
+	out_file->Nb_Of_Results = 0;
+	out_file->Used          = 0;
+
+	if (out_file->Binary) {
+		size_t Dot = Out_File_Name.rfind('.');
+		out_file->File_Name = ((Dot == string::npos) ? Out_File_Name : Out_File_Name.substr(0, Dot)) + ".bin";
+		cout << "HOST-Info: BINOMIAL_RESULTS_FORMAT=bin: results are written to the " << out_file->File_Name << " file" << endl;
+	}
+
+	out_file->fd = open(out_file->File_Name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out_file->fd < 0) {
+    	cout << "HOST_ERROR: Unable to open a file for write: " << out_file->File_Name << endl << endl;
     	exit(1);
     }
+	out_file->Buffer = allocate_host_mem<char>(RESULTS_BUFFER_SIZE, "the results buffer", false);
+
+	if (out_file->Binary) {
+		// Nb_Of_Results is set by close_results_file
+		t_results_header Header;
+		memset(&Header, 0, sizeof(Header));
+		memcpy(Header.Magic, RESULTS_MAGIC, sizeof(Header.Magic));
+		Header.Record_Size = sizeof(float);
+		results_write_str(out_file, (const char*)&Header, sizeof(Header));
+		return;
+	}
+
+	results_write_str(out_file, "===================================================\n");
+	results_write_str(out_file, " Binomial Options Pricing Model: " + Report_Type + "\n");
+	results_write_str(out_file, "===================================================\n");
+	results_write_str(out_file, "\n");
+}
+
+void close_results_file(t_results_file* out_file) {
+	results_flush(out_file);
+
+	if (out_file->Binary) {
+		uint64_t Nb_Of_Results = out_file->Nb_Of_Results;
+		if (pwrite(out_file->fd, &Nb_Of_Results, sizeof(Nb_Of_Results), offsetof(t_results_header, Nb_Of_Results)) != sizeof(Nb_Of_Results)) {
+			cout << "HOST_ERROR: Unable to write the " << out_file->File_Name << " file (" << strerror(errno) << ")" << endl << endl;
+			exit(1);
+		}
+	}
+
+	close(out_file->fd);
+	free(out_file->Buffer);
+	out_file->Buffer = NULL;
+}
+
+// Table header line ("----...") of nb_of_columns*12 characters
+static void results_write_rule(t_results_file* out_file, unsigned nb_of_columns) {
+	char* p = results_reserve(out_file, nb_of_columns*12 + 1);
+	memset(p, '-', nb_of_columns*12);
+	p[nb_of_columns*12] = '\n';
+	out_file->Used += nb_of_columns*12 + 1;
+}
+
+void store_results_chunk(t_results_file* out_file, t_in_data* host_IN_DATA, float* hw_RES, vector<test_config_t>* Test_Config, int Start_Index, int Nb_Of_Results) {
+	vector<string> column_names = {"T","S","K","r","sigma","q","n","BOPM_Result"};
+	unsigned nb_of_columns = column_names.size();
 
-    out_file << "===================================================" << endl;
-    out_file << " Binomial Options Pricing Model: " + Report_Type << endl;
-    out_file << "===================================================" << endl;
-    out_file << endl;
-
-    int global_indx = 0;
-    for (unsigned i=0; i<(*Test_Config).size(); i++) {
-    	out_file << fixed << setprecision(3);
-
-    	for(unsigned k=0; k<nb_of_columns*12; k++)
-    		out_file << "-";
-
-    	out_file << endl;
-    	out_file << "Company: " << (*Test_Config)[i].Company_Name;
-    	out_file << " (K_Step=" << (*Test_Config)[i].K_Step;
-    	out_file << " #tests="<< (*Test_Config)[i].NB_OF_TESTS << ")" << endl;
-
-    	// -------------------
-    	// Print Table Header
-    	// -------------------
-    	for(unsigned k=0; k<nb_of_columns*12; k++)
-    		out_file << "-";
-    	out_file << endl;
-    	for(unsigned k=0; k<nb_of_columns;    k++)
-    		out_file << setw(12) << column_names[k]+ " | ";
-    	out_file << endl;
-    	for(unsigned k=0; k<nb_of_columns*12; k++)
-    		out_file << "-";
-    	out_file << endl;
+	if (out_file->Binary) {
+		results_write_bin(out_file, hw_RES, Nb_Of_Results);
+		return;
+	}
+
+    int indx        = 0;
+    int Config_Base = 0;     // Global index of the first test of (*Test_Config)[i]
+
+    for (unsigned i=0; (i<(*Test_Config).size()) && (indx<Nb_Of_Results); i++) {
+    	test_config_t* Config = &(*Test_Config)[i];
+    	int k = Start_Index + indx - Config_Base;
+
+    	if (k >= Config->NB_OF_TESTS) {
+    		Config_Base += Config->NB_OF_TESTS;
+    		continue;
+    	}
+
+    	if (k == 0) {
+	    	results_write_rule(out_file, nb_of_columns);
+	    	results_write_str  (out_file, "Company: " + Config->Company_Name + " (K_Step=");
+	    	results_write_fixed(out_file, Config->K_Step, 0, 3);
+	    	results_write_str  (out_file, " #tests=");
+	    	results_write_int  (out_file, Config->NB_OF_TESTS, 0);
+	    	results_write_str  (out_file, ")\n");
+
+	    	// -------------------
+	    	// Print Table Header
+	    	// -------------------
+	    	results_write_rule(out_file, nb_of_columns);
+	    	for(unsigned c=0; c<nb_of_columns;    c++) {
+	    		string Name = column_names[c] + " | ";
+	    		results_write_padded(out_file, Name.data(), Name.size(), 12);
+	    	}
+	    	results_write_str(out_file, "\n");
+	    	results_write_rule(out_file, nb_of_columns);
+    	}
 
     	// -------------------------------
     	// Print Test Vectors and Results
     	// -------------------------------
-    	for (int k=0; k<(*Test_Config)[i].NB_OF_TESTS; k++) {
-    		out_file << fixed;
-    		out_file <<   setw(9)                    << (*Test_Config)[i].T;
-    		out_file <<  setw(12) << setprecision(3) << (*Test_Config)[i].S;
-    		out_file <<  setw(12) << setprecision(3) << host_IN_DATA[global_indx].K;
-    		out_file <<  setw(12) << setprecision(3) << (*Test_Config)[i].r;
-    		out_file <<  setw(12) << setprecision(3) << (*Test_Config)[i].sigma;
-    		out_file <<  setw(12) << setprecision(3) << (*Test_Config)[i].q;
-    		out_file <<  setw(12)                    << (*Test_Config)[i].n;
-    		out_file <<  setw(14) << setprecision(5) << hw_RES[global_indx];
-    		out_file << endl;
-    		global_indx++;
+    	for (; (k<Config->NB_OF_TESTS) && (indx<Nb_Of_Results); k++) {
+    		results_write_int  (out_file, Config->T,          9);
+    		results_write_fixed(out_file, Config->S,         12, 3);
+    		results_write_fixed(out_file, host_IN_DATA[indx].K, 12, 3);
+    		results_write_fixed(out_file, Config->r,         12, 3);
+    		results_write_fixed(out_file, Config->sigma,     12, 3);
+    		results_write_fixed(out_file, Config->q,         12, 3);
+    		results_write_int  (out_file, Config->n,         12);
+    		results_write_fixed(out_file, hw_RES[indx],      14, 5);
+    		results_write_str  (out_file, "\n");
+    		indx++;
     	}
-    	out_file << endl;
+    	if (k == Config->NB_OF_TESTS)
+    		results_write_str(out_file, "\n");
+
+    	Config_Base += Config->NB_OF_TESTS;
     }
-    out_file.close();
+}
+
+void store_results(string SW_HW_Mode, string Out_File_Name, t_in_data* host_IN_DATA, float* hw_RES, vector<test_config_t>* Test_Config) {
+	t_results_file out_file;
+	int            Nb_Of_Results = 0;
+
+	for (unsigned i=0; i<(*Test_Config).size(); i++) Nb_Of_Results += (*Test_Config)[i].NB_OF_TESTS;
+
+	open_results_file(SW_HW_Mode, Out_File_Name, &out_file);
+	store_results_chunk(&out_file, host_IN_DATA, hw_RES, Test_Config, 0, Nb_Of_Results);
+	close_results_file(&out_file);
 }
@@ -25,6 +25,7 @@
 #include <cstring>
 #include <stdlib.h>
 #include <vector>
+#include <stdint.h>
 
 #include <CL/cl.h>
 #include "kernel.h"
@@ -56,6 +57,23 @@ typedef struct {
 } test_config_t;
 
 
+// Number of tests priced at once by the streaming SW model (runs larger than MAX_NB_OF_TESTS)
+#ifndef SW_STREAM_CHUNK_SIZE
+#define SW_STREAM_CHUNK_SIZE 65536
+#endif
+
+// Number of buffers per kernel when QUEUE_DEPTH is not set in the SW_HW_config file
+#define DEFAULT_QUEUE_DEPTH 2
+
+// hw mode: max number of test vectors per CU in a slice (QUEUE_DEPTH slices per kernel are in flight)
+#ifndef HW_SLICE_TESTS_PER_CU
+#define HW_SLICE_TESTS_PER_CU 64
+#endif
+
+// Peak bandwidth of a memory bank (GB/s): DDR4-2400 64-bit channel, HBM2 pseudo-channel
+#define DDR_BANK_PEAK_GBps 19.2
+#define HBM_BANK_PEAK_GBps 14.4
+
 typedef struct {
     // ------------------------------------------------
     // SW Resources to be used
@@ -68,8 +86,19 @@ typedef struct {
     int   NB_OF_KERNELS;                      // set in a SW_HW_config file
     int   NB_OF_CUs_PER_KERNEL;               // set in a SW_HW_config file
     int   NB_OF_PARALLEL_FUNCTIONS_PER_CU;    // set in a SW_HW_config file
-    int   MAX_TREE_HEIGHT;                    // Set during Host Code execution. Max height of a Binomial tree supported by a Kernel (defined during kernel implementation)
-    int   MAX_NB_OF_TESTS;                    // Set during Host Code execution. Max number of test vectors supported by the application
+    int   QUEUE_DEPTH;                        // set in a SW_HW_config file (optional, DEFAULT_QUEUE_DEPTH). Number of buffers per kernel in flight
+    int   MAX_TREE_HEIGHT;                    // Set during Host Code execution. Max height of a Binomial tree supported by a Kernel (defined during kernel implementation, taller than CONST_MAX_TREE_HEIGHT trees are tiled)
+    int   MAX_NB_OF_TESTS;                    // Set during Host Code execution. Max number of test vectors processed at once (larger runs are streamed in chunks)
+
+    // ------------------------------------------------
+    // Memory Topology
+    // ------------------------------------------------
+    vector<string> MEM_BANK;                  // set in a SW_HW_config file (one MEM_BANK line per kernel). Memory bank ("DDR[i]" or "HBM[i]") of the buffers of each kernel
+
+    // ------------------------------------------------
+    // Kernel Implementation
+    // ------------------------------------------------
+    string KERNEL_TYPE;                       // set in a SW_HW_config file (optional, "bram"). "bram": K_americanPut_<k>, "dataflow": K_americanPut_df_<k>
 
     // ------------------------------------------------
     // Debug Information
@@ -80,6 +109,16 @@ typedef struct {
 
 
 
+// Config file tokenizer: whole file in one '\0' terminated buffer, lines cut in place
+#define CFG_MAX_TOKENS_PER_LINE 16
+
+void   cfg_read_file  (const char* File_Name, vector<char>* Buffer);
+char*  cfg_next_line  (char** Pos, char* End);
+int    cfg_split_line (char* Line, char** Tokens, int Max_Tokens);
+string cfg_line_string(char** Tokens, int Nb_Of_Tokens);
+int    cfg_to_int     (const char* Token, const char* File_Name, int Line_Nb);
+float  cfg_to_float   (const char* Token, const char* File_Name, int Line_Nb);
+
 void read_sw_hw_config_file (const char* SW_HW_Config_File_Name, sw_hw_config_t* SW_HW_Config);
 void print_sw_hw_config_info(sw_hw_config_t SW_HW_Config);
 
@@ -87,7 +126,13 @@ void read_test_config_file (const char* Test_Config_File_Name,  vector<test_conf
 void print_test_config_info(vector<test_config_t>  *Test_Config);
 
 void process_configurations(string sw_hw, sw_hw_config_t* SW_HW_Config, vector<test_config_t>* Test_Config, int *DEFINED_NB_OF_TESTS, int *ROUNDED_NB_OF_TESTS);
+int  get_max_tree_height(vector<test_config_t>* Test_Config);
+
+string   kernel_name(sw_hw_config_t* SW_HW_Config, int Kernel_Index);
+unsigned kernel_mem_flags(sw_hw_config_t* SW_HW_Config, int Kernel_Index);
+void     print_mem_bank_bandwidth(sw_hw_config_t* SW_HW_Config, int Nb_Of_Transfers, cl_event* Mem_op_event, int* Transfer_Kernel, size_t* Transfer_Bytes);
 void generate_test_vectors(t_in_data* host_IN_DATA, vector<test_config_t> Test_Config, int ROUNDED_NB_OF_TESTS);
+void generate_test_vectors(t_in_data* host_IN_DATA, vector<test_config_t>* Test_Config, int Start_Index, int Nb_Of_Tests);
 
 // =======================================================
 // Helper Function: Allocate HOST Memory aligned to 4096
@@ -106,10 +151,46 @@ T* allocate_host_mem(size_t number_of_elements, string mem_name, bool print_mess
 	return reinterpret_cast<T*>(ptr);
 }
 
-double run_custom_profiling (int Nb_Of_Kernels, int Nb_Of_Memory_Tranfers, cl_event* K_exe_event, cl_event* Mem_op_event,string* list_of_kernel_names);
+// list_of_transfer_names/list_of_tracks (optional): names of the memory transfers and
+// timeline trace track of every event (kernels first), see trace_functions.h
+double run_custom_profiling (int Nb_Of_Kernels, int Nb_Of_Memory_Tranfers, cl_event* K_exe_event, cl_event* Mem_op_event,string* list_of_kernel_names,
+                             string* list_of_transfer_names = NULL, string* list_of_tracks = NULL);
 
 int compare_results(float* sw_Res, float* hw_Res, int Nb_of_Results, int Nb_Of_Errors_To_Reports);
 int cmp_floats(float val1, float val2);
 
+// ----------------------------------------------------------------------------
+// Results files: report table (default) or, with BINOMIAL_RESULTS_FORMAT=bin,
+// a binary file: t_results_header followed by one float per test
+// ----------------------------------------------------------------------------
+#define RESULTS_MAGIC       "BOPM_RS1"
+#define RESULTS_BUFFER_SIZE (1 << 20)           // Results are written in blocks of this size
+
+typedef struct {
+	char     Magic[8];                          // RESULTS_MAGIC (no '\0')
+	uint32_t Record_Size;                       // sizeof(float)
+	uint32_t Reserved;
+	uint64_t Nb_Of_Results;
+} t_results_header;
+
+typedef struct {
+	string   File_Name;
+	int      fd;
+	bool     Binary;
+	uint64_t Nb_Of_Results;                     // Binary file: results written so far
+	char*    Buffer;                            // RESULTS_BUFFER_SIZE bytes block
+	size_t   Used;
+} t_results_file;
+
 void store_results(string SW_HW_Mode, string Out_File_Name, t_in_data* host_IN_DATA, float* hw_res, vector<test_config_t>* Test_Config);
+void open_results_file  (string SW_HW_Mode, string Out_File_Name, t_results_file* out_file);
+void close_results_file (t_results_file* out_file);
+void store_results_chunk(t_results_file* out_file, t_in_data* host_IN_DATA, float* hw_RES, vector<test_config_t>* Test_Config, int Start_Index, int Nb_Of_Results);
+
+// Buffered formatting (same text as setw / fixed / setprecision)
+void results_write_str  (t_results_file* out_file, const char* Str, size_t Size);
+void results_write_str  (t_results_file* out_file, string Str);
+void results_write_int  (t_results_file* out_file, long Value, int Width);
+void results_write_fixed(t_results_file* out_file, float Value, int Width, int Precision);
+void results_write_bin  (t_results_file* out_file, float* RES, int Nb_Of_Results);
 #endif
@@ -0,0 +1,70 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#ifndef __HLS_STREAM_SW_H__
+#define __HLS_STREAM_SW_H__
+
+#include <deque>
+#include <string>
+#include <iostream>
+#include <cstdlib>
+
+// ============================================================================
+// hls::stream for plain C++ builds of the kernels (SW OpenCL backend)
+//   Same semantics as the C simulation model of Vivado HLS: an unbounded
+//   FIFO, reading an empty stream is an error. The dataflow processes are
+//   called one after the other, so the FIFO holds all records between two
+//   processes.
+// ============================================================================
+namespace hls {
+
+template <typename T>
+class stream {
+public:
+	stream()                   : Name("stream") {}
+	stream(const char* name)   : Name(name)     {}
+
+	void write(const T& Value) { Fifo.push_back(Value); }
+	void operator<<(const T& Value) { write(Value); }
+
+	T read() {
+		if (Fifo.empty()) {
+			std::cout << "HOST-Error: hls::stream " << Name << " is read while empty" << std::endl;
+			exit(1);
+		}
+		T Value = Fifo.front();
+		Fifo.pop_front();
+		return Value;
+	}
+	void operator>>(T& Value)  { Value = read(); }
+
+	bool empty() const         { return Fifo.empty(); }
+	bool full()  const         { return false; }
+	size_t size() const        { return Fifo.size(); }
+
+private:
+	stream(const stream&);
+	stream& operator=(const stream&);
+
+	std::string   Name;
+	std::deque<T> Fifo;
+};
+
+}
+
+#endif
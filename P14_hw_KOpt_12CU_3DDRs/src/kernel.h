@@ -22,9 +22,47 @@
 #define CONST_MAX_TREE_HEIGHT 1024
 #define CONST_MAX_NB_OF_TESTS 1024
 
+// Number of parallel hw_calc_p0 functions (pricing engines) per CU. The same sources build 1/2/4/8-way kernels:
+// compile the kernels and the Host code with -DCONST_NB_OF_PARALLEL_FUNCTIONS=<N>. The Host checks that
+// NB_OF_PARALLEL_FUNCTIONS_PER_CU in the SW_HW_config file has the same value.
+#ifndef CONST_NB_OF_PARALLEL_FUNCTIONS
+#define CONST_NB_OF_PARALLEL_FUNCTIONS 4
+#endif
+
+// Cyclic partition factor of the BRAM buffers read/written by the parallel functions (2 ports per partition)
+#define CONST_PARTITION_FACTOR ((CONST_NB_OF_PARALLEL_FUNCTIONS+1)/2)
+
+// Trees taller than CONST_MAX_TREE_HEIGHT are calculated in tiles: the p column is stored in Global Memory and
+// a tile (CONST_TILE_WIDTH + CONST_TILE_HEIGHT values) is calculated in the CONST_MAX_TREE_HEIGHT BRAM buffer
+#define CONST_MAX_TILED_TREE_HEIGHT 65536
+#define CONST_TILE_HEIGHT 256
+#define CONST_TILE_WIDTH  (CONST_MAX_TREE_HEIGHT - CONST_TILE_HEIGHT)
+
+// Exercise values K - S*up^k read by hw_calc_p0_*: 2n+1 values per tree (n <= CONST_MAX_TREE_HEIGHT) or, for tiled
+// trees, up to 2*(CONST_TILE_WIDTH + CONST_TILE_HEIGHT) + CONST_TILE_HEIGHT - 4 values per tile.
+// One BRAM buffer per parallel function: 2304 floats = 5 BRAM_18K, i.e. 20 BRAM_18K per 4-function CU and 240 for
+// the 12 CUs (~6% of the U200 BRAM_18K).
+#define CONST_EXERCISE_LUT_SIZE (2*CONST_MAX_TREE_HEIGHT + CONST_TILE_HEIGHT)
+
+// Dataflow kernels (K_americanPut_df_*): depth of the streams between the read, calculate and write processes.
+// The test vectors are not stored in BRAM, CONST_MAX_DF_NB_OF_TESTS only limits the size of the Host buffers.
+#define CONST_DF_STREAM_DEPTH    16
+#define CONST_MAX_DF_NB_OF_TESTS 65536
+
 typedef struct {
 	int T; float S; float K; float r; float sigma; float q; int n;
 	float dummy_val;
 } t_in_data;
 
+// Kernel inputs: the tests with the same T, r, sigma, q and n share one tree. The Host calculates the parameters
+// of every tree once (t_tree_params, see tree_functions.h) and sends one t_in_option record per test, which gives
+// the index of the tree of the test in the tree buffer of the kernel run (12 bytes per test instead of 32).
+typedef struct {
+	float S; float K; int Tree;
+} t_in_option;
+
+typedef struct {
+	int n; float up; float p0; float p1;
+} t_tree_params;
+
 #endif
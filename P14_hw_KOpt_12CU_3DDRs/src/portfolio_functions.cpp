@@ -0,0 +1,417 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+
+using namespace std;
+
+#include <CL/cl.h>
+#include <CL/cl_ext.h>
+
+#include "kernel.h"
+#include "help_functions.h"
+#include "host_functions.h"
+#include "server_functions.h"
+#include "scheduler_functions.h"
+#include "portfolio_functions.h"
+#include "time_functions.h"
+
+void K_americanPut_sw_model(t_in_data* host_IN_DATA, float* sw_RES, int NB_OF_TESTS, int Nb_Of_Threads);
+
+static bool has_extension(const char* File_Name, const char* Extension) {
+	size_t Name_Len = strlen(File_Name);
+	size_t Ext_Len  = strlen(Extension);
+	return (Name_Len > Ext_Len) && (strcmp(File_Name + Name_Len - Ext_Len, Extension) == 0);
+}
+
+bool is_portfolio_file(const char* File_Name) {
+	return has_extension(File_Name, ".bin") || has_extension(File_Name, ".csv");
+}
+
+
+// ==================================================
+// Check a contract
+//   Same range checks as process_configurations (n)
+//   plus the values the model divides by
+// ==================================================
+static void check_contract(t_in_data* Contract, sw_hw_config_t* SW_HW_Config, const char* File_Name, const char* Location, long Index) {
+	if ((Contract->n <= 0) || (Contract->n > (*SW_HW_Config).MAX_TREE_HEIGHT) || (Contract->T <= 0) || !(Contract->sigma > 0.0f)) {
+		cout << endl << "HOST-Error: " << File_Name << " (" << Location << " " << Index << "):  Incorrect contract (T=" << Contract->T << ", sigma=" << Contract->sigma << ", n=" << Contract->n << ")" << endl;
+		cout <<         "            The values should be: T>0, sigma>0, n in [1...MAX_TREE_HEIGHT(" << (*SW_HW_Config).MAX_TREE_HEIGHT << ")]" << endl;
+		exit(1);
+	}
+}
+
+
+// ==================================================
+// Binary portfolio: map the file, the records are
+// read from the mapping (no load copy)
+// ==================================================
+static void read_portfolio_bin(const char* File_Name, sw_hw_config_t* SW_HW_Config, t_portfolio* Portfolio) {
+	struct stat File_Stat;
+
+	int fd = open(File_Name, O_RDONLY);
+	if ((fd < 0) || (fstat(fd, &File_Stat) != 0)) {
+	    cout << endl << "HOST-Error: Failed to open the " <<  File_Name << " for read" << endl << endl;
+	    exit(1);
+	}
+
+	if (File_Stat.st_size < PORTFOLIO_HEADER_SIZE) {
+		cout << endl << "HOST-Error: The " << File_Name << " file is not a portfolio file (" << File_Stat.st_size << " bytes)" << endl;
+		exit(1);
+	}
+
+	void* Map = mmap(NULL, File_Stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (Map == MAP_FAILED) {
+		cout << endl << "HOST-Error: Failed to map the " << File_Name << " file (" << strerror(errno) << ")" << endl;
+		exit(1);
+	}
+
+	t_portfolio_header* Header = (t_portfolio_header*)Map;
+
+	if ((memcmp(Header->Magic, PORTFOLIO_MAGIC, sizeof(Header->Magic)) != 0) || (Header->Record_Size != sizeof(t_in_data))) {
+		cout << endl << "HOST-Error: The " << File_Name << " file is not a portfolio file" << endl;
+		cout <<         "            Expected: \"" << PORTFOLIO_MAGIC << "\" header with " << sizeof(t_in_data) << " bytes records" << endl;
+		exit(1);
+	}
+
+	if ((Header->Nb_Of_Contracts > INT_MAX) ||
+	    ((uint64_t)File_Stat.st_size != PORTFOLIO_HEADER_SIZE + Header->Nb_Of_Contracts * sizeof(t_in_data))) {
+		cout << endl << "HOST-Error: The size of the " << File_Name << " file (" << File_Stat.st_size << " bytes) does not match Nb_Of_Contracts=" << Header->Nb_Of_Contracts << endl;
+		exit(1);
+	}
+
+	Portfolio->Map             = Map;
+	Portfolio->Map_Size        = File_Stat.st_size;
+	Portfolio->IN_DATA         = (t_in_data*)((char*)Map + PORTFOLIO_HEADER_SIZE);
+	Portfolio->Nb_Of_Contracts = (int)Header->Nb_Of_Contracts;
+
+	madvise(Map, Portfolio->Map_Size, MADV_SEQUENTIAL);
+
+	for (int i=0; i<Portfolio->Nb_Of_Contracts; i++)
+		check_contract(&Portfolio->IN_DATA[i], SW_HW_Config, File_Name, "contract", i);
+}
+
+
+// ==================================================
+// CSV portfolio: "T,S,K,r,sigma,q,n" per line
+// ==================================================
+static bool parse_csv_contract(char* p, t_in_data* Contract) {
+	char* End;
+
+	for (int Field=0; Field<7; Field++) {
+		while ((*p == ' ') || (*p == '\t')) p++;
+
+		switch (Field) {
+			case 0: Contract->T     = (int)strtol(p, &End, 10); break;
+			case 1: Contract->S     = strtof(p, &End);          break;
+			case 2: Contract->K     = strtof(p, &End);          break;
+			case 3: Contract->r     = strtof(p, &End);          break;
+			case 4: Contract->sigma = strtof(p, &End);          break;
+			case 5: Contract->q     = strtof(p, &End);          break;
+			case 6: Contract->n     = (int)strtol(p, &End, 10); break;
+			default: break;
+		}
+		if (End == p) return false;
+
+		p = End;
+		while ((*p == ' ') || (*p == '\t') || (*p == '\r')) p++;
+		if (Field < 6) {
+			if (*p != ',') return false;
+			p++;
+		}
+	}
+	Contract->dummy_val = 0.0f;
+
+	return (*p == '\0') || (*p == '#');
+}
+
+static void read_portfolio_csv(const char* File_Name, sw_hw_config_t* SW_HW_Config, t_portfolio* Portfolio) {
+	vector<char> Buffer;
+	char*        in_line;
+	int          line_nb      = 0;
+	bool         First_Record = true;
+	t_in_data    Contract;
+
+	cfg_read_file(File_Name, &Buffer);
+
+	char* Pos = Buffer.data();
+	char* End = Buffer.data() + Buffer.size() - 1;
+
+	Portfolio->Records.reserve(count(Pos, End, '\n') + 1);
+
+	while ((in_line = cfg_next_line(&Pos, End)) != NULL) {
+		line_nb ++;
+
+		char* p = in_line;
+		while ((*p == ' ') || (*p == '\t') || (*p == '\r')) p++;
+		if ((*p == '\0') || (*p == '#')) continue;
+
+		// Optional header line ("T,S,K,r,sigma,q,n")
+		if (First_Record && isalpha((unsigned char)*p)) {
+			First_Record = false;
+			continue;
+		}
+		First_Record = false;
+
+		if (!parse_csv_contract(p, &Contract)) {
+			cout << endl << "HOST-Error: " << File_Name << " (line " << line_nb << "):  Incorrect contract: " << in_line << endl;
+			cout <<         "            Expected: T,S,K,r,sigma,q,n" << endl;
+			exit(1);
+		}
+		check_contract(&Contract, SW_HW_Config, File_Name, "line", line_nb);
+
+		if (Portfolio->Records.size() == INT_MAX) {
+			cout << endl << "HOST-Error: Number of contracts in the " << File_Name << " file exceeds " << INT_MAX << endl;
+			exit(1);
+		}
+		Portfolio->Records.push_back(Contract);
+	}
+
+	Portfolio->IN_DATA         = Portfolio->Records.data();
+	Portfolio->Nb_Of_Contracts = (int)Portfolio->Records.size();
+}
+
+
+// ==================================================
+// Read Portfolio File (.bin or .csv)
+// ==================================================
+void read_portfolio_file(const char* File_Name, sw_hw_config_t* SW_HW_Config, t_portfolio* Portfolio) {
+	Portfolio->File_Name       = File_Name;
+	Portfolio->IN_DATA         = NULL;
+	Portfolio->Nb_Of_Contracts = 0;
+	Portfolio->Map             = NULL;
+	Portfolio->Map_Size        = 0;
+	Portfolio->Records.clear();
+
+	if (has_extension(File_Name, ".csv"))
+		read_portfolio_csv(File_Name, SW_HW_Config, Portfolio);
+	else
+		read_portfolio_bin(File_Name, SW_HW_Config, Portfolio);
+
+	if (Portfolio->Nb_Of_Contracts == 0) {
+		cout << endl << "HOST-Error: No contracts were found in the " << File_Name << " file." << endl;
+		exit(1);
+	}
+}
+
+void release_portfolio(t_portfolio* Portfolio) {
+	if (Portfolio->Map != NULL)
+		munmap(Portfolio->Map, Portfolio->Map_Size);
+
+	Portfolio->Map             = NULL;
+	Portfolio->IN_DATA         = NULL;
+	Portfolio->Nb_Of_Contracts = 0;
+	vector<t_in_data>().swap(Portfolio->Records);
+}
+
+
+// ==================================================
+// Store Portfolio Results (one line per contract,
+// in the order of the portfolio file)
+// ==================================================
+void store_portfolio_results(string SW_HW_Mode, string Out_File_Name, t_portfolio* Portfolio, float* RES) {
+	vector<string> column_names = {"T","S","K","r","sigma","q","n","BOPM_Result"};
+	unsigned       nb_of_columns = column_names.size();
+	string         Rule(nb_of_columns*12, '-');
+	t_results_file out_file;
+
+	open_results_file(SW_HW_Mode, Out_File_Name, &out_file);
+
+	if (out_file.Binary) {
+		results_write_bin(&out_file, RES, Portfolio->Nb_Of_Contracts);
+		close_results_file(&out_file);
+		return;
+	}
+
+	results_write_str(&out_file, Rule + "\n");
+	results_write_str(&out_file, "Portfolio: " + Portfolio->File_Name + " (#contracts=" + to_string(Portfolio->Nb_Of_Contracts) + ")\n");
+
+	results_write_str(&out_file, Rule + "\n");
+	for(unsigned c=0; c<nb_of_columns; c++) {
+		string Name = column_names[c] + " | ";
+		results_write_str(&out_file, string(max(0, 12 - (int)Name.size()), ' ') + Name);
+	}
+	results_write_str(&out_file, "\n" + Rule + "\n");
+
+	for (int i=0; i<Portfolio->Nb_Of_Contracts; i++) {
+		t_in_data* Contract = &Portfolio->IN_DATA[i];
+
+		results_write_int  (&out_file, Contract->T,      9);
+		results_write_fixed(&out_file, Contract->S,     12, 3);
+		results_write_fixed(&out_file, Contract->K,     12, 3);
+		results_write_fixed(&out_file, Contract->r,     12, 3);
+		results_write_fixed(&out_file, Contract->sigma, 12, 3);
+		results_write_fixed(&out_file, Contract->q,     12, 3);
+		results_write_int  (&out_file, Contract->n,     12);
+		results_write_fixed(&out_file, RES[i],          14, 5);
+		results_write_str  (&out_file, "\n");
+	}
+
+	close_results_file(&out_file);
+}
+
+
+// ============================================================================
+// Price a Portfolio
+//   o) sw        : SW model with NB_OF_THREADS threads
+//   o) hw        : pricer of the hw_server mode (batches of MAX_NB_OF_TESTS
+//                  tests per kernel)
+//   o) hw_dynamic: dynamic CU scheduler
+//   o) hybrid    : dynamic CU scheduler + SW threads
+//   The contracts are priced through the result cache (the SW reference of
+//   the HW modes is not).
+// ============================================================================
+int run_portfolio(string SW_HW_Mode, sw_hw_config_t* SW_HW_Config, t_result_cache* Cache, const char* Portfolio_File_Name,
+                  const char* Target_Platform_Vendor, const char* Target_Device_Name, const char* xclbinFilename) {
+	t_portfolio Portfolio;
+	double      tstart, tstop;
+
+	cout << endl;
+	cout << "HOST-Info: ============================================================= " << endl;
+	cout << "HOST-Info: Step: Load Portfolio                                          " << endl;
+	cout << "HOST-Info: ============================================================= " << endl;
+
+	tstart = get_time_ms();
+	read_portfolio_file(Portfolio_File_Name, SW_HW_Config, &Portfolio);
+	tstop  = get_time_ms();
+
+	int NB_OF_CONTRACTS = Portfolio.Nb_Of_Contracts;
+
+	cout << "HOST-Info: " << NB_OF_CONTRACTS << " contracts loaded in " << fixed << setprecision(1) << (tstop-tstart) << " ms ("
+	     << ((Portfolio.Map != NULL) ? "memory-mapped" : "CSV") << ")" << endl;
+
+	// ---------------------------------------------------------
+	// SW model: results of the sw mode, reference of the others
+	// ---------------------------------------------------------
+	cout << endl;
+	cout << "HOST-Info: ============================================================= " << endl;
+	cout << "HOST-Info: Step: Price Portfolio (" << SW_HW_Mode << ")" << endl;
+	cout << "HOST-Info: ============================================================= " << endl;
+
+	float* sw_RES = allocate_host_mem<float>(NB_OF_CONTRACTS,"sw_RES",true);
+
+	int Nb_Of_Threads = (*SW_HW_Config).NB_OF_THREADS;
+
+	auto Price_SW = [Nb_Of_Threads](t_in_data* Batch_IN_DATA, float* Batch_RES, int Nb_Of_Tests) {
+		K_americanPut_sw_model(Batch_IN_DATA, Batch_RES, Nb_Of_Tests, Nb_Of_Threads);
+	};
+
+	tstart = get_time_ms();
+	if (SW_HW_Mode == "sw")
+		result_cache_price(Cache, Portfolio.IN_DATA, sw_RES, NB_OF_CONTRACTS, Price_SW);
+	else
+		Price_SW(Portfolio.IN_DATA, sw_RES, NB_OF_CONTRACTS);
+	tstop  = get_time_ms();
+
+	if (SW_HW_Mode == "sw") {
+		cout << "HOST_Info: SW Model Execution"                                              << endl;
+		cout << "HOST_Info:     # Threads    = " <<  Nb_Of_Threads                           << endl;
+		cout << "HOST_Info:     # Contracts  = " <<  NB_OF_CONTRACTS                         << endl;
+		cout << "HOST_Info:     Runtime (ms) = " << fixed << setprecision(1) << (tstop-tstart) << endl << endl;
+		print_result_cache_stats(Cache);
+
+		store_portfolio_results(SW_HW_Mode, "SW_Res.txt", &Portfolio, sw_RES);
+		cout << "HOST-Info: Results stored in the SW_Res.txt file" << endl;
+
+		free(sw_RES);
+		release_portfolio(&Portfolio);
+		return 1;
+	}
+
+	// ---------------------------------------------------------
+	// HW pricing
+	// ---------------------------------------------------------
+	float* hw_RES = allocate_host_mem<float>(NB_OF_CONTRACTS,"hw_RES",true);
+
+	if (SW_HW_Mode == "hw") {
+		t_hw_pricer Pricer;
+
+		if (hw_pricer_init(&Pricer, SW_HW_Config, Target_Platform_Vendor, Target_Device_Name, xclbinFilename) != 1)
+			return 0;
+
+		tstart = get_time_ms();
+		result_cache_price(Cache, Portfolio.IN_DATA, hw_RES, NB_OF_CONTRACTS,
+			[&](t_in_data* Batch_IN_DATA, float* Batch_RES, int Nb_Of_Tests) {
+				hw_pricer_run(&Pricer, Batch_IN_DATA, Batch_RES, Nb_Of_Tests);
+			});
+		tstop  = get_time_ms();
+
+		hw_pricer_release(&Pricer);
+	} else {
+		cl_platform_id      *Platform_IDs, Target_Platform_ID;
+		cl_device_id        *Device_IDs,   Target_Device_ID;
+		cl_context          Context;
+		cl_command_queue    Command_Queue;
+		cl_program          Program;
+
+		Platform_IDs = NULL; Device_IDs = NULL;
+		if ( select_platform(Platform_IDs,&Target_Platform_ID, Target_Platform_Vendor) != 1)                  return 0;
+		if ( select_device(Device_IDs,&Target_Device_ID, Target_Platform_ID, Target_Device_Name) != 1)        return 0;
+		if ( create_context(&Context, Target_Device_ID) != 1)                                                 return 0;
+		if ( create_command_queue(&Context, &Command_Queue, CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE | CL_QUEUE_PROFILING_ENABLE, Target_Device_ID) != 1) return 0;
+		if ( build_program(&Program, xclbinFilename, Target_Device_ID, Context) != 1)                         return 0;
+
+		tstart = get_time_ms();
+		result_cache_price(Cache, Portfolio.IN_DATA, hw_RES, NB_OF_CONTRACTS,
+			[&](t_in_data* Batch_IN_DATA, float* Batch_RES, int Nb_Of_Tests) {
+				K_americanPut_hw_dynamic(Context, Command_Queue, Program, SW_HW_Config, Batch_IN_DATA, Batch_RES, Nb_Of_Tests, (SW_HW_Mode == "hybrid") ? Nb_Of_Threads : 0);
+			});
+		tstop  = get_time_ms();
+
+		clReleaseProgram(Program);
+		clReleaseCommandQueue(Command_Queue);
+		clReleaseContext(Context);
+		clReleaseDevice(Target_Device_ID);
+	}
+
+	int Nb_Of_Errors = compare_results(sw_RES, hw_RES, NB_OF_CONTRACTS, 5);
+
+	cout << endl;
+	cout << "HOST-Info:     NUMBER_OF_KERNELS      :  " << right << setw(10) << (*SW_HW_Config).NB_OF_KERNELS << endl;
+	cout << "HOST-Info:     NB_OF_CONTRACTS        :  " << right << setw(10) << NB_OF_CONTRACTS << endl;
+	cout << "HOST-Info:     Runtime (ms)           :  " << right << setw(10) << fixed << setprecision(1) << (tstop-tstart) << endl;
+	print_result_cache_stats(Cache);
+	cout << "HOST-Info: " << string(62, '-') << endl;
+
+	store_portfolio_results(SW_HW_Mode, "HW_Res.txt", &Portfolio, hw_RES);
+
+	free(sw_RES);
+	free(hw_RES);
+	release_portfolio(&Portfolio);
+
+	if (Nb_Of_Errors != 0) {
+		cout << "HOST_Info: Test Failed (#Errors=" << Nb_Of_Errors << ")" << endl << endl;
+		return 0;
+	}
+	cout << "HOST_Info: Test Passed" << endl;
+	cout << "HOST-Info: Results stored in the HW_Res.txt file" << endl;
+
+	return 1;
+}
@@ -0,0 +1,75 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#ifndef __PORTFOLIO_FUNCTIONS_H__
+#define __PORTFOLIO_FUNCTIONS_H__
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "help_functions.h"
+#include "cache_functions.h"
+
+using namespace std;
+
+// ============================================================================
+// Portfolio Files
+//   One contract per record, priced as is (no K_Step sweep). The file type
+//   is selected by the extension of the test config file argument:
+//
+//   o) <name>.bin: PORTFOLIO_HEADER_SIZE bytes header (t_portfolio_header)
+//      followed by Nb_Of_Contracts t_in_data records (host byte order, the
+//      layout of the kernel input). The file is memory-mapped: the SW model
+//      reads the records in place, the HW pricers copy each batch of
+//      records into the host buffers of their kernels (no OpenCL buffer
+//      wraps the mapping)
+//   o) <name>.csv: one "T,S,K,r,sigma,q,n" contract per line, '#' comments
+//      and an optional header line (first line starting with a letter)
+// ============================================================================
+#define PORTFOLIO_MAGIC       "BOPM_PF1"
+#define PORTFOLIO_HEADER_SIZE 4096
+
+typedef struct {
+	char     Magic[8];                          // PORTFOLIO_MAGIC (no '\0')
+	uint32_t Record_Size;                       // sizeof(t_in_data)
+	uint32_t Reserved;
+	uint64_t Nb_Of_Contracts;
+} t_portfolio_header;
+
+typedef struct {
+	string            File_Name;
+	t_in_data*        IN_DATA;                  // Nb_Of_Contracts records (mapped file or Records)
+	int               Nb_Of_Contracts;
+
+	void*             Map;                      // .bin: mapping of the whole file
+	size_t            Map_Size;
+	vector<t_in_data> Records;                  // .csv: parsed contracts
+} t_portfolio;
+
+bool is_portfolio_file   (const char* File_Name);
+void read_portfolio_file (const char* File_Name, sw_hw_config_t* SW_HW_Config, t_portfolio* Portfolio);
+void release_portfolio   (t_portfolio* Portfolio);
+void store_portfolio_results(string SW_HW_Mode, string Out_File_Name, t_portfolio* Portfolio, float* RES);
+
+// Prices the portfolio in sw, hw (pricer of the server), hw_dynamic or hybrid mode through the
+// result cache and checks the HW results with the SW model. Returns 1 when the test passed.
+int  run_portfolio(string SW_HW_Mode, sw_hw_config_t* SW_HW_Config, t_result_cache* Cache, const char* Portfolio_File_Name,
+                   const char* Target_Platform_Vendor, const char* Target_Device_Name, const char* xclbinFilename);
+
+#endif
@@ -0,0 +1,434 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+using namespace std;
+
+#include <CL/cl.h>
+#include <CL/cl_ext.h>
+
+#include "kernel.h"
+#include "help_functions.h"
+#include "host_functions.h"
+#include "stream_functions.h"
+#include "scheduler_functions.h"
+#include "time_functions.h"
+#include "tree_functions.h"
+
+void K_americanPut_sw_model_task(t_in_data* host_IN_DATA, float* sw_RES, int Nb_Of_Tests, int Start_Index);
+
+double sched_test_cost(int n) {
+	return 0.5 * ((double)n + 1.0) * ((double)n + 2.0);
+}
+
+typedef struct {
+	int    Start_Index;                     // First test of the chunk
+	int    Nb_Of_Tests;
+	double Cost;
+} t_sched_chunk;
+
+struct t_sched_state;
+
+typedef struct {
+	int              CU;                    // Index in the CU array
+	int              Chunk;                 // Chunk in flight (-1: free)
+	t_sched_state*   State;
+
+	t_in_option*     host_IBuf;
+	t_tree_params*   host_TBuf;
+	float*           host_OBuf;
+
+	cl_mem           GlobMem_IBuf;
+	cl_mem_ext_ptr_t GlobMem_IBuf_EXT;
+	cl_mem           GlobMem_TBuf;
+	cl_mem_ext_ptr_t GlobMem_TBuf_EXT;
+	cl_mem           GlobMem_OBuf;
+	cl_mem_ext_ptr_t GlobMem_OBuf_EXT;
+	cl_mem           GlobMem_CBuf;          // p columns of the trees taller than CONST_MAX_TREE_HEIGHT (Global Mem only)
+	cl_mem_ext_ptr_t GlobMem_CBuf_EXT;
+
+	cl_event         Mem_wr_event;
+	cl_event         K_exe_event;
+	cl_event         Mem_rd_event;
+} t_sched_slot;
+
+// Chunks not handed out yet: Order[Front..Back], most expensive first.
+// The CUs take chunks from the front, the SW threads from the back.
+struct t_sched_state {
+	mutex                 Mutex;
+	condition_variable    CV;
+	deque<t_sched_slot*>  Slots;                 // Slots returned by the completion callbacks
+	vector<int>           Order;
+	int                   Front;
+	int                   Back;
+};
+
+typedef struct {
+	string           name;                  // "K_americanPut_<k>_<cu>"
+	cl_kernel        kernel;
+	t_sched_slot*    Slot;                  // QUEUE_DEPTH slots
+
+	int              Nb_Of_Chunks;
+	int              Nb_Of_Tests;
+	double           Busy_ms;
+} t_sched_cu;
+
+typedef struct {
+	string           name;                  // "SW_Thread_<t>"
+	int              Nb_Of_Chunks;
+	int              Nb_Of_Tests;
+	double           Busy_ms;
+	double           Cost;                  // Sum of the estimated cost of the priced chunks
+} t_sched_sw;
+
+// ----------------------------------------------------------------------------
+// Next chunk to price (-1: none left)
+// ----------------------------------------------------------------------------
+static int sched_claim(t_sched_state* State, bool From_Back) {
+	lock_guard<mutex> lock(State->Mutex);
+	if (State->Front > State->Back) return -1;
+	return From_Back ? State->Order[State->Back--] : State->Order[State->Front++];
+}
+
+// ----------------------------------------------------------------------------
+// SW thread: prices chunks from the back of the queue with the SW model until
+// the queue is empty. The number of chunks priced by the CPU thus follows the
+// measured throughput of the CPU and of the CUs.
+// ----------------------------------------------------------------------------
+static void sched_sw_thread(t_sched_state* State, t_sched_sw* SW, vector<t_sched_chunk>* Chunks, t_in_data* host_IN_DATA, float* hw_RES) {
+	int Chunk_Index;
+	while ((Chunk_Index = sched_claim(State, true)) >= 0) {
+		t_sched_chunk* Chunk = &(*Chunks)[Chunk_Index];
+		double Start = get_time_ms();
+
+		K_americanPut_sw_model_task(host_IN_DATA, hw_RES, Chunk->Nb_Of_Tests, Chunk->Start_Index);
+
+		SW->Busy_ms      += get_time_ms() - Start;
+		SW->Nb_Of_Chunks ++;
+		SW->Nb_Of_Tests  += Chunk->Nb_Of_Tests;
+		SW->Cost         += Chunk->Cost;
+	}
+}
+
+// ----------------------------------------------------------------------------
+// Called by the OpenCL runtime when a chunk is back in host_OBuf
+// ----------------------------------------------------------------------------
+static void sched_read_done(cl_event /* Event */, cl_int /* Status */, void* User_Data) {
+	t_sched_slot* Slot = (t_sched_slot*)User_Data;
+	{
+		lock_guard<mutex> lock(Slot->State->Mutex);
+		Slot->State->Slots.push_back(Slot);
+	}
+	Slot->State->CV.notify_one();
+}
+
+// ----------------------------------------------------------------------------
+// Submit chunk Chunk_Index to the CU of Slot: host_IBuf/host_TBuf -> GlobMem_IBuf/GlobMem_TBuf -> CU -> GlobMem_OBuf -> host_OBuf
+// ----------------------------------------------------------------------------
+static void sched_dispatch(cl_command_queue Command_Queue, t_sched_cu* CU, t_sched_slot* Slot, t_sched_chunk* Chunk, int Chunk_Index,
+                           t_in_data* host_IN_DATA, int Nb_Of_Parallel_Functions, int Col_Stride) {
+	cl_int errCode;
+
+	// ........................................
+	// Chunk tests (+ dummy tests) -> host_IBuf, host_TBuf
+	// The kernel prices groups of Nb_Of_Parallel_Functions tests
+	// ........................................
+	int Nb_Of_Tests = ((Chunk->Nb_Of_Tests + Nb_Of_Parallel_Functions - 1) / Nb_Of_Parallel_Functions) * Nb_Of_Parallel_Functions;
+
+	int Nb_Of_Trees = pack_kernel_inputs(&host_IN_DATA[Chunk->Start_Index], Chunk->Nb_Of_Tests, Slot->host_IBuf, Slot->host_TBuf, 0);
+	pack_dummy_inputs(Nb_Of_Tests - Chunk->Nb_Of_Tests, &Slot->host_IBuf[Chunk->Nb_Of_Tests], Slot->host_TBuf, Nb_Of_Trees);
+	Slot->Chunk = Chunk_Index;
+
+	cl_mem IN_Bufs[2] = {Slot->GlobMem_IBuf, Slot->GlobMem_TBuf};
+
+	errCode = clEnqueueMigrateMemObjects(Command_Queue, 2, IN_Bufs, 0, 0, NULL, &(Slot->Mem_wr_event));
+	ocl_check_status(errCode,"Failed to write: " + CU->name + ".Host_IBuf/Host_TBuf -> " + CU->name + ".GlobMem_IBuf/GlobMem_TBuf");
+
+	int Start_Index = 0;
+	int Col_Base    = 0;
+
+	int arg_indx = 0;
+	errCode = CL_SUCCESS;
+	errCode |= clSetKernelArg(CU->kernel,  arg_indx++, sizeof(cl_mem),    &(Slot->GlobMem_IBuf));
+	errCode |= clSetKernelArg(CU->kernel,  arg_indx++, sizeof(cl_mem),    &(Slot->GlobMem_TBuf));
+	errCode |= clSetKernelArg(CU->kernel,  arg_indx++, sizeof(cl_mem),    &(Slot->GlobMem_OBuf));
+	errCode |= clSetKernelArg(CU->kernel,  arg_indx++, sizeof(cl_int),    &Nb_Of_Tests);
+	errCode |= clSetKernelArg(CU->kernel,  arg_indx++, sizeof(cl_int),    &Start_Index);
+	errCode |= clSetKernelArg(CU->kernel,  arg_indx++, sizeof(cl_mem),    &(Slot->GlobMem_CBuf));
+	errCode |= clSetKernelArg(CU->kernel,  arg_indx++, sizeof(cl_int),    &Col_Base);
+	errCode |= clSetKernelArg(CU->kernel,  arg_indx++, sizeof(cl_int),    &Col_Stride);
+	ocl_check_status(errCode,"Unable to setup Kernel Arguments");
+
+	size_t globalSize[1]; globalSize[0] = 1;
+	size_t localSize[1];  localSize[0]  = 1;
+
+	errCode = clEnqueueNDRangeKernel(Command_Queue, CU->kernel, 1, NULL, globalSize, localSize, 1, &(Slot->Mem_wr_event), &(Slot->K_exe_event));
+	ocl_check_status(errCode,"Failed to submit kernel for execution: " + CU->name);
+
+	errCode = clEnqueueMigrateMemObjects(Command_Queue, 1, &(Slot->GlobMem_OBuf), CL_MIGRATE_MEM_OBJECT_HOST, 1, &(Slot->K_exe_event), &(Slot->Mem_rd_event));
+	ocl_check_status(errCode,"Failed to write: " + CU->name + ".GlobMem_OBuf -> " + CU->name + ".Host_OBuf");
+
+	errCode = clSetEventCallback(Slot->Mem_rd_event, CL_COMPLETE, sched_read_done, Slot);
+	ocl_check_status(errCode,"Failed to set the completion callback of " + CU->name);
+
+	clFlush(Command_Queue);
+}
+
+
+void K_americanPut_hw_dynamic(cl_context Context, cl_command_queue Command_Queue, cl_program Program,
+                              sw_hw_config_t* SW_HW_Config, t_in_data* host_IN_DATA, float* hw_RES, int NB_OF_TESTS, int NB_OF_SW_THREADS) {
+	cl_int errCode;
+
+	int NB_OF_KERNELS            = (*SW_HW_Config).NB_OF_KERNELS;
+	int NB_OF_CUs_PER_KERNEL     = (*SW_HW_Config).NB_OF_CUs_PER_KERNEL;
+	int Nb_Of_Parallel_Functions = (*SW_HW_Config).NB_OF_PARALLEL_FUNCTIONS_PER_CU;
+	int QUEUE_DEPTH              = (*SW_HW_Config).QUEUE_DEPTH;
+	int NB_OF_CUs                = NB_OF_KERNELS * NB_OF_CUs_PER_KERNEL;
+	int Max_Chunk_Size           = (*SW_HW_Config).MAX_NB_OF_TESTS - ((*SW_HW_Config).MAX_NB_OF_TESTS % Nb_Of_Parallel_Functions);
+
+	// -------------------------------------------------------------
+	// Split the tests in chunks of ~Target_Cost
+	// -------------------------------------------------------------
+	double Total_Cost = 0;
+	int    Max_n      = 0;
+	for (int i=0; i<NB_OF_TESTS; i++) {
+		Total_Cost += sched_test_cost(host_IN_DATA[i].n);
+		Max_n       = max(Max_n, host_IN_DATA[i].n);
+	}
+	double Target_Cost = Total_Cost / ((NB_OF_CUs + NB_OF_SW_THREADS) * SCHED_CHUNKS_PER_CU);
+
+	vector<t_sched_chunk> Chunks;
+	for (int i=0; i<NB_OF_TESTS; ) {
+		t_sched_chunk Chunk = {i, 0, 0.0};
+		while ((i < NB_OF_TESTS) && (Chunk.Nb_Of_Tests < Max_Chunk_Size) && ((Chunk.Cost < Target_Cost) || (Chunk.Nb_Of_Tests % Nb_Of_Parallel_Functions != 0))) {
+			Chunk.Cost += sched_test_cost(host_IN_DATA[i].n);
+			Chunk.Nb_Of_Tests ++;
+			i++;
+		}
+		Chunks.push_back(Chunk);
+	}
+
+	// Most expensive chunks first
+	t_sched_state State;
+	State.Order.resize(Chunks.size());
+	for (unsigned c=0; c<Chunks.size(); c++) State.Order[c] = c;
+	stable_sort(State.Order.begin(), State.Order.end(), [&Chunks](int a, int b) { return Chunks[a].Cost > Chunks[b].Cost; });
+	State.Front = 0;
+	State.Back  = (int)Chunks.size() - 1;
+
+	int Col_Stride = (Max_n > CONST_MAX_TREE_HEIGHT) ? Max_n : 1;
+
+	// -------------------------------------------------------------
+	// One kernel object and QUEUE_DEPTH buffer slots per CU
+	// -------------------------------------------------------------
+	t_sched_cu*  CUs = new t_sched_cu[NB_OF_CUs];
+
+	for (int k_index=0; k_index<NB_OF_KERNELS; k_index++) {
+		for (int cu_index=0; cu_index<NB_OF_CUs_PER_KERNEL; cu_index++) {
+			t_sched_cu* CU          = &CUs[k_index*NB_OF_CUs_PER_KERNEL + cu_index];
+			string      Kernel_Name = kernel_name(SW_HW_Config, k_index);
+
+			CU->name         = Kernel_Name + "_" + to_string(cu_index+1);
+			CU->Nb_Of_Chunks = 0;
+			CU->Nb_Of_Tests  = 0;
+			CU->Busy_ms      = 0;
+
+			if ( create_kernel(Program, &(CU->kernel), (Kernel_Name + ":{" + CU->name + "}").c_str()) != 1)
+				exit(1);
+
+			CU->Slot = new t_sched_slot[QUEUE_DEPTH];
+
+			for (int s=0; s<QUEUE_DEPTH; s++) {
+				t_sched_slot* Slot     = &CU->Slot[s];
+				string        Buf_Name = CU->name + ".Slot[" + to_string(s) + "]";
+
+				Slot->CU    = k_index*NB_OF_CUs_PER_KERNEL + cu_index;
+				Slot->Chunk = -1;
+				Slot->State = &State;
+
+				Slot->host_IBuf = allocate_host_mem<t_in_option>(Max_Chunk_Size,Buf_Name+".host_IBuf",false);
+				Slot->host_TBuf = allocate_host_mem<t_tree_params>(Max_Chunk_Size,Buf_Name+".host_TBuf",false);
+				Slot->host_OBuf = allocate_host_mem<float>(Max_Chunk_Size,Buf_Name+".host_OBuf",false);
+
+				Slot->GlobMem_IBuf_EXT.obj   = Slot->host_IBuf;
+				Slot->GlobMem_IBuf_EXT.param = 0;
+				Slot->GlobMem_IBuf_EXT.flags = kernel_mem_flags(SW_HW_Config, k_index);
+				Slot->GlobMem_TBuf_EXT.obj   = Slot->host_TBuf;
+				Slot->GlobMem_TBuf_EXT.param = 0;
+				Slot->GlobMem_TBuf_EXT.flags = kernel_mem_flags(SW_HW_Config, k_index);
+				Slot->GlobMem_OBuf_EXT.obj   = Slot->host_OBuf;
+				Slot->GlobMem_OBuf_EXT.param = 0;
+				Slot->GlobMem_OBuf_EXT.flags = kernel_mem_flags(SW_HW_Config, k_index);
+				Slot->GlobMem_CBuf_EXT.obj   = NULL;
+				Slot->GlobMem_CBuf_EXT.param = 0;
+				Slot->GlobMem_CBuf_EXT.flags = kernel_mem_flags(SW_HW_Config, k_index);
+
+				Slot->GlobMem_IBuf = clCreateBuffer(Context, CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR | CL_MEM_EXT_PTR_XILINX, Max_Chunk_Size * sizeof(t_in_option), &(Slot->GlobMem_IBuf_EXT), &errCode);
+				ocl_check_status(errCode,"Failed to allocate Global Memory for " + Buf_Name + ".GlobMem_IBuf");
+
+				Slot->GlobMem_TBuf = clCreateBuffer(Context, CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR | CL_MEM_EXT_PTR_XILINX, Max_Chunk_Size * sizeof(t_tree_params), &(Slot->GlobMem_TBuf_EXT), &errCode);
+				ocl_check_status(errCode,"Failed to allocate Global Memory for " + Buf_Name + ".GlobMem_TBuf");
+
+				Slot->GlobMem_OBuf = clCreateBuffer(Context, CL_MEM_WRITE_ONLY | CL_MEM_USE_HOST_PTR | CL_MEM_EXT_PTR_XILINX, Max_Chunk_Size * sizeof(float), &(Slot->GlobMem_OBuf_EXT), &errCode);
+				ocl_check_status(errCode,"Failed to allocate Global Memory for " + Buf_Name + ".GlobMem_OBuf");
+
+				Slot->GlobMem_CBuf = clCreateBuffer(Context, CL_MEM_READ_WRITE | CL_MEM_EXT_PTR_XILINX, Nb_Of_Parallel_Functions * Col_Stride * sizeof(float), &(Slot->GlobMem_CBuf_EXT), &errCode);
+				ocl_check_status(errCode,"Failed to allocate Global Memory for " + Buf_Name + ".GlobMem_CBuf");
+			}
+		}
+	}
+
+	cout << "HOST-Info: Scheduling " << NB_OF_TESTS << " tests in " << Chunks.size() << " chunks on " << NB_OF_CUs << " CUs (" << QUEUE_DEPTH << " chunks in flight per CU)";
+	if (NB_OF_SW_THREADS > 0) cout << " and " << NB_OF_SW_THREADS << " SW threads";
+	cout << " ..." << endl;
+
+	// -------------------------------------------------------------
+	// Fill all slots (the CUs of all kernels get a chunk before any CU gets a second one),
+	// then hand out the next chunk to the slot whose chunk completed
+	// -------------------------------------------------------------
+	int    In_Flight = 0;
+	int    Chunk_Index;
+	double Sched_Start = get_time_ms();
+
+	for (int s=0; s<QUEUE_DEPTH; s++) {
+		for (int i=0; i<NB_OF_CUs; i++) {
+			if ((Chunk_Index = sched_claim(&State, false)) < 0) break;
+			t_sched_cu* CU = &CUs[(i % NB_OF_KERNELS)*NB_OF_CUs_PER_KERNEL + i/NB_OF_KERNELS];
+			sched_dispatch(Command_Queue, CU, &CU->Slot[s], &Chunks[Chunk_Index], Chunk_Index, host_IN_DATA, Nb_Of_Parallel_Functions, Col_Stride);
+			In_Flight++;
+		}
+	}
+
+	// The SW threads start once the CUs are busy
+	t_sched_sw* SWs     = new t_sched_sw[NB_OF_SW_THREADS];
+	thread*     Threads = new thread[NB_OF_SW_THREADS];
+	for (int t=0; t<NB_OF_SW_THREADS; t++) {
+		SWs[t].name         = "SW_Thread_" + to_string(t);
+		SWs[t].Nb_Of_Chunks = 0;
+		SWs[t].Nb_Of_Tests  = 0;
+		SWs[t].Busy_ms      = 0;
+		SWs[t].Cost         = 0;
+		Threads[t] = thread(sched_sw_thread, &State, &SWs[t], &Chunks, host_IN_DATA, hw_RES);
+	}
+	double HW_Cost = 0;
+
+	while (In_Flight > 0) {
+		t_sched_slot* Slot;
+		{
+			unique_lock<mutex> lock(State.Mutex);
+			State.CV.wait(lock, [&State]{ return !State.Slots.empty(); });
+			Slot = State.Slots.front();
+			State.Slots.pop_front();
+		}
+		In_Flight--;
+
+		// ........................................
+		// Retire the chunk: host_OBuf -> hw_RES
+		// ........................................
+		t_sched_cu*    CU    = &CUs[Slot->CU];
+		t_sched_chunk* Chunk = &Chunks[Slot->Chunk];
+
+		for (int i=0; i<Chunk->Nb_Of_Tests; i++)
+			hw_RES[Chunk->Start_Index + i] = Slot->host_OBuf[i];
+
+		cl_ulong Start, End;
+		clGetEventProfilingInfo(Slot->K_exe_event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &Start, NULL);
+		clGetEventProfilingInfo(Slot->K_exe_event, CL_PROFILING_COMMAND_END,   sizeof(cl_ulong), &End,   NULL);
+
+		CU->Nb_Of_Chunks ++;
+		CU->Nb_Of_Tests  += Chunk->Nb_Of_Tests;
+		CU->Busy_ms      += (End - Start) * 1.0e-6;
+		HW_Cost          += Chunk->Cost;
+
+		clReleaseEvent(Slot->Mem_wr_event);
+		clReleaseEvent(Slot->K_exe_event);
+		clReleaseEvent(Slot->Mem_rd_event);
+		Slot->Chunk = -1;
+
+		// ........................................
+		// Next chunk to the same CU
+		// ........................................
+		if ((Chunk_Index = sched_claim(&State, false)) >= 0) {
+			sched_dispatch(Command_Queue, CU, Slot, &Chunks[Chunk_Index], Chunk_Index, host_IN_DATA, Nb_Of_Parallel_Functions, Col_Stride);
+			In_Flight++;
+		}
+	}
+	double HW_End = get_time_ms();
+
+	for (int t=0; t<NB_OF_SW_THREADS; t++) Threads[t].join();
+	double Sched_End = get_time_ms();
+
+	// -------------------------------------------------------------
+	// Per-CU / SW thread utilisation: busy time / scheduling time
+	// -------------------------------------------------------------
+	double Span_ms = Sched_End - Sched_Start;
+
+	cout << endl;
+	cout << "HOST-Info: " << left << setw(20) << "CU" << " | " << right << setw(8) << "#Chunks" << " | " << setw(8) << "#Tests" << " | " << setw(10) << "Busy (ms)" << " | " << setw(11) << "Utilisation" << endl;
+	cout << "HOST-Info: " << string(68, '-') << endl;
+	for (int i=0; i<NB_OF_CUs; i++) {
+		cout << "HOST-Info: " << left << setw(20) << CUs[i].name << " | " << right << setw(8) << CUs[i].Nb_Of_Chunks << " | " << setw(8) << CUs[i].Nb_Of_Tests
+		     << " | " << setw(10) << fixed << setprecision(1) << CUs[i].Busy_ms
+		     << " | " << setw(10) << fixed << setprecision(1) << ((Span_ms > 0) ? 100.0*CUs[i].Busy_ms/Span_ms : 0.0) << "%" << endl;
+	}
+	for (int t=0; t<NB_OF_SW_THREADS; t++) {
+		cout << "HOST-Info: " << left << setw(20) << SWs[t].name << " | " << right << setw(8) << SWs[t].Nb_Of_Chunks << " | " << setw(8) << SWs[t].Nb_Of_Tests
+		     << " | " << setw(10) << fixed << setprecision(1) << SWs[t].Busy_ms
+		     << " | " << setw(10) << fixed << setprecision(1) << ((Span_ms > 0) ? 100.0*SWs[t].Busy_ms/Span_ms : 0.0) << "%" << endl;
+	}
+	cout << "HOST-Info: " << string(68, '-') << endl;
+	cout << "HOST-Info: Scheduling Time (ms)      : " << fixed << setprecision(1) << Span_ms << endl;
+
+	if (NB_OF_SW_THREADS > 0) {
+		double SW_Cost  = 0;
+		int    SW_Tests = 0;
+		for (int t=0; t<NB_OF_SW_THREADS; t++) { SW_Cost += SWs[t].Cost; SW_Tests += SWs[t].Nb_Of_Tests; }
+
+		// Throughput in tree nodes per ms, measured over the time each side was pricing
+		cout << "HOST-Info: CPU Share of the Batch    : " << SW_Tests << " tests, " << fixed << setprecision(1) << ((Total_Cost > 0) ? 100.0*SW_Cost/Total_Cost : 0.0) << "% of the nodes" << endl;
+		cout << "HOST-Info: CUs Throughput (nodes/ms) : " << fixed << setprecision(0) << ((HW_End > Sched_Start) ? HW_Cost/(HW_End - Sched_Start) : 0.0) << endl;
+		cout << "HOST-Info: CPU Throughput (nodes/ms) : " << fixed << setprecision(0) << ((Span_ms > 0) ? SW_Cost/Span_ms : 0.0) << endl;
+	}
+
+	// -------------------------------------------------------------
+	// Release Allocated Resources
+	// -------------------------------------------------------------
+	for (int i=0; i<NB_OF_CUs; i++) {
+		for (int s=0; s<QUEUE_DEPTH; s++) {
+			clReleaseMemObject(CUs[i].Slot[s].GlobMem_IBuf);
+			clReleaseMemObject(CUs[i].Slot[s].GlobMem_TBuf);
+			clReleaseMemObject(CUs[i].Slot[s].GlobMem_OBuf);
+			clReleaseMemObject(CUs[i].Slot[s].GlobMem_CBuf);
+			free(CUs[i].Slot[s].host_IBuf);
+			free(CUs[i].Slot[s].host_TBuf);
+			free(CUs[i].Slot[s].host_OBuf);
+		}
+		delete[] CUs[i].Slot;
+		clReleaseKernel(CUs[i].kernel);
+	}
+	delete[] CUs;
+	delete[] SWs;
+	delete[] Threads;
+}
@@ -0,0 +1,52 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#ifndef __SCHEDULER_FUNCTIONS_H__
+#define __SCHEDULER_FUNCTIONS_H__
+
+#include <CL/cl.h>
+#include "help_functions.h"
+
+using namespace std;
+
+// Target number of chunks per CU. More chunks improve balancing, fewer chunks reduce scheduling overhead.
+#ifndef SCHED_CHUNKS_PER_CU
+#define SCHED_CHUNKS_PER_CU 8
+#endif
+
+// ============================================================================
+// Dynamic CU Scheduler (hw_dynamic and hybrid modes)
+//   o) The test vectors are split in chunks of similar cost (estimated from
+//      the tree height n) of up to MAX_NB_OF_TESTS tests
+//   o) Every CU has its own kernel object ("K_americanPut_<k>:{K_americanPut_<k>_<cu>}")
+//      and QUEUE_DEPTH buffer slots in the DDR bank of its kernel
+//   o) The most expensive chunks are handed out first. Whenever a CU returns
+//      a chunk (completion callback of its read event), it gets the next one
+//   o) With NB_OF_SW_THREADS > 0 (hybrid mode), SW threads price chunks with
+//      the SW model from the other end of the queue (cheapest first) while
+//      the CUs run, so the CPU/FPGA split follows the measured throughput of
+//      both sides and they finish together
+//   o) Per-CU / SW thread utilisation is reported at the end
+// ============================================================================
+// Estimated cost of a test: number of nodes of the Binomial tree
+double sched_test_cost(int n);
+
+void K_americanPut_hw_dynamic(cl_context Context, cl_command_queue Command_Queue, cl_program Program,
+                              sw_hw_config_t* SW_HW_Config, t_in_data* host_IN_DATA, float* hw_RES, int NB_OF_TESTS, int NB_OF_SW_THREADS);
+
+#endif
@@ -0,0 +1,519 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+using namespace std;
+
+#include <CL/cl.h>
+#include <CL/cl_ext.h>
+
+#include "kernel.h"
+#include "help_functions.h"
+#include "host_functions.h"
+#include "stream_functions.h"
+#include "server_functions.h"
+#include "cache_functions.h"
+#include "time_functions.h"
+#include "tree_functions.h"
+
+void K_americanPut_sw_model(t_in_data* host_IN_DATA, float* sw_RES, int NB_OF_TESTS, int Nb_Of_Threads);
+
+// ============================================================================
+// Socket path: BINOMIAL_SERVER_SOCKET environment variable or SERVER_DEFAULT_SOCKET
+// ============================================================================
+string server_socket_path() {
+	char *socket_path = getenv("BINOMIAL_SERVER_SOCKET");
+
+	if ((socket_path != NULL) && (socket_path[0] != '\0'))
+		return(string(socket_path));
+	return(string(SERVER_DEFAULT_SOCKET));
+}
+
+
+// ============================================================================
+// HW backend
+// ============================================================================
+static void hw_pricer_alloc_cbuf(t_hw_pricer* Pricer, int k_index) {
+	cl_int              errCode;
+	t_hw_pricer_kernel* Kernel     = &(*Pricer).Kernels[k_index];
+	int                 Nb_Of_Cols = (*Pricer).SW_HW_Config.NB_OF_CUs_PER_KERNEL * (*Pricer).SW_HW_Config.NB_OF_PARALLEL_FUNCTIONS_PER_CU;
+
+	Kernel->GlobMem_CBuf_EXT.obj   = NULL;
+	Kernel->GlobMem_CBuf_EXT.param = 0;
+	Kernel->GlobMem_CBuf_EXT.flags = kernel_mem_flags(&(*Pricer).SW_HW_Config, k_index);
+
+	Kernel->GlobMem_CBuf = clCreateBuffer((*Pricer).Context, CL_MEM_READ_WRITE | CL_MEM_EXT_PTR_XILINX, Nb_Of_Cols * (*Pricer).Col_Stride * sizeof(float), &(Kernel->GlobMem_CBuf_EXT), &errCode);
+	ocl_check_status(errCode,"Failed to allocate Global Memory for " + Kernel->name + ".GlobMem_CBuf");
+}
+
+int hw_pricer_init(t_hw_pricer* Pricer, sw_hw_config_t* SW_HW_Config, const char* Target_Platform_Vendor, const char* Target_Device_Name, const char* xclbinFilename) {
+	cl_int          errCode;
+	cl_platform_id *Platform_IDs, Target_Platform_ID;
+	cl_device_id   *Device_IDs;
+
+	(*Pricer).SW_HW_Config = *SW_HW_Config;
+
+	int NB_OF_KERNELS        = (*SW_HW_Config).NB_OF_KERNELS;
+	int NB_OF_CUs_PER_KERNEL = (*SW_HW_Config).NB_OF_CUs_PER_KERNEL;
+
+	// -------------------------------------------------------------
+	// Platform, Device, Context, Command Queue and Program are created once
+	// -------------------------------------------------------------
+	Platform_IDs = NULL; Device_IDs = NULL;
+	if ( select_platform(Platform_IDs,&Target_Platform_ID, Target_Platform_Vendor) != 1)                          return 0;
+	if ( select_device(Device_IDs,&((*Pricer).Target_Device_ID), Target_Platform_ID, Target_Device_Name) != 1)  return 0;
+	if ( create_context(&((*Pricer).Context), (*Pricer).Target_Device_ID) != 1)                                   return 0;
+	if ( create_command_queue(&((*Pricer).Context), &((*Pricer).Command_Queue), CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE, (*Pricer).Target_Device_ID) != 1) return 0;
+	if ( build_program(&((*Pricer).Program), xclbinFilename, (*Pricer).Target_Device_ID, (*Pricer).Context) != 1) return 0;
+
+	// -------------------------------------------------------------
+	// Every CU prices up to MAX_NB_OF_TESTS tests per run
+	// GlobMem_CBuf is reallocated when a batch contains taller trees
+	// -------------------------------------------------------------
+	(*Pricer).Max_Test_Vectors_Per_Kernel = ((*SW_HW_Config).MAX_NB_OF_TESTS - ((*SW_HW_Config).MAX_NB_OF_TESTS % (*SW_HW_Config).NB_OF_PARALLEL_FUNCTIONS_PER_CU)) * NB_OF_CUs_PER_KERNEL;
+	(*Pricer).Col_Stride                  = 1;
+	(*Pricer).Kernels                     = new t_hw_pricer_kernel[NB_OF_KERNELS];
+
+	for (int i=0; i<NB_OF_KERNELS; i++) {
+		t_hw_pricer_kernel* Kernel = &(*Pricer).Kernels[i];
+
+		Kernel->name = kernel_name(SW_HW_Config, i);
+
+		if ( create_kernel((*Pricer).Program, &(Kernel->kernel), Kernel->name.c_str()) != 1)
+			return 0;
+
+		Kernel->host_IBuf = allocate_host_mem<t_in_option>((*Pricer).Max_Test_Vectors_Per_Kernel,Kernel->name+".host_IBuf",true);
+		Kernel->host_TBuf = allocate_host_mem<t_tree_params>((*Pricer).Max_Test_Vectors_Per_Kernel,Kernel->name+".host_TBuf",true);
+		Kernel->host_OBuf = allocate_host_mem<float>((*Pricer).Max_Test_Vectors_Per_Kernel,Kernel->name+".host_OBuf",true);
+
+		Kernel->GlobMem_IBuf_EXT.obj   = Kernel->host_IBuf;
+		Kernel->GlobMem_IBuf_EXT.param = 0;
+		Kernel->GlobMem_IBuf_EXT.flags = kernel_mem_flags(SW_HW_Config, i);
+		Kernel->GlobMem_TBuf_EXT.obj   = Kernel->host_TBuf;
+		Kernel->GlobMem_TBuf_EXT.param = 0;
+		Kernel->GlobMem_TBuf_EXT.flags = kernel_mem_flags(SW_HW_Config, i);
+		Kernel->GlobMem_OBuf_EXT.obj   = Kernel->host_OBuf;
+		Kernel->GlobMem_OBuf_EXT.param = 0;
+		Kernel->GlobMem_OBuf_EXT.flags = kernel_mem_flags(SW_HW_Config, i);
+
+		cout << "HOST-Info: Allocating Global Memory for " + Kernel->name + ".GlobMem_IBuf ..." << endl;
+		Kernel->GlobMem_IBuf = clCreateBuffer((*Pricer).Context, CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR | CL_MEM_EXT_PTR_XILINX, (*Pricer).Max_Test_Vectors_Per_Kernel * sizeof(t_in_option), &(Kernel->GlobMem_IBuf_EXT), &errCode);
+		ocl_check_status(errCode,"Failed to allocate Global Memory for " + Kernel->name + ".GlobMem_IBuf");
+
+		errCode = clEnqueueMigrateMemObjects((*Pricer).Command_Queue, 1, &(Kernel->GlobMem_IBuf), CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED, 0, NULL, NULL);
+		ocl_check_status(errCode,"Failed to Migrate " + Kernel->name + ".GlobMem_IBuf from Host Memory");
+
+		cout << "HOST-Info: Allocating Global Memory for " + Kernel->name + ".GlobMem_TBuf ..." << endl;
+		Kernel->GlobMem_TBuf = clCreateBuffer((*Pricer).Context, CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR | CL_MEM_EXT_PTR_XILINX, (*Pricer).Max_Test_Vectors_Per_Kernel * sizeof(t_tree_params), &(Kernel->GlobMem_TBuf_EXT), &errCode);
+		ocl_check_status(errCode,"Failed to allocate Global Memory for " + Kernel->name + ".GlobMem_TBuf");
+
+		errCode = clEnqueueMigrateMemObjects((*Pricer).Command_Queue, 1, &(Kernel->GlobMem_TBuf), CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED, 0, NULL, NULL);
+		ocl_check_status(errCode,"Failed to Migrate " + Kernel->name + ".GlobMem_TBuf from Host Memory");
+
+		cout << "HOST-Info: Allocating Global Memory for " + Kernel->name + ".GlobMem_OBuf ..." << endl;
+		Kernel->GlobMem_OBuf = clCreateBuffer((*Pricer).Context, CL_MEM_WRITE_ONLY | CL_MEM_USE_HOST_PTR | CL_MEM_EXT_PTR_XILINX, (*Pricer).Max_Test_Vectors_Per_Kernel * sizeof(float), &(Kernel->GlobMem_OBuf_EXT), &errCode);
+		ocl_check_status(errCode,"Failed to allocate Global Memory for " + Kernel->name + ".GlobMem_OBuf");
+
+		errCode = clEnqueueMigrateMemObjects((*Pricer).Command_Queue, 1, &(Kernel->GlobMem_OBuf), CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED, 0, NULL, NULL);
+		ocl_check_status(errCode,"Failed to Migrate " + Kernel->name + ".GlobMem_OBuf from Host Memory");
+
+		cout << "HOST-Info: Allocating Global Memory for " + Kernel->name + ".GlobMem_CBuf ..." << endl;
+		hw_pricer_alloc_cbuf(Pricer, i);
+	}
+	clFinish((*Pricer).Command_Queue);
+
+	return 1;
+}
+
+
+// ----------------------------------------------------------------------------
+// Price NB_OF_TESTS tests with the kernels. The tests are priced in runs of up
+// to Max_Test_Vectors_Per_Kernel tests per kernel, a run is padded with dummy
+// tests to a multiple of the rounding BASE (all kernels, CUs, parallel functions).
+// ----------------------------------------------------------------------------
+void hw_pricer_run(t_hw_pricer* Pricer, t_in_data* IN_DATA, float* RES, int NB_OF_TESTS) {
+	cl_int errCode;
+
+	int NB_OF_KERNELS        = (*Pricer).SW_HW_Config.NB_OF_KERNELS;
+	int NB_OF_CUs_PER_KERNEL = (*Pricer).SW_HW_Config.NB_OF_CUs_PER_KERNEL;
+	int BASE                 = NB_OF_KERNELS * NB_OF_CUs_PER_KERNEL * (*Pricer).SW_HW_Config.NB_OF_PARALLEL_FUNCTIONS_PER_CU;
+	int Run_Size             = (*Pricer).Max_Test_Vectors_Per_Kernel * NB_OF_KERNELS;
+
+	// -------------------------------------------------------------
+	// Grow GlobMem_CBuf when the batch contains taller trees
+	// -------------------------------------------------------------
+	int Max_n = 0;
+	for (int i=0; i<NB_OF_TESTS; i++)
+		Max_n = max(Max_n, IN_DATA[i].n);
+
+	if ((Max_n > CONST_MAX_TREE_HEIGHT) && (Max_n > (*Pricer).Col_Stride)) {
+		(*Pricer).Col_Stride = Max_n;
+		for (int i=0; i<NB_OF_KERNELS; i++) {
+			clReleaseMemObject((*Pricer).Kernels[i].GlobMem_CBuf);
+			hw_pricer_alloc_cbuf(Pricer, i);
+		}
+	}
+
+	cl_event *Mem_wr_event = new cl_event[NB_OF_KERNELS];
+	cl_event *K_exe_event  = new cl_event[NB_OF_KERNELS*NB_OF_CUs_PER_KERNEL];
+	cl_event *Mem_rd_event = new cl_event[NB_OF_KERNELS];
+
+	size_t globalSize[1]; globalSize[0] = 1;
+	size_t localSize[1];  localSize[0]  = 1;
+
+	for (int Run_Start=0; Run_Start<NB_OF_TESTS; Run_Start+=Run_Size) {
+		int Nb_Of_Tests        = min(Run_Size, NB_OF_TESTS - Run_Start);
+		int Nb_Of_Rounded      = ((Nb_Of_Tests + BASE - 1) / BASE) * BASE;
+		int Nb_Of_Test_Vectors = Nb_Of_Rounded / NB_OF_KERNELS;              // Per kernel
+
+		for (int k_index=0; k_index<NB_OF_KERNELS; k_index++) {
+			t_hw_pricer_kernel* Kernel = &(*Pricer).Kernels[k_index];
+
+			// ........................................
+			// Batch tests (+ dummy tests) -> host_IBuf, host_TBuf
+			// ........................................
+			int Nb_Of_Batch_Tests = min(Nb_Of_Test_Vectors, max(0, Nb_Of_Tests - k_index*Nb_Of_Test_Vectors));
+			int Nb_Of_Trees       = pack_kernel_inputs(&IN_DATA[Run_Start + k_index*Nb_Of_Test_Vectors], Nb_Of_Batch_Tests, Kernel->host_IBuf, Kernel->host_TBuf, 0);
+			pack_dummy_inputs(Nb_Of_Test_Vectors - Nb_Of_Batch_Tests, &Kernel->host_IBuf[Nb_Of_Batch_Tests], Kernel->host_TBuf, Nb_Of_Trees);
+
+			// ........................................
+			// host_IBuf -> GlobMem_IBuf, host_TBuf -> GlobMem_TBuf
+			// ........................................
+			cl_mem IN_Bufs[2] = {Kernel->GlobMem_IBuf, Kernel->GlobMem_TBuf};
+
+			errCode = clEnqueueMigrateMemObjects((*Pricer).Command_Queue, 2, IN_Bufs, 0,
+												   0, NULL, &Mem_wr_event[k_index]);
+			ocl_check_status(errCode,"Failed to write: " + Kernel->name + ".Host_IBuf/Host_TBuf -> " + Kernel->name + ".GlobMem_IBuf/GlobMem_TBuf");
+
+			// ........................................
+			// Submit CUs
+			// ........................................
+			for (int cu_index=0; cu_index<NB_OF_CUs_PER_KERNEL; cu_index++) {
+				int Nb_Of_Test_Vectors_Per_CU = Nb_Of_Test_Vectors / NB_OF_CUs_PER_KERNEL;
+				int Start_Index = cu_index * Nb_Of_Test_Vectors_Per_CU;
+				int Col_Base    = cu_index * (*Pricer).SW_HW_Config.NB_OF_PARALLEL_FUNCTIONS_PER_CU * (*Pricer).Col_Stride;
+
+				int arg_indx = 0;
+				errCode = CL_SUCCESS;
+				errCode |= clSetKernelArg(Kernel->kernel,  arg_indx++, sizeof(cl_mem),    &(Kernel->GlobMem_IBuf));
+				errCode |= clSetKernelArg(Kernel->kernel,  arg_indx++, sizeof(cl_mem),    &(Kernel->GlobMem_TBuf));
+				errCode |= clSetKernelArg(Kernel->kernel,  arg_indx++, sizeof(cl_mem),    &(Kernel->GlobMem_OBuf));
+				errCode |= clSetKernelArg(Kernel->kernel,  arg_indx++, sizeof(cl_int),    &(Nb_Of_Test_Vectors_Per_CU));
+				errCode |= clSetKernelArg(Kernel->kernel,  arg_indx++, sizeof(cl_int),    &Start_Index);
+				errCode |= clSetKernelArg(Kernel->kernel,  arg_indx++, sizeof(cl_mem),    &(Kernel->GlobMem_CBuf));
+				errCode |= clSetKernelArg(Kernel->kernel,  arg_indx++, sizeof(cl_int),    &Col_Base);
+				errCode |= clSetKernelArg(Kernel->kernel,  arg_indx++, sizeof(cl_int),    &((*Pricer).Col_Stride));
+				ocl_check_status(errCode,"Unable to setup Kernel Arguments");
+
+				errCode = clEnqueueNDRangeKernel((*Pricer).Command_Queue, Kernel->kernel, 1, NULL, globalSize, localSize,
+						                         1, &Mem_wr_event[k_index], &K_exe_event[k_index*NB_OF_CUs_PER_KERNEL + cu_index]);
+				ocl_check_status(errCode,"Failed to submit kernel for execution: " + Kernel->name);
+			}
+
+			// ........................................
+			// GlobMem_OBuf -> host_OBuf
+			// ........................................
+			errCode = clEnqueueMigrateMemObjects((*Pricer).Command_Queue, 1, &(Kernel->GlobMem_OBuf), CL_MIGRATE_MEM_OBJECT_HOST,
+												   NB_OF_CUs_PER_KERNEL, &K_exe_event[k_index*NB_OF_CUs_PER_KERNEL], &Mem_rd_event[k_index]);
+			ocl_check_status(errCode,"Failed to write: " + Kernel->name + ".GlobMem_OBuf -> " + Kernel->name + ".Host_OBuf");
+		}
+		clFlush((*Pricer).Command_Queue);
+
+		// ........................................
+		// host_OBuf -> RES (dummy results are dropped)
+		// ........................................
+		for (int k_index=0; k_index<NB_OF_KERNELS; k_index++) {
+			clWaitForEvents(1, &Mem_rd_event[k_index]);
+
+			int Nb_Of_Results = min(Nb_Of_Test_Vectors, max(0, Nb_Of_Tests - k_index*Nb_Of_Test_Vectors));
+			for (int i=0; i<Nb_Of_Results; i++)
+				RES[Run_Start + k_index*Nb_Of_Test_Vectors + i] = (*Pricer).Kernels[k_index].host_OBuf[i];
+
+			clReleaseEvent(Mem_wr_event[k_index]);
+			for (int cu_index=0; cu_index<NB_OF_CUs_PER_KERNEL; cu_index++)
+				clReleaseEvent(K_exe_event[k_index*NB_OF_CUs_PER_KERNEL + cu_index]);
+			clReleaseEvent(Mem_rd_event[k_index]);
+		}
+	}
+
+	delete[] Mem_wr_event;
+	delete[] K_exe_event;
+	delete[] Mem_rd_event;
+}
+
+void hw_pricer_release(t_hw_pricer* Pricer) {
+	for (int i=0; i<(*Pricer).SW_HW_Config.NB_OF_KERNELS; i++) {
+		clReleaseMemObject((*Pricer).Kernels[i].GlobMem_IBuf);
+		clReleaseMemObject((*Pricer).Kernels[i].GlobMem_TBuf);
+		clReleaseMemObject((*Pricer).Kernels[i].GlobMem_OBuf);
+		clReleaseMemObject((*Pricer).Kernels[i].GlobMem_CBuf);
+		clReleaseKernel((*Pricer).Kernels[i].kernel);
+		free((*Pricer).Kernels[i].host_IBuf);
+		free((*Pricer).Kernels[i].host_TBuf);
+		free((*Pricer).Kernels[i].host_OBuf);
+	}
+	delete[] (*Pricer).Kernels;
+
+	clReleaseProgram((*Pricer).Program);
+	clReleaseCommandQueue((*Pricer).Command_Queue);
+	clReleaseContext((*Pricer).Context);
+	clReleaseDevice((*Pricer).Target_Device_ID);
+}
+
+
+// ============================================================================
+// Socket helpers
+// ============================================================================
+static volatile sig_atomic_t Server_Stop = 0;
+
+static void server_signal_handler(int /* signum */) {
+	Server_Stop = 1;
+}
+
+// Returns 1 when len bytes were transferred, 0 on EOF, error or server stop
+static int recv_all(int fd, void* buf, size_t len) {
+	char* ptr = (char*)buf;
+	while (len > 0) {
+		ssize_t nb = recv(fd, ptr, len, 0);
+		if (nb < 0 && errno == EINTR && !Server_Stop) continue;
+		if (nb <= 0) return 0;
+		ptr += nb; len -= nb;
+	}
+	return 1;
+}
+
+static int send_all(int fd, const void* buf, size_t len) {
+	const char* ptr = (const char*)buf;
+	while (len > 0) {
+		ssize_t nb = send(fd, ptr, len, MSG_NOSIGNAL);
+		if (nb < 0 && errno == EINTR && !Server_Stop) continue;
+		if (nb <= 0) return 0;
+		ptr += nb; len -= nb;
+	}
+	return 1;
+}
+
+static int check_server_request(t_server_request Request) {
+	return ((Request.Magic == SERVER_MAGIC) && (Request.Nb_Of_Tests > 0) && (Request.Nb_Of_Tests <= SERVER_MAX_NB_OF_TESTS));
+}
+
+// Same range checks as process_configurations (n) plus the values the model divides by
+static int check_server_tests(t_in_data* IN_DATA, int Nb_Of_Tests, int MAX_TREE_HEIGHT) {
+	for (int i=0; i<Nb_Of_Tests; i++) {
+		if ((IN_DATA[i].n <= 0) || (IN_DATA[i].n > MAX_TREE_HEIGHT) || (IN_DATA[i].T <= 0) || !(IN_DATA[i].sigma > 0.0f)) {
+			cout << "HOST-Error: Test " << i << " of the batch is out of range (T=" << IN_DATA[i].T << ", sigma=" << IN_DATA[i].sigma << ", n=" << IN_DATA[i].n << ")" << endl;
+			return 0;
+		}
+	}
+	return 1;
+}
+
+
+// ============================================================================
+// Pricing Server
+// ============================================================================
+int run_pricing_server(sw_hw_config_t* SW_HW_Config, t_hw_pricer* Pricer) {
+	string             Socket_Path = server_socket_path();
+	struct sockaddr_un Addr;
+	struct sigaction   Action;
+
+	if (Socket_Path.size() >= sizeof(Addr.sun_path)) {
+		cout << endl << "HOST-Error: Socket path " << Socket_Path << " is longer than " << sizeof(Addr.sun_path)-1 << " characters" << endl << endl;
+		return 0;
+	}
+
+	// -------------------------------------------------------------
+	// SIGINT/SIGTERM stop the server (no SA_RESTART: accept/recv return EINTR)
+	// -------------------------------------------------------------
+	memset(&Action, 0, sizeof(Action));
+	Action.sa_handler = server_signal_handler;
+	sigemptyset(&Action.sa_mask);
+	sigaction(SIGINT,  &Action, NULL);
+	sigaction(SIGTERM, &Action, NULL);
+
+	int Server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (Server_fd < 0) {
+		cout << endl << "HOST-Error: Failed to create the server socket (" << strerror(errno) << ")" << endl << endl;
+		return 0;
+	}
+
+	memset(&Addr, 0, sizeof(Addr));
+	Addr.sun_family = AF_UNIX;
+	strncpy(Addr.sun_path, Socket_Path.c_str(), sizeof(Addr.sun_path)-1);
+
+	unlink(Socket_Path.c_str());
+	if ((bind(Server_fd, (struct sockaddr*)&Addr, sizeof(Addr)) < 0) || (listen(Server_fd, 8) < 0)) {
+		cout << endl << "HOST-Error: Failed to listen on " << Socket_Path << " (" << strerror(errno) << ")" << endl << endl;
+		close(Server_fd);
+		return 0;
+	}
+
+	cout << "HOST-Info: Server listening on " << Socket_Path << " (" << ((Pricer == NULL) ? "sw" : "hw") << " backend)" << endl;
+
+	// -------------------------------------------------------------
+	// Result cache in front of both backends (BINOMIAL_RESULT_CACHE)
+	// -------------------------------------------------------------
+	t_result_cache* Cache = new t_result_cache;
+	result_cache_init(Cache, result_cache_capacity());
+
+	if (result_cache_enabled(Cache))
+		cout << "HOST-Info: Result cache enabled (" << Cache->Capacity << " results)" << endl;
+
+	t_in_data* IN_DATA     = NULL;
+	float*     RES         = NULL;
+	int        Capacity    = 0;
+	long       Nb_Of_Batch = 0;
+
+	while (!Server_Stop) {
+		int Client_fd = accept(Server_fd, NULL, NULL);
+		if (Client_fd < 0) continue;            // EINTR: Server_Stop is checked by the loop
+
+		// -------------------------------------------------------------
+		// A client can send several batches over the same connection
+		// -------------------------------------------------------------
+		t_server_request Request;
+		while (!Server_Stop && recv_all(Client_fd, &Request, sizeof(Request))) {
+			t_server_reply Reply;
+			Reply.Magic       = SERVER_MAGIC;
+			Reply.Nb_Of_Tests = Request.Nb_Of_Tests;
+			Reply.Status      = SERVER_STATUS_OK;
+
+			if (!check_server_request(Request)) {
+				cout << "HOST-Error: Bad request (Magic=0x" << hex << Request.Magic << dec << ", Nb_Of_Tests=" << Request.Nb_Of_Tests << "), closing connection" << endl;
+				Reply.Status = SERVER_STATUS_BAD_REQUEST;
+				send_all(Client_fd, &Reply, sizeof(Reply));
+				break;
+			}
+
+			if (Request.Nb_Of_Tests > Capacity) {
+				free(IN_DATA); free(RES);
+				Capacity = Request.Nb_Of_Tests;
+				IN_DATA  = allocate_host_mem<t_in_data>(Capacity,"server IN_DATA",false);
+				RES      = allocate_host_mem<float>(Capacity,"server RES",false);
+			}
+
+			if (!recv_all(Client_fd, IN_DATA, Request.Nb_Of_Tests * sizeof(t_in_data)))
+				break;
+
+			if (!check_server_tests(IN_DATA, Request.Nb_Of_Tests, (*SW_HW_Config).MAX_TREE_HEIGHT)) {
+				Reply.Status = SERVER_STATUS_BAD_TEST;
+				if (!send_all(Client_fd, &Reply, sizeof(Reply))) break;
+				continue;
+			}
+
+			double tstart = get_time_ms();
+
+			int Nb_Of_Hits = result_cache_price(Cache, IN_DATA, RES, Request.Nb_Of_Tests,
+				[&](t_in_data* Batch_IN_DATA, float* Batch_RES, int Nb_Of_Tests) {
+					if (Pricer == NULL) {
+						K_americanPut_sw_model(Batch_IN_DATA, Batch_RES, Nb_Of_Tests, (*SW_HW_Config).NB_OF_THREADS);
+					} else {
+						hw_pricer_run(Pricer, Batch_IN_DATA, Batch_RES, Nb_Of_Tests);
+					}
+				});
+
+			double tstop = get_time_ms();
+
+			cout << "HOST-Info: Batch " << ++Nb_Of_Batch << ": " << Request.Nb_Of_Tests << " tests priced in " << fixed << setprecision(3) << (tstop-tstart) << " ms";
+			if (result_cache_enabled(Cache)) cout << " (" << Nb_Of_Hits << " cache hits)";
+			cout << endl;
+
+			if (!send_all(Client_fd, &Reply, sizeof(Reply)) || !send_all(Client_fd, RES, Request.Nb_Of_Tests * sizeof(float)))
+				break;
+		}
+		close(Client_fd);
+	}
+
+	cout << endl << "HOST-Info: Server stopped after " << Nb_Of_Batch << " batches" << endl;
+	print_result_cache_stats(Cache);
+	delete Cache;
+
+	close(Server_fd);
+	unlink(Socket_Path.c_str());
+	free(IN_DATA);
+	free(RES);
+
+	return 1;
+}
+
+
+// ============================================================================
+// Pricing Client
+// ============================================================================
+int run_pricing_client(t_in_data* host_IN_DATA, float* RES, int NB_OF_TESTS, double* Latency_ms) {
+	string             Socket_Path = server_socket_path();
+	struct sockaddr_un Addr;
+
+	if ((NB_OF_TESTS <= 0) || (NB_OF_TESTS > SERVER_MAX_NB_OF_TESTS)) {
+		cout << endl << "HOST-Error: The server prices batches of 1 to " << SERVER_MAX_NB_OF_TESTS << " tests (" << NB_OF_TESTS << " tests defined)" << endl << endl;
+		return 0;
+	}
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0) {
+		cout << endl << "HOST-Error: Failed to create the client socket (" << strerror(errno) << ")" << endl << endl;
+		return 0;
+	}
+
+	memset(&Addr, 0, sizeof(Addr));
+	Addr.sun_family = AF_UNIX;
+	strncpy(Addr.sun_path, Socket_Path.c_str(), sizeof(Addr.sun_path)-1);
+
+	if (connect(fd, (struct sockaddr*)&Addr, sizeof(Addr)) < 0) {
+		cout << endl << "HOST-Error: Failed to connect to the server on " << Socket_Path << " (" << strerror(errno) << ")" << endl << endl;
+		close(fd);
+		return 0;
+	}
+
+	t_server_request Request;
+	t_server_reply   Reply;
+
+	Request.Magic       = SERVER_MAGIC;
+	Request.Nb_Of_Tests = NB_OF_TESTS;
+
+	double tstart = get_time_ms();
+
+	int Status = send_all(fd, &Request, sizeof(Request)) && send_all(fd, host_IN_DATA, NB_OF_TESTS * sizeof(t_in_data))
+	          && recv_all(fd, &Reply, sizeof(Reply));
+
+	if (Status && ((Reply.Magic != SERVER_MAGIC) || (Reply.Status != SERVER_STATUS_OK) || (Reply.Nb_Of_Tests != NB_OF_TESTS))) {
+		cout << endl << "HOST-Error: The server rejected the batch (Status=" << Reply.Status << ")" << endl << endl;
+		close(fd);
+		return 0;
+	}
+
+	if (Status)
+		Status = recv_all(fd, RES, NB_OF_TESTS * sizeof(float));
+
+	if (!Status)
+		cout << endl << "HOST-Error: Connection to the server lost" << endl << endl;
+
+	(*Latency_ms) = get_time_ms() - tstart;
+
+	close(fd);
+	return(Status);
+}
@@ -0,0 +1,107 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#ifndef __SERVER_FUNCTIONS_H__
+#define __SERVER_FUNCTIONS_H__
+
+#include <string>
+
+#include <CL/cl.h>
+#include <CL/cl_ext.h>
+#include "help_functions.h"
+
+using namespace std;
+
+// ============================================================================
+// Pricing Server
+//   o) sw_server / hw_server modes: the server is initialized once (for the
+//      hw backend: platform, device, context, program, kernels and buffers)
+//      and prices the batches sent over a local Unix-domain socket
+//   o) client mode: sends the test vectors defined in the test config file
+//      to the server and stores the results
+//
+//   The socket path is SERVER_DEFAULT_SOCKET or the value of the
+//   BINOMIAL_SERVER_SOCKET environment variable.
+//
+//   Protocol (host byte order, several batches per connection):
+//     client -> server: t_server_request, Nb_Of_Tests x t_in_data
+//     server -> client: t_server_reply,   Nb_Of_Tests x float (Status == SERVER_STATUS_OK only)
+// ============================================================================
+#define SERVER_DEFAULT_SOCKET      "/tmp/binomial_model.sock"
+#define SERVER_MAGIC               0x4D504F42          // "BOPM"
+#define SERVER_MAX_NB_OF_TESTS     (1 << 24)
+
+#define SERVER_STATUS_OK           0
+#define SERVER_STATUS_BAD_REQUEST  1                   // Wrong magic number or number of tests
+#define SERVER_STATUS_BAD_TEST     2                   // A test vector is out of the supported range
+
+typedef struct {
+	int Magic;
+	int Nb_Of_Tests;
+} t_server_request;
+
+typedef struct {
+	int Magic;
+	int Nb_Of_Tests;
+	int Status;
+} t_server_reply;
+
+// ----------------------------------------------------------------------------
+// HW backend: OpenCL objects and buffers created once and reused by all batches
+// ----------------------------------------------------------------------------
+typedef struct {
+	string           name;                  // {"K_americanPut_0", "K_americanPut_1", ... };
+	cl_kernel        kernel;
+
+	t_in_option*     host_IBuf;             // One record per test
+	t_tree_params*   host_TBuf;             // One record per tree
+	float*           host_OBuf;
+
+	cl_mem           GlobMem_IBuf;
+	cl_mem_ext_ptr_t GlobMem_IBuf_EXT;
+	cl_mem           GlobMem_TBuf;
+	cl_mem_ext_ptr_t GlobMem_TBuf_EXT;
+	cl_mem           GlobMem_OBuf;
+	cl_mem_ext_ptr_t GlobMem_OBuf_EXT;
+	cl_mem           GlobMem_CBuf;          // p columns of the trees taller than CONST_MAX_TREE_HEIGHT
+	cl_mem_ext_ptr_t GlobMem_CBuf_EXT;
+} t_hw_pricer_kernel;
+
+typedef struct {
+	sw_hw_config_t      SW_HW_Config;
+	cl_device_id        Target_Device_ID;
+	cl_context          Context;
+	cl_command_queue    Command_Queue;
+	cl_program          Program;
+
+	int                 Max_Test_Vectors_Per_Kernel;   // Each CU prices up to MAX_NB_OF_TESTS tests per run
+	int                 Col_Stride;                    // Size of GlobMem_CBuf columns (grows with the tallest tree)
+	t_hw_pricer_kernel* Kernels;
+} t_hw_pricer;
+
+int  hw_pricer_init   (t_hw_pricer* Pricer, sw_hw_config_t* SW_HW_Config, const char* Target_Platform_Vendor, const char* Target_Device_Name, const char* xclbinFilename);
+void hw_pricer_run    (t_hw_pricer* Pricer, t_in_data* IN_DATA, float* RES, int NB_OF_TESTS);
+void hw_pricer_release(t_hw_pricer* Pricer);
+
+// Pricer == NULL selects the SW backend (SW model with NB_OF_THREADS threads)
+int run_pricing_server(sw_hw_config_t* SW_HW_Config, t_hw_pricer* Pricer);
+int run_pricing_client(t_in_data* host_IN_DATA, float* RES, int NB_OF_TESTS, double* Latency_ms);
+
+string server_socket_path();
+
+#endif
@@ -0,0 +1,381 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <thread>
+
+using namespace std;
+
+#include <CL/cl.h>
+#include <CL/cl_ext.h>
+
+#include "kernel.h"
+#include "help_functions.h"
+#include "host_functions.h"
+#include "stream_functions.h"
+#include "tree_functions.h"
+
+void K_americanPut_sw_model(t_in_data* host_IN_DATA, float* sw_RES, int NB_OF_TESTS, int Nb_Of_Threads);
+
+// ============================================================================
+// Streaming SW model
+//   Two chunks are in flight: chunk c is generated while chunk c-1 is priced
+//   by a separate thread, then the results of chunk c-1 are stored while
+//   chunk c is priced.
+// ============================================================================
+typedef struct {
+	int        Start_Index;           // Global index of the first test in the chunk
+	int        Nb_Of_Tests;
+	t_in_data* IN_DATA;
+	float*     RES;
+} t_sw_chunk_buf;
+
+void K_americanPut_sw_stream(sw_hw_config_t* SW_HW_Config, vector<test_config_t>* Test_Config, t_result_cache* Cache, int DEFINED_NB_OF_TESTS, int ROUNDED_NB_OF_TESTS, string Out_File_Name) {
+	t_sw_chunk_buf Buf[2];
+	thread         Pricing;
+	t_results_file out_file;
+	int            Nb_Of_Threads = (*SW_HW_Config).NB_OF_THREADS;
+
+	// The SW model splits a chunk equally across the threads
+	int Chunk_Size   = max(SW_STREAM_CHUNK_SIZE - (SW_STREAM_CHUNK_SIZE % Nb_Of_Threads), Nb_Of_Threads);
+	int Nb_Of_Chunks = (ROUNDED_NB_OF_TESTS + Chunk_Size - 1) / Chunk_Size;
+
+	for (int b=0; b<2; b++) {
+		Buf[b].IN_DATA = allocate_host_mem<t_in_data>(Chunk_Size,"Chunk["+to_string(b)+"].IN_DATA",true);
+		Buf[b].RES     = allocate_host_mem<float>(Chunk_Size,"Chunk["+to_string(b)+"].RES",true);
+	}
+
+	cout << "HOST-Info: Streaming " << DEFINED_NB_OF_TESTS << " tests in " << Nb_Of_Chunks << " chunks of up to " << Chunk_Size << " tests ..." << endl;
+
+	open_results_file("sw", Out_File_Name, &out_file);
+
+	for (int c=0; c<=Nb_Of_Chunks; c++) {
+		t_sw_chunk_buf* Cur  = &Buf[c%2];
+		t_sw_chunk_buf* Prev = &Buf[(c+1)%2];
+
+		// ---------------------------------------------------------
+		// Generate chunk c (while chunk c-1 is priced)
+		// ---------------------------------------------------------
+		if (c < Nb_Of_Chunks) {
+			Cur->Start_Index = c * Chunk_Size;
+			Cur->Nb_Of_Tests = min(Chunk_Size, ROUNDED_NB_OF_TESTS - Cur->Start_Index);
+			generate_test_vectors(Cur->IN_DATA, Test_Config, Cur->Start_Index, Cur->Nb_Of_Tests);
+		}
+
+		if (Pricing.joinable()) Pricing.join();
+
+		// ---------------------------------------------------------
+		// Price chunk c and store the results of chunk c-1
+		// ---------------------------------------------------------
+		if (c < Nb_Of_Chunks)
+			Pricing = thread([Cur, Cache, Nb_Of_Threads]() {
+				result_cache_price(Cache, Cur->IN_DATA, Cur->RES, Cur->Nb_Of_Tests,
+					[Nb_Of_Threads](t_in_data* Batch_IN_DATA, float* Batch_RES, int Nb_Of_Tests) {
+						K_americanPut_sw_model(Batch_IN_DATA, Batch_RES, Nb_Of_Tests, Nb_Of_Threads);
+					});
+			});
+
+		if (c > 0)
+			store_results_chunk(&out_file, Prev->IN_DATA, Prev->RES, Test_Config, Prev->Start_Index, Prev->Nb_Of_Tests);
+	}
+
+	close_results_file(&out_file);
+
+	for (int b=0; b<2; b++) {
+		free(Buf[b].IN_DATA);
+		free(Buf[b].RES);
+	}
+}
+
+
+// ============================================================================
+// Streaming HW
+// ============================================================================
+typedef struct {
+	t_in_data*       IN_DATA;               // Test vectors of the chunk (SW model and results file)
+	t_in_option*     host_IBuf;             // In Buffer in Host Mem (one record per test)
+	t_tree_params*   host_TBuf;             // Tree Buffer in Host Mem (one record per tree)
+	float*           host_OBuf;             // OUT Buffer in Host Mem
+
+	cl_mem           GlobMem_IBuf;          // In Buffer in Global Mem
+	cl_mem_ext_ptr_t GlobMem_IBuf_EXT;
+	cl_mem           GlobMem_TBuf;          // Tree Buffer in Global Mem
+	cl_mem_ext_ptr_t GlobMem_TBuf_EXT;
+	cl_mem           GlobMem_OBuf;          // OUT Buffer in Global Mem
+	cl_mem_ext_ptr_t GlobMem_OBuf_EXT;
+
+	cl_mem           GlobMem_CBuf;          // p columns of the trees taller than CONST_MAX_TREE_HEIGHT (Global Mem only)
+	cl_mem_ext_ptr_t GlobMem_CBuf_EXT;
+
+	cl_event         Mem_wr_event;
+	cl_event        *K_exe_event;           // One event per CU
+	cl_event         Mem_rd_event;
+} t_stream_buf;
+
+typedef struct {
+	string           name;                  // {"K_americanPut_0", "K_americanPut_1", ... };
+	cl_kernel        kernel;
+	t_stream_buf*    Buf;                   // QUEUE_DEPTH sets of buffers
+} t_stream_kernel;
+
+typedef struct {
+	int              Start_Index;           // Global index of the first test in the chunk
+	int              Nb_Of_Test_Vectors;    // Per kernel
+} t_stream_chunk;
+
+// ----------------------------------------------------------------------------
+// Wait for chunk Chunk (stored in buffers b) to be completed, compare the
+// results against the SW model and store them.
+// ----------------------------------------------------------------------------
+static int retire_hw_chunk(t_stream_kernel* HW_Kernels, int b, t_stream_chunk Chunk, float* sw_RES,
+                           sw_hw_config_t* SW_HW_Config, vector<test_config_t>* Test_Config, int DEFINED_NB_OF_TESTS, int Nb_Of_Errors, t_results_file* out_file) {
+
+	int Nb_Of_Threads = (*SW_HW_Config).NB_OF_THREADS;
+
+	for (int k_index=0; k_index<(*SW_HW_Config).NB_OF_KERNELS; k_index++) {
+		t_stream_buf* Buf         = &HW_Kernels[k_index].Buf[b];
+		int           Start_Index = Chunk.Start_Index + k_index*Chunk.Nb_Of_Test_Vectors;
+
+		// .............................................................
+		// Reference results (only DEFINED_NB_OF_TESTS are compared)
+		// .............................................................
+		int Nb_Of_Defined = min(Chunk.Nb_Of_Test_Vectors, max(0, DEFINED_NB_OF_TESTS - Start_Index));
+
+		K_americanPut_sw_model(Buf->IN_DATA, sw_RES, Nb_Of_Defined, Nb_Of_Threads);
+
+		clWaitForEvents(1, &(Buf->Mem_rd_event));
+
+		Nb_Of_Errors += compare_results(sw_RES, Buf->host_OBuf, Nb_Of_Defined, max(0, 5 - Nb_Of_Errors));
+
+		store_results_chunk(out_file, Buf->IN_DATA, Buf->host_OBuf, Test_Config, Start_Index, Nb_Of_Defined);
+
+		clReleaseEvent(Buf->Mem_wr_event);
+		for (int cu_index=0; cu_index<(*SW_HW_Config).NB_OF_CUs_PER_KERNEL; cu_index++)
+			clReleaseEvent(Buf->K_exe_event[cu_index]);
+		clReleaseEvent(Buf->Mem_rd_event);
+	}
+
+	return(Nb_Of_Errors);
+}
+
+
+int K_americanPut_hw_stream(cl_context Context, cl_command_queue Command_Queue, cl_program Program,
+                            sw_hw_config_t* SW_HW_Config, vector<test_config_t>* Test_Config, int DEFINED_NB_OF_TESTS, int ROUNDED_NB_OF_TESTS, string Out_File_Name) {
+	cl_int  errCode;
+	t_results_file out_file;
+	int     Nb_Of_Errors = 0;
+
+	int NB_OF_KERNELS        = (*SW_HW_Config).NB_OF_KERNELS;
+	int NB_OF_CUs_PER_KERNEL = (*SW_HW_Config).NB_OF_CUs_PER_KERNEL;
+	int QUEUE_DEPTH          = (*SW_HW_Config).QUEUE_DEPTH;
+
+	// -------------------------------------------------------------
+	// Every CU prices up to MAX_NB_OF_TESTS tests of a chunk
+	// Chunk size is a multiple of the rounding BASE (all kernels, CUs, parallel functions)
+	// -------------------------------------------------------------
+	int Max_Test_Vectors_Per_Kernel = ((*SW_HW_Config).MAX_NB_OF_TESTS - ((*SW_HW_Config).MAX_NB_OF_TESTS % (*SW_HW_Config).NB_OF_PARALLEL_FUNCTIONS_PER_CU)) * NB_OF_CUs_PER_KERNEL;
+	int Chunk_Size                  = Max_Test_Vectors_Per_Kernel * NB_OF_KERNELS;
+	int Nb_Of_Chunks                = (ROUNDED_NB_OF_TESTS + Chunk_Size - 1) / Chunk_Size;
+
+	// -------------------------------------------------------------
+	// Every parallel function of a CU stores its p column in GlobMem_CBuf
+	// (only used by trees taller than CONST_MAX_TREE_HEIGHT)
+	// -------------------------------------------------------------
+	int Col_Stride = get_max_tree_height(Test_Config);
+	if (Col_Stride <= CONST_MAX_TREE_HEIGHT) Col_Stride = 1;
+
+	int Nb_Of_Cols = NB_OF_CUs_PER_KERNEL * (*SW_HW_Config).NB_OF_PARALLEL_FUNCTIONS_PER_CU;
+
+	// ....................................................................
+	// Create Kernel related objects for EACH kernel implemented on Alveo
+	//   o) Generate Kernel Name and Kernel object
+	//   o) Allocate QUEUE_DEPTH sets of In/Out Host and Global Memory buffers
+	// ....................................................................
+	t_stream_kernel *HW_Kernels = new t_stream_kernel[NB_OF_KERNELS];
+
+	for (int i=0; i<NB_OF_KERNELS; i++) {
+		HW_Kernels[i].name= kernel_name(SW_HW_Config, i);
+
+		if ( create_kernel(Program, &(HW_Kernels[i].kernel), HW_Kernels[i].name.c_str()) != 1)
+			exit(1);
+
+		HW_Kernels[i].Buf = new t_stream_buf[QUEUE_DEPTH];
+
+		for (int b=0; b<QUEUE_DEPTH; b++) {
+			t_stream_buf* Buf      = &HW_Kernels[i].Buf[b];
+			string        Buf_Name = HW_Kernels[i].name + ".Buf[" + to_string(b) + "]";
+
+			Buf->IN_DATA     = allocate_host_mem<t_in_data>(Max_Test_Vectors_Per_Kernel,Buf_Name+".IN_DATA",true);
+			Buf->host_IBuf   = allocate_host_mem<t_in_option>(Max_Test_Vectors_Per_Kernel,Buf_Name+".host_IBuf",true);
+			Buf->host_TBuf   = allocate_host_mem<t_tree_params>(Max_Test_Vectors_Per_Kernel,Buf_Name+".host_TBuf",true);
+			Buf->host_OBuf   = allocate_host_mem<float>(Max_Test_Vectors_Per_Kernel,Buf_Name+".host_OBuf",true);
+			Buf->K_exe_event = new cl_event[NB_OF_CUs_PER_KERNEL];
+
+			Buf->GlobMem_IBuf_EXT.obj   = Buf->host_IBuf;
+			Buf->GlobMem_IBuf_EXT.param = 0;
+			Buf->GlobMem_IBuf_EXT.flags = kernel_mem_flags(SW_HW_Config, i);
+			Buf->GlobMem_TBuf_EXT.obj   = Buf->host_TBuf;
+			Buf->GlobMem_TBuf_EXT.param = 0;
+			Buf->GlobMem_TBuf_EXT.flags = kernel_mem_flags(SW_HW_Config, i);
+			Buf->GlobMem_OBuf_EXT.obj   = Buf->host_OBuf;
+			Buf->GlobMem_OBuf_EXT.param = 0;
+			Buf->GlobMem_OBuf_EXT.flags = kernel_mem_flags(SW_HW_Config, i);
+			Buf->GlobMem_CBuf_EXT.obj   = NULL;
+			Buf->GlobMem_CBuf_EXT.param = 0;
+			Buf->GlobMem_CBuf_EXT.flags = kernel_mem_flags(SW_HW_Config, i);
+
+			cout << "HOST-Info: Allocating Global Memory for " + Buf_Name + ".GlobMem_IBuf ..." << endl;
+			Buf->GlobMem_IBuf = clCreateBuffer(Context, CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR | CL_MEM_EXT_PTR_XILINX, Max_Test_Vectors_Per_Kernel * sizeof(t_in_option), &(Buf->GlobMem_IBuf_EXT), &errCode);
+			ocl_check_status(errCode,"Failed to allocate Global Memory for " + Buf_Name + ".GlobMem_IBuf");
+
+			errCode = clEnqueueMigrateMemObjects(Command_Queue, 1, &(Buf->GlobMem_IBuf), CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED, 0, NULL, NULL);
+			ocl_check_status(errCode,"Failed to Migrate " + Buf_Name + ".GlobMem_IBuf from Host Memory");
+
+			cout << "HOST-Info: Allocating Global Memory for " + Buf_Name + ".GlobMem_TBuf ..." << endl;
+			Buf->GlobMem_TBuf = clCreateBuffer(Context, CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR | CL_MEM_EXT_PTR_XILINX, Max_Test_Vectors_Per_Kernel * sizeof(t_tree_params), &(Buf->GlobMem_TBuf_EXT), &errCode);
+			ocl_check_status(errCode,"Failed to allocate Global Memory for " + Buf_Name + ".GlobMem_TBuf");
+
+			errCode = clEnqueueMigrateMemObjects(Command_Queue, 1, &(Buf->GlobMem_TBuf), CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED, 0, NULL, NULL);
+			ocl_check_status(errCode,"Failed to Migrate " + Buf_Name + ".GlobMem_TBuf from Host Memory");
+
+			cout << "HOST-Info: Allocating Global Memory for " + Buf_Name + ".GlobMem_OBuf ..." << endl;
+			Buf->GlobMem_OBuf = clCreateBuffer(Context, CL_MEM_WRITE_ONLY | CL_MEM_USE_HOST_PTR | CL_MEM_EXT_PTR_XILINX, Max_Test_Vectors_Per_Kernel * sizeof(float), &(Buf->GlobMem_OBuf_EXT), &errCode);
+			ocl_check_status(errCode,"Failed to allocate Global Memory for " + Buf_Name + ".GlobMem_OBuf");
+
+			errCode = clEnqueueMigrateMemObjects(Command_Queue, 1, &(Buf->GlobMem_OBuf), CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED, 0, NULL, NULL);
+			ocl_check_status(errCode,"Failed to Migrate " + Buf_Name + ".GlobMem_OBuf from Host Memory");
+
+			cout << "HOST-Info: Allocating Global Memory for " + Buf_Name + ".GlobMem_CBuf ..." << endl;
+			Buf->GlobMem_CBuf = clCreateBuffer(Context, CL_MEM_READ_WRITE | CL_MEM_EXT_PTR_XILINX, Nb_Of_Cols * Col_Stride * sizeof(float), &(Buf->GlobMem_CBuf_EXT), &errCode);
+			ocl_check_status(errCode,"Failed to allocate Global Memory for " + Buf_Name + ".GlobMem_CBuf");
+		}
+	}
+	clFinish(Command_Queue);
+
+	float* sw_RES = allocate_host_mem<float>(Max_Test_Vectors_Per_Kernel,"sw_RES",true);
+
+	cout << endl << "HOST-Info: Streaming " << DEFINED_NB_OF_TESTS << " tests in " << Nb_Of_Chunks << " chunks of up to " << Chunk_Size << " tests ..." << endl;
+
+	open_results_file("hw", Out_File_Name, &out_file);
+
+	// ------------------------------------------------------------------------------------------------
+	// Chunk c uses buffers c%QUEUE_DEPTH
+	//   o) retire chunk c-QUEUE_DEPTH (frees the buffers)
+	//   o) generate chunk c in IN_DATA and pack it in host_IBuf/host_TBuf (the kernels still run chunks
+	//      c-QUEUE_DEPTH+1 ... c-1)
+	//   o) submit chunk c: host_IBuf/host_TBuf -> GlobMem_IBuf/GlobMem_TBuf -> CUs -> GlobMem_OBuf -> host_OBuf
+	//      Each step waits for the events of the previous one
+	// ------------------------------------------------------------------------------------------------
+	t_stream_chunk *Chunk = new t_stream_chunk[QUEUE_DEPTH];
+
+	size_t globalSize[1]; globalSize[0] = 1;
+	size_t localSize[1];  localSize[0]  = 1;
+
+	for (int c=0; c<Nb_Of_Chunks+QUEUE_DEPTH; c++) {
+		int b = c % QUEUE_DEPTH;
+
+		if (c >= QUEUE_DEPTH)
+			Nb_Of_Errors = retire_hw_chunk(HW_Kernels, b, Chunk[b], sw_RES, SW_HW_Config, Test_Config, DEFINED_NB_OF_TESTS, Nb_Of_Errors, &out_file);
+
+		if (c >= Nb_Of_Chunks) continue;
+
+		Chunk[b].Start_Index        = c * Chunk_Size;
+		Chunk[b].Nb_Of_Test_Vectors = min(Chunk_Size, ROUNDED_NB_OF_TESTS - Chunk[b].Start_Index) / NB_OF_KERNELS;
+
+		for (int k_index=0; k_index<NB_OF_KERNELS; k_index++) {
+			t_stream_buf* Buf = &HW_Kernels[k_index].Buf[b];
+
+			// ........................................
+			// Generate test vectors: -> IN_DATA
+			// Pack them: -> host_IBuf, host_TBuf
+			// ........................................
+			generate_test_vectors(Buf->IN_DATA, Test_Config, Chunk[b].Start_Index + k_index*Chunk[b].Nb_Of_Test_Vectors, Chunk[b].Nb_Of_Test_Vectors);
+			pack_kernel_inputs(Buf->IN_DATA, Chunk[b].Nb_Of_Test_Vectors, Buf->host_IBuf, Buf->host_TBuf, 0);
+
+			// ........................................
+			// host_IBuf -> GlobMem_IBuf, host_TBuf -> GlobMem_TBuf
+			// ........................................
+			cl_mem IN_Bufs[2] = {Buf->GlobMem_IBuf, Buf->GlobMem_TBuf};
+
+			errCode = clEnqueueMigrateMemObjects(Command_Queue, 2, IN_Bufs, 0,
+												   0, NULL, &(Buf->Mem_wr_event));
+			ocl_check_status(errCode,"Failed to write: " + HW_Kernels[k_index].name + ".Host_IBuf/Host_TBuf -> " + HW_Kernels[k_index].name + ".GlobMem_IBuf/GlobMem_TBuf");
+
+			// ........................................
+			// Submit CUs
+			// ........................................
+			for (int cu_index=0; cu_index<NB_OF_CUs_PER_KERNEL; cu_index++) {
+				int Nb_Of_Test_Vectors_Per_CU = Chunk[b].Nb_Of_Test_Vectors / NB_OF_CUs_PER_KERNEL;
+				int Start_Index = cu_index * Nb_Of_Test_Vectors_Per_CU;
+				int Col_Base    = cu_index * (*SW_HW_Config).NB_OF_PARALLEL_FUNCTIONS_PER_CU * Col_Stride;
+
+				int arg_indx = 0;
+				errCode = CL_SUCCESS;
+				errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_mem),    &(Buf->GlobMem_IBuf));
+				errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_mem),    &(Buf->GlobMem_TBuf));
+				errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_mem),    &(Buf->GlobMem_OBuf));
+				errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_int),    &(Nb_Of_Test_Vectors_Per_CU));
+				errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_int),    &Start_Index);
+				errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_mem),    &(Buf->GlobMem_CBuf));
+				errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_int),    &Col_Base);
+				errCode |= clSetKernelArg(HW_Kernels[k_index].kernel,  arg_indx++, sizeof(cl_int),    &Col_Stride);
+				ocl_check_status(errCode,"Unable to setup Kernel Arguments");
+
+				errCode = clEnqueueNDRangeKernel(Command_Queue, HW_Kernels[k_index].kernel, 1, NULL, globalSize, localSize,
+						                         1, &(Buf->Mem_wr_event), &(Buf->K_exe_event[cu_index]));
+				ocl_check_status(errCode,"Failed to submit kernel for execution: " + HW_Kernels[k_index].name);
+			}
+
+			// ........................................
+			// GlobMem_OBuf -> host_OBuf
+			// ........................................
+			errCode = clEnqueueMigrateMemObjects(Command_Queue, 1, &(Buf->GlobMem_OBuf), CL_MIGRATE_MEM_OBJECT_HOST,
+												   NB_OF_CUs_PER_KERNEL, Buf->K_exe_event, &(Buf->Mem_rd_event));
+			ocl_check_status(errCode,"Failed to write: " + HW_Kernels[k_index].name + ".GlobMem_OBuf -> " + HW_Kernels[k_index].name + ".Host_OBuf");
+		}
+		clFlush(Command_Queue);
+	}
+
+	close_results_file(&out_file);
+
+	// ------------------------------------------------------------------------------------------------
+	// Release Allocated Resources
+	// ------------------------------------------------------------------------------------------------
+	for (int i=0; i<NB_OF_KERNELS; i++) {
+		for (int b=0; b<QUEUE_DEPTH; b++) {
+			clReleaseMemObject(HW_Kernels[i].Buf[b].GlobMem_IBuf);
+			clReleaseMemObject(HW_Kernels[i].Buf[b].GlobMem_TBuf);
+			clReleaseMemObject(HW_Kernels[i].Buf[b].GlobMem_OBuf);
+			clReleaseMemObject(HW_Kernels[i].Buf[b].GlobMem_CBuf);
+			free(HW_Kernels[i].Buf[b].IN_DATA);
+			free(HW_Kernels[i].Buf[b].host_IBuf);
+			free(HW_Kernels[i].Buf[b].host_TBuf);
+			free(HW_Kernels[i].Buf[b].host_OBuf);
+			delete[] HW_Kernels[i].Buf[b].K_exe_event;
+		}
+		delete[] HW_Kernels[i].Buf;
+		clReleaseKernel(HW_Kernels[i].kernel);
+	}
+	delete[] HW_Kernels;
+	delete[] Chunk;
+	free(sw_RES);
+
+	return(Nb_Of_Errors);
+}
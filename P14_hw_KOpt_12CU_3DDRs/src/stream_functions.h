@@ -0,0 +1,54 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#ifndef __STREAM_FUNCTIONS_H__
+#define __STREAM_FUNCTIONS_H__
+
+#include <string>
+#include <vector>
+
+#include <CL/cl.h>
+#include "help_functions.h"
+#include "cache_functions.h"
+
+using namespace std;
+
+// ============================================================================
+// Streaming drivers
+//   Used when ROUNDED_NB_OF_TESTS exceeds MAX_NB_OF_TESTS. Tests are generated,
+//   priced and stored chunk by chunk, so host memory does not depend on the
+//   number of tests.
+//
+//   o) K_americanPut_sw_stream: prices chunks of SW_STREAM_CHUNK_SIZE tests
+//      with the SW model. Two chunks are in flight: while one is priced,
+//      the next one is generated and the previous one is stored. The chunks
+//      are priced through the result cache (BINOMIAL_RESULT_CACHE)
+//   o) K_americanPut_hw_stream: every CU prices up to MAX_NB_OF_TESTS tests
+//      per chunk (the size of the kernel BRAM buffers). QUEUE_DEPTH sets of
+//      buffers are used: up to QUEUE_DEPTH chunks are in flight while the
+//      host generates the next chunk and checks/stores the oldest one.
+//      Returns the number of HW results which do not match the SW model.
+//      The tests are generated in the kernel buffers, so this driver does
+//      not use the result cache.
+// ============================================================================
+void K_americanPut_sw_stream(sw_hw_config_t* SW_HW_Config, vector<test_config_t>* Test_Config, t_result_cache* Cache, int DEFINED_NB_OF_TESTS, int ROUNDED_NB_OF_TESTS, string Out_File_Name);
+
+int  K_americanPut_hw_stream(cl_context Context, cl_command_queue Command_Queue, cl_program Program,
+                             sw_hw_config_t* SW_HW_Config, vector<test_config_t>* Test_Config, int DEFINED_NB_OF_TESTS, int ROUNDED_NB_OF_TESTS, string Out_File_Name);
+
+#endif
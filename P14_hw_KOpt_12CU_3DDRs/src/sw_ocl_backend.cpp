@@ -0,0 +1,721 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+// ============================================================================
+// SW OpenCL Backend
+//   Implements the subset of the OpenCL API used by the Host code and runs
+//   the kernels of K0.cpp, K1.cpp and K2.cpp (compiled as C++, both the
+//   K_americanPut_<k> and the dataflow K_americanPut_df_<k> kernels) on a thread
+//   pool, so the Host code can be run and profiled without XRT and a card.
+//
+//   Build the Host code with -DSW_OCL_BACKEND together with K0.cpp, K1.cpp,
+//   K2.cpp and this file instead of linking the XRT OpenCL library.
+//
+//   o) Platform "Xilinx" with a single device named SW_OCL_DEVICE_NAME
+//      (environment variable, default SW_OCL_DEFAULT_DEVICE_NAME)
+//   o) The xclbin file is read by the Host code but not used
+//   o) Buffers have their own (Global) memory: data is only copied by
+//      clEnqueueMigrateMemObjects, like on the card
+//   o) Kernels run on up to Nb_Of_CUs compute units at a time and can only
+//      access buffers of their memory bank (see SW_OCL_Kernels, same mapping
+//      as the --sp options of description.json, or the memory topology
+//      indices listed in the SW_OCL_MEM_BANKS environment variable, e.g.
+//      "0,1,2,3"). XCL_MEM_DDR_BANK<i> flags select bank i, XCL_MEM_TOPOLOGY
+//      flags the bank given by their index. A kernel created with the
+//      "<kernel>:{<kernel>_<cu>}" name only runs on CU <cu> (1 ... Nb_Of_CUs)
+//   o) Commands of out-of-order queues only wait for their event wait list,
+//      events have profiling info and CL_COMPLETE callbacks
+//   o) The pool has SW_OCL_NB_OF_THREADS threads (environment variable,
+//      default: number of CUs + 2)
+// ============================================================================
+#ifdef SW_OCL_BACKEND
+
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <chrono>
+
+using namespace std;
+
+#include <CL/cl.h>
+#include <CL/cl_ext.h>
+
+#include "kernel.h"
+
+#define SW_OCL_DEFAULT_DEVICE_NAME "xilinx_u200_xdma_201830_1"
+
+extern "C" {
+void K_americanPut_0(t_in_option* IN_Option, t_tree_params* IN_Tree, float* Res, int Nb_of_Tests, int Start_Index, float* Col, int Col_Base, int Col_Stride);
+void K_americanPut_1(t_in_option* IN_Option, t_tree_params* IN_Tree, float* Res, int Nb_of_Tests, int Start_Index, float* Col, int Col_Base, int Col_Stride);
+void K_americanPut_2(t_in_option* IN_Option, t_tree_params* IN_Tree, float* Res, int Nb_of_Tests, int Start_Index, float* Col, int Col_Base, int Col_Stride);
+void K_americanPut_df_0(t_in_option* IN_Option, t_tree_params* IN_Tree, float* Res, int Nb_of_Tests, int Start_Index, float* Col, int Col_Base, int Col_Stride);
+void K_americanPut_df_1(t_in_option* IN_Option, t_tree_params* IN_Tree, float* Res, int Nb_of_Tests, int Start_Index, float* Col, int Col_Base, int Col_Stride);
+void K_americanPut_df_2(t_in_option* IN_Option, t_tree_params* IN_Tree, float* Res, int Nb_of_Tests, int Start_Index, float* Col, int Col_Base, int Col_Stride);
+}
+
+// ............................................................................
+// Kernels implemented in the xclbin
+// ............................................................................
+typedef void (*t_sw_ocl_kernel_function)(t_in_option*, t_tree_params*, float*, int, int, float*, int, int);
+
+#define SW_OCL_NB_OF_ARGS 8
+enum { ARG_IN_OPTION, ARG_IN_TREE, ARG_RES, ARG_NB_OF_TESTS, ARG_START_INDEX, ARG_COL, ARG_COL_BASE, ARG_COL_STRIDE };
+
+typedef struct {
+	const char*              Name;
+	t_sw_ocl_kernel_function Function;
+	int                      Nb_Of_CUs;
+	int                      Nb_Of_Parallel_Functions;    // Per CU: number of Col columns used by a CU
+	int                      Max_Nb_Of_Tests;             // Per run
+	int                      Index;                       // <k> of the kernel name, selects the SW_OCL_MEM_BANKS entry
+	int                      Mem_Bank;                    // Memory topology index (DDR[i]: i) of all buffer arguments
+} t_sw_ocl_kernel_info;
+
+// The BRAM kernels and their dataflow variants (both kinds are available, as if linked in the same xclbin)
+static t_sw_ocl_kernel_info SW_OCL_Kernels[] = {
+	{"K_americanPut_0",    K_americanPut_0,    4, CONST_NB_OF_PARALLEL_FUNCTIONS, CONST_MAX_NB_OF_TESTS,    0, 0},
+	{"K_americanPut_1",    K_americanPut_1,    4, CONST_NB_OF_PARALLEL_FUNCTIONS, CONST_MAX_NB_OF_TESTS,    1, 2},
+	{"K_americanPut_2",    K_americanPut_2,    4, CONST_NB_OF_PARALLEL_FUNCTIONS, CONST_MAX_NB_OF_TESTS,    2, 3},
+	{"K_americanPut_df_0", K_americanPut_df_0, 4, CONST_NB_OF_PARALLEL_FUNCTIONS, CONST_MAX_DF_NB_OF_TESTS, 0, 0},
+	{"K_americanPut_df_1", K_americanPut_df_1, 4, CONST_NB_OF_PARALLEL_FUNCTIONS, CONST_MAX_DF_NB_OF_TESTS, 1, 2},
+	{"K_americanPut_df_2", K_americanPut_df_2, 4, CONST_NB_OF_PARALLEL_FUNCTIONS, CONST_MAX_DF_NB_OF_TESTS, 2, 3}
+};
+#define SW_OCL_NB_OF_KERNELS ((int)(sizeof(SW_OCL_Kernels)/sizeof(SW_OCL_Kernels[0])))
+#define SW_OCL_MAX_NB_OF_CUs 16
+
+#define XCL_MEM_DDR_BANK_MASK (XCL_MEM_DDR_BANK0 | XCL_MEM_DDR_BANK1 | XCL_MEM_DDR_BANK2 | XCL_MEM_DDR_BANK3)
+
+// Memory topology index selected by Xilinx Extension flags (-1: not specified)
+static int sw_ocl_mem_bank(unsigned Flags) {
+	if (Flags & XCL_MEM_TOPOLOGY) return (int)(Flags & 0xffff);
+	for (int i=0; i<4; i++)
+		if (Flags & (XCL_MEM_DDR_BANK0 << i)) return i;
+	return -1;
+}
+
+static cl_ulong sw_ocl_time_ns() {
+	return (cl_ulong)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+// ============================================================================
+// OpenCL objects
+// ============================================================================
+struct _cl_platform_id { int dummy; };
+struct _cl_device_id   { string Name; };
+struct _cl_context     { int dummy; };
+struct _cl_program     { int dummy; };
+
+struct _cl_mem {
+	size_t           Size;
+	void*            Host_Ptr;          // NULL unless CL_MEM_USE_HOST_PTR
+	char*            Global_Mem;
+	int              Mem_Bank;          // -1: not specified
+};
+
+struct _cl_kernel {
+	int              Kernel_Index;      // SW_OCL_Kernels[Kernel_Index]
+	int              CU_Index;          // -1: any CU of the kernel
+	cl_mem           Mem_Args[SW_OCL_NB_OF_ARGS];
+	cl_int           Int_Args[SW_OCL_NB_OF_ARGS];
+	bool             Arg_Set[SW_OCL_NB_OF_ARGS];
+};
+
+struct _cl_event {
+	atomic<int>        Ref_Count;
+	mutex              Mutex;
+	condition_variable Done_CV;
+	bool               Complete;
+	bool               Profiling;
+	cl_ulong           Queued, Submit, Start, End;
+
+	vector<pair<void (*)(cl_event, cl_int, void*), void*>> Callbacks;     // CL_COMPLETE callbacks
+};
+
+struct _cl_command_queue {
+	bool               Profiling;
+	bool               In_Order;
+	mutex              Mutex;
+	condition_variable Done_CV;
+	int                Nb_Of_Pending;
+	cl_event           Last_Event;      // In-order queues: the next command waits for it
+};
+
+static _cl_platform_id SW_OCL_Platform;
+static _cl_device_id   SW_OCL_Device;
+
+static void sw_ocl_release_event(cl_event Event) {
+	if (--(Event->Ref_Count) == 0)
+		delete Event;
+}
+
+static void sw_ocl_wait_event(cl_event Event) {
+	unique_lock<mutex> lock(Event->Mutex);
+	Event->Done_CV.wait(lock, [Event]{ return Event->Complete; });
+}
+
+
+// ============================================================================
+// Thread pool: commands are started in the order they are enqueued. A command
+// waits for its event wait list (commands enqueued before it), therefore the
+// oldest pending command can always complete.
+// ============================================================================
+class SW_OCL_Pool {
+public:
+	SW_OCL_Pool() : Stop(false) {
+		int Nb_Of_CUs = 0;
+		for (int k=0; k<SW_OCL_NB_OF_KERNELS; k++) {
+			Nb_Of_CUs += SW_OCL_Kernels[k].Nb_Of_CUs;
+			for (int c=0; c<SW_OCL_MAX_NB_OF_CUs; c++)
+				CU_Busy[k][c] = (c >= SW_OCL_Kernels[k].Nb_Of_CUs);
+		}
+
+		int   Nb_Of_Threads = Nb_Of_CUs + 2;
+		char *env           = getenv("SW_OCL_NB_OF_THREADS");
+		if ((env != NULL) && (atoi(env) > 0))
+			Nb_Of_Threads = atoi(env);
+
+		cout << "HOST-Info: SW OpenCL backend: " << Nb_Of_Threads << " threads, " << Nb_Of_CUs << " CUs" << endl;
+
+		for (int i=0; i<Nb_Of_Threads; i++)
+			Threads.push_back(thread(&SW_OCL_Pool::worker, this));
+	}
+
+	~SW_OCL_Pool() {
+		{
+			lock_guard<mutex> lock(Mutex);
+			Stop = true;
+		}
+		Task_CV.notify_all();
+		for (unsigned i=0; i<Threads.size(); i++)
+			Threads[i].join();
+	}
+
+	void submit(const function<void()>& Task) {
+		{
+			lock_guard<mutex> lock(Mutex);
+			Tasks.push_back(Task);
+		}
+		Task_CV.notify_one();
+	}
+
+	// A kernel run occupies CU_Index (or any free CU if CU_Index < 0) of the kernel. Returns the CU
+	int acquire_cu(int Kernel_Index, int CU_Index) {
+		unique_lock<mutex> lock(CU_Mutex);
+		int Free_CU = -1;
+		CU_CV.wait(lock, [this, Kernel_Index, CU_Index, &Free_CU]{
+			for (int c=0; c<SW_OCL_MAX_NB_OF_CUs; c++)
+				if (!CU_Busy[Kernel_Index][c] && ((CU_Index < 0) || (c == CU_Index))) { Free_CU = c; return true; }
+			return false;
+		});
+		CU_Busy[Kernel_Index][Free_CU] = true;
+		return(Free_CU);
+	}
+
+	void release_cu(int Kernel_Index, int CU_Index) {
+		{
+			lock_guard<mutex> lock(CU_Mutex);
+			CU_Busy[Kernel_Index][CU_Index] = false;
+		}
+		CU_CV.notify_all();
+	}
+
+private:
+	void worker() {
+		while (true) {
+			function<void()> Task;
+			{
+				unique_lock<mutex> lock(Mutex);
+				Task_CV.wait(lock, [this]{ return Stop || !Tasks.empty(); });
+				if (Tasks.empty()) return;
+				Task = Tasks.front();
+				Tasks.pop_front();
+			}
+			Task();
+		}
+	}
+
+	vector<thread>             Threads;
+	deque<function<void()>>    Tasks;
+	mutex                      Mutex;
+	condition_variable         Task_CV;
+	bool                       Stop;
+
+	bool                       CU_Busy[SW_OCL_NB_OF_KERNELS][SW_OCL_MAX_NB_OF_CUs];
+	mutex                      CU_Mutex;
+	condition_variable         CU_CV;
+};
+
+static SW_OCL_Pool* sw_ocl_pool() {
+	static SW_OCL_Pool Pool;
+	return(&Pool);
+}
+
+
+// ----------------------------------------------------------------------------
+// Enqueue a command: it runs Body once all events of the wait list (and the
+// previous command of an in-order queue) are complete. Kernel runs
+// (Kernel_Index >= 0) also wait for a free CU of the kernel (CU_Index or any).
+// ----------------------------------------------------------------------------
+static cl_int sw_ocl_enqueue(cl_command_queue Queue, cl_uint Nb_Of_Events, const cl_event* Event_Wait_List, cl_event* Event,
+                             int Kernel_Index, int CU_Index, const function<void()>& Body) {
+	if (Queue == NULL) return CL_INVALID_COMMAND_QUEUE;
+	if ((Nb_Of_Events > 0) && (Event_Wait_List == NULL)) return CL_INVALID_EVENT_WAIT_LIST;
+
+	vector<cl_event> Wait_List;
+	for (cl_uint i=0; i<Nb_Of_Events; i++) {
+		if (Event_Wait_List[i] == NULL) return CL_INVALID_EVENT_WAIT_LIST;
+		Wait_List.push_back(Event_Wait_List[i]);
+	}
+
+	cl_event New_Event = new _cl_event();
+	New_Event->Ref_Count = (Event != NULL) ? 2 : 1;     // Application + command
+	New_Event->Complete  = false;
+	New_Event->Profiling = Queue->Profiling;
+	New_Event->Queued    = sw_ocl_time_ns();
+	New_Event->Submit    = New_Event->Queued;
+	New_Event->Start     = 0;
+	New_Event->End       = 0;
+
+	{
+		lock_guard<mutex> lock(Queue->Mutex);
+		Queue->Nb_Of_Pending++;
+		if (Queue->In_Order) {
+			if (Queue->Last_Event != NULL) Wait_List.push_back(Queue->Last_Event);    // Reference moved to the command
+			New_Event->Ref_Count++;
+			Queue->Last_Event = New_Event;
+		}
+	}
+	for (unsigned i=0; i<Nb_Of_Events; i++)
+		Wait_List[i]->Ref_Count++;
+
+	sw_ocl_pool()->submit([Queue, Wait_List, New_Event, Kernel_Index, CU_Index, Body]() {
+		for (unsigned i=0; i<Wait_List.size(); i++)
+			sw_ocl_wait_event(Wait_List[i]);
+
+		int CU = (Kernel_Index >= 0) ? sw_ocl_pool()->acquire_cu(Kernel_Index, CU_Index) : -1;
+		New_Event->Start = sw_ocl_time_ns();
+		Body();
+		if (Kernel_Index >= 0) sw_ocl_pool()->release_cu(Kernel_Index, CU);
+
+		vector<pair<void (*)(cl_event, cl_int, void*), void*>> Callbacks;
+		{
+			lock_guard<mutex> lock(New_Event->Mutex);
+			New_Event->End      = sw_ocl_time_ns();
+			New_Event->Complete = true;
+			Callbacks.swap(New_Event->Callbacks);
+		}
+		New_Event->Done_CV.notify_all();
+
+		for (unsigned i=0; i<Callbacks.size(); i++)
+			Callbacks[i].first(New_Event, CL_COMPLETE, Callbacks[i].second);
+
+		for (unsigned i=0; i<Wait_List.size(); i++)
+			sw_ocl_release_event(Wait_List[i]);
+
+		{
+			lock_guard<mutex> lock(Queue->Mutex);
+			Queue->Nb_Of_Pending--;
+		}
+		Queue->Done_CV.notify_all();
+
+		sw_ocl_release_event(New_Event);
+	});
+
+	if (Event != NULL) *Event = New_Event;
+	return CL_SUCCESS;
+}
+
+static cl_int sw_ocl_get_info(const void* Value, size_t Value_Size, size_t Param_Value_Size, void* Param_Value, size_t* Param_Value_Size_Ret) {
+	if (Param_Value != NULL) {
+		if (Param_Value_Size < Value_Size) return CL_INVALID_VALUE;
+		memcpy(Param_Value, Value, Value_Size);
+	}
+	if (Param_Value_Size_Ret != NULL) *Param_Value_Size_Ret = Value_Size;
+	return CL_SUCCESS;
+}
+
+
+// ============================================================================
+// Platform, Device, Context, Program
+// ============================================================================
+cl_int clGetPlatformIDs(cl_uint Nb_Of_Entries, cl_platform_id* Platforms, cl_uint* Nb_Of_Platforms) {
+	if ((Platforms != NULL) && (Nb_Of_Entries == 0)) return CL_INVALID_VALUE;
+	if (Platforms != NULL)       Platforms[0]       = &SW_OCL_Platform;
+	if (Nb_Of_Platforms != NULL) *Nb_Of_Platforms = 1;
+	return CL_SUCCESS;
+}
+
+cl_int clGetPlatformInfo(cl_platform_id Platform, cl_platform_info Param_Name, size_t Param_Value_Size, void* Param_Value, size_t* Param_Value_Size_Ret) {
+	const char* Name = "Xilinx";
+
+	if (Platform != &SW_OCL_Platform) return CL_INVALID_PLATFORM;
+	if ((Param_Name != CL_PLATFORM_NAME) && (Param_Name != CL_PLATFORM_VENDOR)) return CL_INVALID_VALUE;
+	return sw_ocl_get_info(Name, strlen(Name)+1, Param_Value_Size, Param_Value, Param_Value_Size_Ret);
+}
+
+cl_int clGetDeviceIDs(cl_platform_id Platform, cl_device_type /* Device_Type */, cl_uint Nb_Of_Entries, cl_device_id* Devices, cl_uint* Nb_Of_Devices) {
+	if (Platform != &SW_OCL_Platform) return CL_INVALID_PLATFORM;
+	if ((Devices != NULL) && (Nb_Of_Entries == 0)) return CL_INVALID_VALUE;
+
+	if (SW_OCL_Device.Name.empty()) {
+		char *env = getenv("SW_OCL_DEVICE_NAME");
+		SW_OCL_Device.Name = (env != NULL) ? env : SW_OCL_DEFAULT_DEVICE_NAME;
+	}
+
+	if (Devices != NULL)       Devices[0]      = &SW_OCL_Device;
+	if (Nb_Of_Devices != NULL) *Nb_Of_Devices = 1;
+	return CL_SUCCESS;
+}
+
+cl_int clGetDeviceInfo(cl_device_id Device, cl_device_info Param_Name, size_t Param_Value_Size, void* Param_Value, size_t* Param_Value_Size_Ret) {
+	if (Device != &SW_OCL_Device) return CL_INVALID_DEVICE;
+	if (Param_Name != CL_DEVICE_NAME) return CL_INVALID_VALUE;
+	return sw_ocl_get_info(Device->Name.c_str(), Device->Name.size()+1, Param_Value_Size, Param_Value, Param_Value_Size_Ret);
+}
+
+cl_context clCreateContext(const cl_context_properties* /* Properties */, cl_uint Nb_Of_Devices, const cl_device_id* Devices,
+                           void (* /* pfn_notify */)(const char*, const void*, size_t, void*), void* /* User_Data */, cl_int* errCode) {
+	if ((Nb_Of_Devices != 1) || (Devices == NULL) || (Devices[0] != &SW_OCL_Device)) {
+		if (errCode != NULL) *errCode = CL_INVALID_DEVICE;
+		return NULL;
+	}
+	if (errCode != NULL) *errCode = CL_SUCCESS;
+	return new _cl_context();
+}
+
+cl_command_queue clCreateCommandQueue(cl_context Context, cl_device_id Device, cl_command_queue_properties Properties, cl_int* errCode) {
+	if ((Context == NULL) || (Device != &SW_OCL_Device)) {
+		if (errCode != NULL) *errCode = (Context == NULL) ? CL_INVALID_CONTEXT : CL_INVALID_DEVICE;
+		return NULL;
+	}
+
+	cl_command_queue Queue = new _cl_command_queue();
+	Queue->Profiling     = (Properties & CL_QUEUE_PROFILING_ENABLE) != 0;
+	Queue->In_Order      = (Properties & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE) == 0;
+	Queue->Nb_Of_Pending = 0;
+	Queue->Last_Event    = NULL;
+
+	sw_ocl_pool();
+
+	if (errCode != NULL) *errCode = CL_SUCCESS;
+	return Queue;
+}
+
+cl_program clCreateProgramWithBinary(cl_context Context, cl_uint /* Nb_Of_Devices */, const cl_device_id* /* Devices */, const size_t* /* Lengths */,
+                                     const unsigned char** /* Binaries */, cl_int* Binary_Status, cl_int* errCode) {
+	if (Context == NULL) {
+		if (errCode != NULL) *errCode = CL_INVALID_CONTEXT;
+		return NULL;
+	}
+
+	// Connectivity of the "xclbin": memory bank of each kernel
+	char *env = getenv("SW_OCL_MEM_BANKS");
+	if (env != NULL) {
+		stringstream Banks(env);
+		string       Bank;
+		for (int i=0; getline(Banks, Bank, ','); i++)
+			for (int k=0; k<SW_OCL_NB_OF_KERNELS; k++)
+				if (SW_OCL_Kernels[k].Index == i) SW_OCL_Kernels[k].Mem_Bank = atoi(Bank.c_str());
+	}
+
+	if (Binary_Status != NULL) Binary_Status[0] = CL_SUCCESS;
+	if (errCode != NULL) *errCode = CL_SUCCESS;
+	return new _cl_program();
+}
+
+cl_int clBuildProgram(cl_program Program, cl_uint /* Nb_Of_Devices */, const cl_device_id* /* Devices */, const char* /* Options */,
+                      void (* /* pfn_notify */)(cl_program, void*), void* /* User_Data */) {
+	return (Program == NULL) ? CL_INVALID_PROGRAM : CL_SUCCESS;
+}
+
+cl_kernel clCreateKernel(cl_program /* Program */, const char* Kernel_Name, cl_int* errCode) {
+	// "<kernel>" or "<kernel>:{<kernel>_<cu>}"
+	string Name    = Kernel_Name;
+	string CU_Name = "";
+	size_t Colon   = Name.find(':');
+
+	if (Colon != string::npos) {
+		CU_Name = Name.substr(Colon+1);
+		Name    = Name.substr(0, Colon);
+		if ((CU_Name.size() < 3) || (CU_Name.front() != '{') || (CU_Name.back() != '}')) CU_Name = "?";
+		else                                                                               CU_Name = CU_Name.substr(1, CU_Name.size()-2);
+	}
+
+	for (int k=0; k<SW_OCL_NB_OF_KERNELS; k++) {
+		if (Name == SW_OCL_Kernels[k].Name) {
+			int CU_Index = -1;
+			for (int c=0; c<SW_OCL_Kernels[k].Nb_Of_CUs; c++)
+				if (CU_Name == Name + "_" + to_string(c+1)) CU_Index = c;
+			if (!CU_Name.empty() && (CU_Index < 0)) break;
+
+			cl_kernel Kernel = new _cl_kernel();
+			Kernel->Kernel_Index = k;
+			Kernel->CU_Index     = CU_Index;
+			for (int a=0; a<SW_OCL_NB_OF_ARGS; a++) Kernel->Arg_Set[a] = false;
+
+			if (errCode != NULL) *errCode = CL_SUCCESS;
+			return Kernel;
+		}
+	}
+	if (errCode != NULL) *errCode = CL_INVALID_KERNEL_NAME;
+	return NULL;
+}
+
+
+// ============================================================================
+// Buffers
+// ============================================================================
+cl_mem clCreateBuffer(cl_context Context, cl_mem_flags Flags, size_t Size, void* Host_Ptr, cl_int* errCode) {
+	if (Context == NULL) {
+		if (errCode != NULL) *errCode = CL_INVALID_CONTEXT;
+		return NULL;
+	}
+	if (Size == 0) {
+		if (errCode != NULL) *errCode = CL_INVALID_BUFFER_SIZE;
+		return NULL;
+	}
+
+	cl_mem Mem = new _cl_mem();
+	Mem->Size     = Size;
+	Mem->Host_Ptr = NULL;
+	Mem->Mem_Bank = -1;
+
+	if (Flags & CL_MEM_EXT_PTR_XILINX) {
+		cl_mem_ext_ptr_t* Ext = (cl_mem_ext_ptr_t*)Host_Ptr;
+		Mem->Mem_Bank = (Ext != NULL) ? sw_ocl_mem_bank(Ext->flags) : -1;
+		Host_Ptr      = (Ext != NULL) ? Ext->obj : NULL;
+	}
+	if (Flags & CL_MEM_USE_HOST_PTR) {
+		if (Host_Ptr == NULL) {
+			delete Mem;
+			if (errCode != NULL) *errCode = CL_INVALID_VALUE;
+			return NULL;
+		}
+		Mem->Host_Ptr = Host_Ptr;
+	}
+
+	Mem->Global_Mem = new char[Size]();
+
+	if (errCode != NULL) *errCode = CL_SUCCESS;
+	return Mem;
+}
+
+cl_int clEnqueueMigrateMemObjects(cl_command_queue Queue, cl_uint Nb_Of_Mem_Objects, const cl_mem* Mem_Objects, cl_mem_migration_flags Flags,
+                                  cl_uint Nb_Of_Events, const cl_event* Event_Wait_List, cl_event* Event) {
+	if ((Nb_Of_Mem_Objects == 0) || (Mem_Objects == NULL)) return CL_INVALID_VALUE;
+
+	vector<cl_mem> Mems(Mem_Objects, Mem_Objects + Nb_Of_Mem_Objects);
+	for (unsigned i=0; i<Mems.size(); i++)
+		if (Mems[i] == NULL) return CL_INVALID_MEM_OBJECT;
+
+	return sw_ocl_enqueue(Queue, Nb_Of_Events, Event_Wait_List, Event, -1, -1, [Mems, Flags]() {
+		if (Flags & CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED) return;
+		for (unsigned i=0; i<Mems.size(); i++) {
+			if (Mems[i]->Host_Ptr == NULL) continue;
+			if (Flags & CL_MIGRATE_MEM_OBJECT_HOST) memcpy(Mems[i]->Host_Ptr, Mems[i]->Global_Mem, Mems[i]->Size);
+			else                                    memcpy(Mems[i]->Global_Mem, Mems[i]->Host_Ptr, Mems[i]->Size);
+		}
+	});
+}
+
+
+// ============================================================================
+// Kernels
+// ============================================================================
+cl_int clSetKernelArg(cl_kernel Kernel, cl_uint Arg_Index, size_t Arg_Size, const void* Arg_Value) {
+	if (Kernel == NULL) return CL_INVALID_KERNEL;
+	if (Arg_Index >= SW_OCL_NB_OF_ARGS) return CL_INVALID_ARG_INDEX;
+	if (Arg_Value == NULL) return CL_INVALID_ARG_VALUE;
+
+	const t_sw_ocl_kernel_info* Info = &SW_OCL_Kernels[Kernel->Kernel_Index];
+
+	if ((Arg_Index == ARG_IN_OPTION) || (Arg_Index == ARG_IN_TREE) || (Arg_Index == ARG_RES) || (Arg_Index == ARG_COL)) {
+		if (Arg_Size != sizeof(cl_mem)) return CL_INVALID_ARG_SIZE;
+
+		cl_mem Mem = *(const cl_mem*)Arg_Value;
+		if (Mem == NULL) return CL_INVALID_MEM_OBJECT;
+
+		// The CUs of a kernel are only connected to their memory bank
+		if ((Mem->Mem_Bank >= 0) && (Mem->Mem_Bank != Info->Mem_Bank)) {
+			cout << "HOST-Error: SW OpenCL backend: argument " << Arg_Index << " of " << Info->Name << " is not allocated in the memory bank of the kernel" << endl;
+			return CL_INVALID_MEM_OBJECT;
+		}
+		Kernel->Mem_Args[Arg_Index] = Mem;
+	} else {
+		if (Arg_Size != sizeof(cl_int)) return CL_INVALID_ARG_SIZE;
+		Kernel->Int_Args[Arg_Index] = *(const cl_int*)Arg_Value;
+	}
+	Kernel->Arg_Set[Arg_Index] = true;
+	return CL_SUCCESS;
+}
+
+cl_int clEnqueueNDRangeKernel(cl_command_queue Queue, cl_kernel Kernel, cl_uint /* Work_Dim */, const size_t* /* Global_Work_Offset */,
+                              const size_t* /* Global_Work_Size */, const size_t* /* Local_Work_Size */,
+                              cl_uint Nb_Of_Events, const cl_event* Event_Wait_List, cl_event* Event) {
+	if (Kernel == NULL) return CL_INVALID_KERNEL;
+	for (int a=0; a<SW_OCL_NB_OF_ARGS; a++)
+		if (!Kernel->Arg_Set[a]) return CL_INVALID_KERNEL_ARGS;
+
+	// Arguments are captured when the kernel is enqueued
+	_cl_kernel                  Args = *Kernel;
+	const t_sw_ocl_kernel_info* Info = &SW_OCL_Kernels[Kernel->Kernel_Index];
+
+	// ............................................................
+	// Check the accesses of the kernel against the buffer sizes
+	// ............................................................
+	long Nb_Of_Tests = Args.Int_Args[ARG_NB_OF_TESTS];
+	long Last_Test   = (long)Args.Int_Args[ARG_START_INDEX] + Nb_Of_Tests;
+	long Last_Col    = (long)Args.Int_Args[ARG_COL_BASE] + (long)Info->Nb_Of_Parallel_Functions*Args.Int_Args[ARG_COL_STRIDE];
+
+	if ((Nb_Of_Tests < 0) || (Args.Int_Args[ARG_START_INDEX] < 0) || (Args.Int_Args[ARG_COL_BASE] < 0) || (Nb_Of_Tests > Info->Max_Nb_Of_Tests) ||
+		(Last_Test * (long)sizeof(t_in_option) > (long)Args.Mem_Args[ARG_IN_OPTION]->Size) ||
+		(Last_Test * (long)sizeof(float)       > (long)Args.Mem_Args[ARG_RES]->Size) ||
+		(Last_Col  * (long)sizeof(float)       > (long)Args.Mem_Args[ARG_COL]->Size)) {
+		cout << "HOST-Error: SW OpenCL backend: " << Info->Name << " arguments access data outside of the buffers" << endl;
+		return CL_INVALID_KERNEL_ARGS;
+	}
+
+	return sw_ocl_enqueue(Queue, Nb_Of_Events, Event_Wait_List, Event, Kernel->Kernel_Index, Kernel->CU_Index, [Args, Info]() {
+		Info->Function((t_in_option*)Args.Mem_Args[ARG_IN_OPTION]->Global_Mem, (t_tree_params*)Args.Mem_Args[ARG_IN_TREE]->Global_Mem,
+		               (float*)Args.Mem_Args[ARG_RES]->Global_Mem,
+		               Args.Int_Args[ARG_NB_OF_TESTS], Args.Int_Args[ARG_START_INDEX],
+		               (float*)Args.Mem_Args[ARG_COL]->Global_Mem, Args.Int_Args[ARG_COL_BASE], Args.Int_Args[ARG_COL_STRIDE]);
+	});
+}
+
+
+// ============================================================================
+// Synchronization and Events
+// ============================================================================
+cl_int clWaitForEvents(cl_uint Nb_Of_Events, const cl_event* Event_List) {
+	if ((Nb_Of_Events == 0) || (Event_List == NULL)) return CL_INVALID_VALUE;
+	for (cl_uint i=0; i<Nb_Of_Events; i++) {
+		if (Event_List[i] == NULL) return CL_INVALID_EVENT;
+		sw_ocl_wait_event(Event_List[i]);
+	}
+	return CL_SUCCESS;
+}
+
+cl_int clFinish(cl_command_queue Queue) {
+	if (Queue == NULL) return CL_INVALID_COMMAND_QUEUE;
+	unique_lock<mutex> lock(Queue->Mutex);
+	Queue->Done_CV.wait(lock, [Queue]{ return Queue->Nb_Of_Pending == 0; });
+	return CL_SUCCESS;
+}
+
+// Commands are submitted to the thread pool when they are enqueued
+cl_int clFlush(cl_command_queue Queue) {
+	return (Queue == NULL) ? CL_INVALID_COMMAND_QUEUE : CL_SUCCESS;
+}
+
+cl_int clGetEventProfilingInfo(cl_event Event, cl_profiling_info Param_Name, size_t Param_Value_Size, void* Param_Value, size_t* Param_Value_Size_Ret) {
+	if (Event == NULL) return CL_INVALID_EVENT;
+
+	lock_guard<mutex> lock(Event->Mutex);
+	if (!Event->Profiling || !Event->Complete) return CL_PROFILING_INFO_NOT_AVAILABLE;
+
+	cl_ulong Value;
+	switch (Param_Name) {
+		case CL_PROFILING_COMMAND_QUEUED: Value = Event->Queued; break;
+		case CL_PROFILING_COMMAND_SUBMIT: Value = Event->Submit; break;
+		case CL_PROFILING_COMMAND_START:  Value = Event->Start;  break;
+		case CL_PROFILING_COMMAND_END:    Value = Event->End;    break;
+		default: return CL_INVALID_VALUE;
+	}
+	return sw_ocl_get_info(&Value, sizeof(Value), Param_Value_Size, Param_Value, Param_Value_Size_Ret);
+}
+
+cl_int clSetEventCallback(cl_event Event, cl_int Command_Exec_Callback_Type, void (*pfn_notify)(cl_event, cl_int, void*), void* User_Data) {
+	if (Event == NULL) return CL_INVALID_EVENT;
+	if ((pfn_notify == NULL) || (Command_Exec_Callback_Type != CL_COMPLETE)) return CL_INVALID_VALUE;
+
+	{
+		lock_guard<mutex> lock(Event->Mutex);
+		if (!Event->Complete) {
+			Event->Callbacks.push_back(make_pair(pfn_notify, User_Data));
+			return CL_SUCCESS;
+		}
+	}
+	pfn_notify(Event, CL_COMPLETE, User_Data);
+	return CL_SUCCESS;
+}
+
+cl_int clRetainEvent(cl_event Event) {
+	if (Event == NULL) return CL_INVALID_EVENT;
+	Event->Ref_Count++;
+	return CL_SUCCESS;
+}
+
+
+// ============================================================================
+// Release
+// ============================================================================
+cl_int clReleaseEvent(cl_event Event) {
+	if (Event == NULL) return CL_INVALID_EVENT;
+	sw_ocl_release_event(Event);
+	return CL_SUCCESS;
+}
+
+cl_int clReleaseMemObject(cl_mem Mem) {
+	if (Mem == NULL) return CL_INVALID_MEM_OBJECT;
+	delete[] Mem->Global_Mem;
+	delete Mem;
+	return CL_SUCCESS;
+}
+
+cl_int clReleaseKernel(cl_kernel Kernel) {
+	if (Kernel == NULL) return CL_INVALID_KERNEL;
+	delete Kernel;
+	return CL_SUCCESS;
+}
+
+cl_int clReleaseProgram(cl_program Program) {
+	if (Program == NULL) return CL_INVALID_PROGRAM;
+	delete Program;
+	return CL_SUCCESS;
+}
+
+cl_int clReleaseCommandQueue(cl_command_queue Queue) {
+	if (Queue == NULL) return CL_INVALID_COMMAND_QUEUE;
+	clFinish(Queue);
+	if (Queue->Last_Event != NULL) sw_ocl_release_event(Queue->Last_Event);
+	delete Queue;
+	return CL_SUCCESS;
+}
+
+cl_int clReleaseContext(cl_context Context) {
+	if (Context == NULL) return CL_INVALID_CONTEXT;
+	delete Context;
+	return CL_SUCCESS;
+}
+
+cl_int clReleaseDevice(cl_device_id Device) {
+	return (Device == &SW_OCL_Device) ? CL_SUCCESS : CL_INVALID_DEVICE;
+}
+
+#endif
@@ -0,0 +1,35 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#ifndef __TIME_FUNCTIONS_H__
+#define __TIME_FUNCTIONS_H__
+
+#include <sys/time.h>
+
+// ============================================================================
+// Host Wall Clock
+//   Milliseconds since the epoch (gettimeofday); the difference of two calls
+//   is the elapsed time of the section in between
+// ============================================================================
+static inline double get_time_ms() {
+	struct timeval t;
+	gettimeofday(&t, NULL);
+	return 1.0e3*t.tv_sec + 1.0e-3*t.tv_usec;
+}
+
+#endif
@@ -0,0 +1,199 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#include <sys/time.h>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <map>
+#include <cstdlib>
+
+using namespace std;
+
+#include <CL/cl.h>
+
+#include "trace_functions.h"
+
+typedef struct {
+	string   Name;
+	string   Category;
+	int      Pid;                               // TRACE_PID_HOST or TRACE_PID_DEVICE
+	string   Track;
+	double   Start_us;                          // Host events: host time; device events: set by trace_write
+	double   Duration_us;
+
+	cl_ulong Queued;                            // Device events (ns, device clock)
+	cl_ulong Start;
+	cl_ulong End;
+	int      Sync;                              // Device events: index of the trace_device_sync call
+} t_trace_event;
+
+#define TRACE_PID_HOST   1
+#define TRACE_PID_DEVICE 2
+
+static string                File_Name;
+static bool                  Enabled = false;
+static double                Origin_us;
+static vector<t_trace_event> Events;
+static vector<double>        Sync_us;          // Host time of each trace_device_sync call
+
+static double host_time_us() {
+	struct timeval t;
+	gettimeofday(&t, NULL);
+	return 1.0e6*t.tv_sec + t.tv_usec;
+}
+
+double trace_now_us() {
+	return host_time_us() - Origin_us;
+}
+
+bool trace_enabled() {
+	return Enabled;
+}
+
+void trace_host_phase(string Name, double Start_us) {
+	if (!Enabled) return;
+
+	t_trace_event Event;
+	Event.Name        = Name;
+	Event.Category    = "host";
+	Event.Pid         = TRACE_PID_HOST;
+	Event.Track       = "Host";
+	Event.Start_us    = Start_us;
+	Event.Duration_us = trace_now_us() - Start_us;
+	Events.push_back(Event);
+}
+
+void trace_device_sync() {
+	if (!Enabled) return;
+	Sync_us.push_back(trace_now_us());
+}
+
+void trace_device_event(string Track, string Name, string Category, cl_event Event) {
+	if (!Enabled || Sync_us.empty()) return;
+
+	t_trace_event Trace_Event;
+	Trace_Event.Name     = Name;
+	Trace_Event.Category = Category;
+	Trace_Event.Pid      = TRACE_PID_DEVICE;
+	Trace_Event.Track    = Track;
+	Trace_Event.Sync     = Sync_us.size() - 1;
+
+	if ((clGetEventProfilingInfo(Event, CL_PROFILING_COMMAND_QUEUED, sizeof(cl_ulong), &Trace_Event.Queued, NULL) != CL_SUCCESS) ||
+	    (clGetEventProfilingInfo(Event, CL_PROFILING_COMMAND_START,  sizeof(cl_ulong), &Trace_Event.Start,  NULL) != CL_SUCCESS) ||
+	    (clGetEventProfilingInfo(Event, CL_PROFILING_COMMAND_END,    sizeof(cl_ulong), &Trace_Event.End,    NULL) != CL_SUCCESS)) {
+		cout << "HOST-Error: Failed to get profiling info for the trace of " << Name << " (" << Track << ")" << endl;
+		return;
+	}
+	Events.push_back(Trace_Event);
+}
+
+static string json_string(string Str) {
+	string Out = "\"";
+	for (unsigned i=0; i<Str.size(); i++) {
+		if ((Str[i] == '"') || (Str[i] == '\\')) Out += '\\';
+		Out += Str[i];
+	}
+	return Out + "\"";
+}
+
+// ============================================================================
+// Write the trace (atexit)
+// ============================================================================
+static void trace_write() {
+	if (!Enabled) return;
+
+	// --------------------------------------------------------
+	// Device clock -> host clock: the first command queued
+	// after a trace_device_sync call starts at its host time
+	// --------------------------------------------------------
+	vector<cl_ulong> Device_Base(Sync_us.size(), 0);
+	vector<bool>     Base_Set   (Sync_us.size(), false);
+
+	for (unsigned i=0; i<Events.size(); i++) {
+		t_trace_event* Event = &Events[i];
+		if (Event->Pid != TRACE_PID_DEVICE) continue;
+		if (!Base_Set[Event->Sync] || (Event->Queued < Device_Base[Event->Sync])) {
+			Device_Base[Event->Sync] = Event->Queued;
+			Base_Set   [Event->Sync] = true;
+		}
+	}
+
+	for (unsigned i=0; i<Events.size(); i++) {
+		t_trace_event* Event = &Events[i];
+		if (Event->Pid != TRACE_PID_DEVICE) continue;
+		Event->Start_us    = Sync_us[Event->Sync] + 1.0e-3 * (double)(Event->Start - Device_Base[Event->Sync]);
+		Event->Duration_us = 1.0e-3 * (double)(Event->End - Event->Start);
+	}
+
+	// --------------------------------------------------------
+	// One thread id per track (in the order of appearance)
+	// --------------------------------------------------------
+	map<string, int> Track_Id;
+	vector<string>   Tracks;
+	vector<int>      Track_Pid;
+
+	for (unsigned i=0; i<Events.size(); i++) {
+		string Key = to_string(Events[i].Pid) + ":" + Events[i].Track;
+		if (Track_Id.find(Key) == Track_Id.end()) {
+			Track_Id[Key] = Tracks.size();
+			Tracks.push_back(Events[i].Track);
+			Track_Pid.push_back(Events[i].Pid);
+		}
+	}
+
+	fstream Trace_File;
+	Trace_File.open(File_Name, ios::out);
+	if (!Trace_File.is_open()) {
+		cout << "HOST-Error: Unable to open a file for write: " << File_Name << endl;
+		return;
+	}
+
+	Trace_File << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << endl;
+	Trace_File << "{\"ph\": \"M\", \"pid\": " << TRACE_PID_HOST   << ", \"name\": \"process_name\", \"args\": {\"name\": \"Host\"}}," << endl;
+	Trace_File << "{\"ph\": \"M\", \"pid\": " << TRACE_PID_DEVICE << ", \"name\": \"process_name\", \"args\": {\"name\": \"Device\"}}";
+
+	for (unsigned t=0; t<Tracks.size(); t++) {
+		Trace_File << "," << endl << "{\"ph\": \"M\", \"pid\": " << Track_Pid[t] << ", \"tid\": " << t
+		           << ", \"name\": \"thread_name\", \"args\": {\"name\": " << json_string(Tracks[t]) << "}},";
+		Trace_File << endl << "{\"ph\": \"M\", \"pid\": " << Track_Pid[t] << ", \"tid\": " << t
+		           << ", \"name\": \"thread_sort_index\", \"args\": {\"sort_index\": " << t << "}}";
+	}
+
+	Trace_File << fixed << setprecision(3);
+	for (unsigned i=0; i<Events.size(); i++) {
+		t_trace_event* Event = &Events[i];
+		Trace_File << "," << endl << "{\"ph\": \"X\", \"pid\": " << Event->Pid << ", \"tid\": " << Track_Id[to_string(Event->Pid) + ":" + Event->Track]
+		           << ", \"name\": " << json_string(Event->Name) << ", \"cat\": " << json_string(Event->Category)
+		           << ", \"ts\": " << Event->Start_us << ", \"dur\": " << Event->Duration_us << "}";
+	}
+	Trace_File << endl << "]}" << endl;
+	Trace_File.close();
+
+	cout << "HOST-Info: Timeline trace (" << Events.size() << " events) stored in the " << File_Name << " file (chrome://tracing, ui.perfetto.dev)" << endl;
+}
+
+void trace_open(const char* Trace_File_Name) {
+	if ((Trace_File_Name == NULL) || (Trace_File_Name[0] == '\0')) return;
+
+	File_Name = Trace_File_Name;
+	Enabled   = true;
+	Origin_us = host_time_us();
+	atexit(trace_write);
+}
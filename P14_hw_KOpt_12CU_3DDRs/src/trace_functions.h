@@ -0,0 +1,54 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#ifndef __TRACE_FUNCTIONS_H__
+#define __TRACE_FUNCTIONS_H__
+
+#include <string>
+
+#include <CL/cl.h>
+
+using namespace std;
+
+// ============================================================================
+// Timeline Trace (Chrome trace event JSON: chrome://tracing, ui.perfetto.dev)
+//   Enabled by the BINOMIAL_TRACE=<file.json> environment variable, the file
+//   is written at exit.
+//   o) "Host" process: host phases (config parsing, generate_test_vectors,
+//      SW model, OpenCL setup, ...)
+//   o) "Device" process: one track per CU (kernel runs) and one track per
+//      memory bank (H->G and G->H transfers), from the OpenCL profiling info
+//      exported by run_custom_profiling
+//   The device clock is aligned on the host clock with trace_device_sync():
+//   the first command queued after the call starts at the host time of the
+//   call.
+// ============================================================================
+void   trace_open   (const char* File_Name);      // NULL: tracing disabled
+bool   trace_enabled();
+double trace_now_us ();                            // Host time since trace_open (us)
+
+// Host phase from Start_us (trace_now_us) to now
+void   trace_host_phase(string Name, double Start_us);
+
+// Called just before the commands of the profiled run are enqueued
+void   trace_device_sync();
+
+// Device command (Category: "kernel" or "transfer") on the Track of a CU or memory bank
+void   trace_device_event(string Track, string Name, string Category, cl_event Event);
+
+#endif
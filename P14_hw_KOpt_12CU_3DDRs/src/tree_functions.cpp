@@ -0,0 +1,123 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#include <cstring>
+#include <math.h>
+#include <stdint.h>
+#include <unordered_map>
+
+using namespace std;
+
+#include "tree_functions.h"
+
+// Bit pattern of T, r, sigma, q and n
+typedef struct {
+	uint32_t Word[5];
+} t_tree_key;
+
+struct t_tree_key_hash {
+	size_t operator()(const t_tree_key& Key) const {
+		uint64_t h = 0x9E3779B97F4A7C15ULL;
+		for (int i=0; i<5; i++) {
+			h ^= Key.Word[i];
+			h *= 0xFF51AFD7ED558CCDULL;
+			h ^= h >> 32;
+		}
+		return (size_t)h;
+	}
+};
+
+struct t_tree_key_equal {
+	bool operator()(const t_tree_key& a, const t_tree_key& b) const {
+		return (memcmp(a.Word, b.Word, sizeof(a.Word)) == 0);
+	}
+};
+
+static t_tree_key tree_key(const t_in_data* IN_DATA) {
+	t_tree_key Key;
+
+	memcpy(&Key.Word[0], &IN_DATA->T,     4);
+	memcpy(&Key.Word[1], &IN_DATA->r,     4);
+	memcpy(&Key.Word[2], &IN_DATA->sigma, 4);
+	memcpy(&Key.Word[3], &IN_DATA->q,     4);
+	memcpy(&Key.Word[4], &IN_DATA->n,     4);
+	return Key;
+}
+
+
+// ============================================================================
+// Tree parameters (same float operations as the kernels used per test)
+// ============================================================================
+void tree_params_calc(const t_in_data* IN_DATA, t_tree_params* Tree) {
+	float deltaT, up;
+
+	deltaT = (float) IN_DATA->T / IN_DATA->n;
+	up = expf(IN_DATA->sigma * sqrtf(deltaT));
+
+	Tree->n  = IN_DATA->n;
+	Tree->up = up;
+	Tree->p0 = (up*expf(-IN_DATA->q * deltaT) - expf(-IN_DATA->r * deltaT)) / (powf(up,2) - 1); // up^2
+	Tree->p1 = expf(-IN_DATA->r * deltaT) - Tree->p0;
+}
+
+
+// ============================================================================
+// Pack test vectors: the tests of a group are usually consecutive
+// (generate_test_vectors emits runs of tests which differ only in K), so the
+// tree of the previous test is tried before the hash map
+// ============================================================================
+int pack_kernel_inputs(const t_in_data* IN_DATA, int Nb_Of_Tests, t_in_option* IN_OPTION, t_tree_params* IN_TREE, int Nb_Of_Trees) {
+	unordered_map<t_tree_key, int, t_tree_key_hash, t_tree_key_equal> Trees;
+	t_tree_key Last_Key  = {{0, 0, 0, 0, 0}};
+	int        Last_Tree = -1;
+
+	for (int i=0; i<Nb_Of_Tests; i++) {
+		t_tree_key Key = tree_key(&IN_DATA[i]);
+
+		if ((Last_Tree < 0) || !t_tree_key_equal()(Key, Last_Key)) {
+			auto Found = Trees.find(Key);
+			if (Found != Trees.end()) {
+				Last_Tree = Found->second;
+			} else {
+				Last_Tree = Nb_Of_Trees++;
+				tree_params_calc(&IN_DATA[i], &IN_TREE[Last_Tree]);
+				Trees.emplace(Key, Last_Tree);
+			}
+			Last_Key = Key;
+		}
+
+		IN_OPTION[i].S    = IN_DATA[i].S;
+		IN_OPTION[i].K    = IN_DATA[i].K;
+		IN_OPTION[i].Tree = Last_Tree;
+	}
+	return(Nb_Of_Trees);
+}
+
+int pack_dummy_inputs(int Nb_Of_Dummies, t_in_option* IN_OPTION, t_tree_params* IN_TREE, int Nb_Of_Trees) {
+	if (Nb_Of_Dummies <= 0) return(Nb_Of_Trees);
+
+	t_in_data Dummy = {1, 1, 1, 1, 1, 1, 1, 0.0f};
+	tree_params_calc(&Dummy, &IN_TREE[Nb_Of_Trees]);
+
+	for (int i=0; i<Nb_Of_Dummies; i++) {
+		IN_OPTION[i].S    = Dummy.S;
+		IN_OPTION[i].K    = Dummy.K;
+		IN_OPTION[i].Tree = Nb_Of_Trees;
+	}
+	return(Nb_Of_Trees+1);
+}
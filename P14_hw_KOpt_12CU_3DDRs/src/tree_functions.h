@@ -0,0 +1,46 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+#ifndef __TREE_FUNCTIONS_H__
+#define __TREE_FUNCTIONS_H__
+
+#include "kernel.h"
+
+using namespace std;
+
+// ============================================================================
+// Kernel Inputs
+//   deltaT, up, p0 and p1 only depend on T, r, sigma, q and n. The Host packs
+//   the test vectors of a kernel buffer in:
+//   o) one t_tree_params record per group of tests with the same T, r, sigma,
+//      q and n (compared by bit pattern), calculated once per group with the
+//      formulas the kernels used, so the results do not change
+//   o) one t_in_option record per test: S, K and the index of its tree
+//   A buffer of N options never needs more than N trees (+1 for the dummy
+//   tests): the tree buffers have the size of the option buffers.
+// ============================================================================
+void tree_params_calc(const t_in_data* IN_DATA, t_tree_params* Tree);
+
+// Packs Nb_Of_Tests test vectors in IN_OPTION[0 ... Nb_Of_Tests-1]. The new trees are appended to the Nb_Of_Trees
+// trees already in IN_TREE. Returns the number of trees in IN_TREE.
+int  pack_kernel_inputs(const t_in_data* IN_DATA, int Nb_Of_Tests, t_in_option* IN_OPTION, t_tree_params* IN_TREE, int Nb_Of_Trees);
+
+// Packs Nb_Of_Dummies dummy tests (1-step tree) in IN_OPTION[0 ... Nb_Of_Dummies-1], see pack_kernel_inputs
+int  pack_dummy_inputs (int Nb_Of_Dummies, t_in_option* IN_OPTION, t_tree_params* IN_TREE, int Nb_Of_Trees);
+
+#endif
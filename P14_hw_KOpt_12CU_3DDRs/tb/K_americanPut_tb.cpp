@@ -0,0 +1,160 @@
+/*****************************************************************************
+
+ Copyright (c) 2019, Xilinx, Inc.
+ 
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+ 
+      http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+******************************************************************************/
+
+// ============================================================================================================ //
+// Kernel Test Bench
+//   Runs the K_americanPut_<k> and K_americanPut_df_<k> kernels as plain C++ (no Vitis, no OpenCL runtime) and
+//   compares every result against the SW model (sw_calc_p0 in src/SW.cpp):
+//     o) tree heights up to CONST_MAX_TREE_HEIGHT (exercise_lut) and taller trees (tiled, p column in Col)
+//     o) an odd number of tests (tail of the last group of CONST_NB_OF_PARALLEL_FUNCTIONS tests)
+//     o) tests of several trees in turn (the kernels read a tree from IN_Tree whenever the tree index changes)
+//   The tests are packed in t_in_option/t_tree_params records by pack_kernel_inputs (src/tree_functions.cpp).
+//   The kernels calculate the exercise values with the same operations as the SW model, so the results should
+//   be bit-identical; a relative difference above TB_MAX_REL_ERROR fails the test. The runtime of every kernel
+//   call and of the SW model (ns per tree node) is printed as a benchmark.
+//
+//   Build (only the OpenCL headers are needed, for src/help_functions.h):
+//     g++ -O2 -std=c++14 -DSW_OCL_BACKEND -Isrc tb/K_americanPut_tb.cpp src/K0.cpp src/K1.cpp src/K2.cpp src/SW.cpp src/tree_functions.cpp -o K_americanPut_tb
+//   Returns 0 when all tests pass (also usable as the C simulation test bench of the kernels).
+// ============================================================================================================ //
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <iomanip>
+
+#include "kernel.h"
+#include "time_functions.h"
+#include "tree_functions.h"
+
+using namespace std;
+
+#define TB_MAX_REL_ERROR 1.0e-6
+
+float sw_calc_p0(int T, float S, float K, float r, float sigma, float q, int n);
+
+extern "C" {
+void K_americanPut_0   (t_in_option* IN_Option, t_tree_params* IN_Tree, float* Res, int Nb_of_Tests, int Start_Index, float* Col, int Col_Base, int Col_Stride);
+void K_americanPut_1   (t_in_option* IN_Option, t_tree_params* IN_Tree, float* Res, int Nb_of_Tests, int Start_Index, float* Col, int Col_Base, int Col_Stride);
+void K_americanPut_2   (t_in_option* IN_Option, t_tree_params* IN_Tree, float* Res, int Nb_of_Tests, int Start_Index, float* Col, int Col_Base, int Col_Stride);
+void K_americanPut_df_0(t_in_option* IN_Option, t_tree_params* IN_Tree, float* Res, int Nb_of_Tests, int Start_Index, float* Col, int Col_Base, int Col_Stride);
+void K_americanPut_df_1(t_in_option* IN_Option, t_tree_params* IN_Tree, float* Res, int Nb_of_Tests, int Start_Index, float* Col, int Col_Base, int Col_Stride);
+void K_americanPut_df_2(t_in_option* IN_Option, t_tree_params* IN_Tree, float* Res, int Nb_of_Tests, int Start_Index, float* Col, int Col_Base, int Col_Stride);
+}
+
+typedef void (*t_kernel_fn)(t_in_option*, t_tree_params*, float*, int, int, float*, int, int);
+
+typedef struct {
+	string      name;
+	t_kernel_fn fn;
+} t_tb_kernel;
+
+typedef struct {
+	int n;                   // Tree height of all tests
+	int Nb_Of_Tests;
+	int Nb_Of_Trees;         // Test i uses tree i % Nb_Of_Trees (sigma)
+} t_tb_case;
+
+int main() {
+	const t_tb_kernel Kernels[] = {
+		{"K_americanPut_0",    K_americanPut_0},    {"K_americanPut_1",    K_americanPut_1},    {"K_americanPut_2",    K_americanPut_2},
+		{"K_americanPut_df_0", K_americanPut_df_0}, {"K_americanPut_df_1", K_americanPut_df_1}, {"K_americanPut_df_2", K_americanPut_df_2},
+	};
+	const t_tb_case Cases[] = {
+		{10,   64, 1}, {100, 64, 1}, {CONST_MAX_TREE_HEIGHT, 8, 1},         // exercise_lut
+		{10,   37, 1},                                                      // odd number of tests
+		{100,  37, 3},                                                      // several trees
+		{CONST_MAX_TREE_HEIGHT + 476, 4, 1}, {3*CONST_MAX_TREE_HEIGHT + 5, 5, 1},   // tiled (p column in Col)
+	};
+	const int Nb_Of_Kernels = sizeof(Kernels)/sizeof(Kernels[0]);
+	const int Nb_Of_Cases   = sizeof(Cases)/sizeof(Cases[0]);
+	const int Start_Index   = 3;                                // the kernels must only access [Start_Index ... Start_Index+Nb_Of_Tests-1]
+
+	int Nb_Of_Errors = 0;
+
+	cout << "TB-Info: " << left << setw(20) << "Kernel" << " | " << right << setw(6) << "n" << " | " << setw(6) << "Tests"
+	     << " | " << setw(10) << "Identical" << " | " << setw(12) << "Max rel err" << " | " << setw(10) << "ns/node" << " | " << setw(10) << "SW ns/node" << endl;
+
+	for (int c=0; c<Nb_Of_Cases; c++) {
+		int n           = Cases[c].n;
+		int Nb_Of_Tests = Cases[c].Nb_Of_Tests;
+		int Col_Stride  = (n > CONST_MAX_TREE_HEIGHT) ? n : 1;
+
+		vector<t_in_data>     IN_Data(Start_Index + Nb_Of_Tests);
+		vector<t_in_option>   IN_Option(Start_Index + Nb_Of_Tests);
+		vector<t_tree_params> IN_Tree(Nb_Of_Tests);
+		vector<float>     Res(Start_Index + Nb_Of_Tests + CONST_NB_OF_PARALLEL_FUNCTIONS);
+		vector<float>     Col(CONST_NB_OF_PARALLEL_FUNCTIONS * Col_Stride);
+		vector<float>     sw_RES(Nb_Of_Tests);
+
+		for (int i=0; i<Nb_Of_Tests; i++) {
+			t_in_data in_d = {1, 110.0f, 95.0f + 0.5f*i, 0.025f, 0.2f + 0.05f*(i % Cases[c].Nb_Of_Trees), 0.1f, n, 0.0f};
+			IN_Data[Start_Index + i] = in_d;
+		}
+		pack_kernel_inputs(&IN_Data[Start_Index], Nb_Of_Tests, &IN_Option[Start_Index], IN_Tree.data(), 0);
+
+		// SW model
+		double tstart = get_time_ms();
+		for (int i=0; i<Nb_Of_Tests; i++) {
+			t_in_data* in_d = &IN_Data[Start_Index + i];
+			sw_RES[i] = sw_calc_p0(in_d->T, in_d->S, in_d->K, in_d->r, in_d->sigma, in_d->q, in_d->n);
+		}
+		double sw_ms = get_time_ms() - tstart;
+		double Nb_Of_Nodes = (double) Nb_Of_Tests * n * (n+1) / 2;
+
+		for (int k=0; k<Nb_Of_Kernels; k++) {
+			const float Guard = -12345.0f;                      // results outside the tests must not be written
+			for (unsigned i=0; i<Res.size(); i++) Res[i] = Guard;
+
+			tstart = get_time_ms();
+			Kernels[k].fn(IN_Option.data(), IN_Tree.data(), Res.data(), Nb_Of_Tests, Start_Index, Col.data(), 0, Col_Stride);
+			double hw_ms = get_time_ms() - tstart;
+
+			int    Nb_Of_Identical = 0;
+			double Max_Rel_Error   = 0;
+			bool   Guard_Ok        = true;
+			for (unsigned i=0; i<Res.size(); i++) {
+				int t = (int)i - Start_Index;
+				if ((t < 0) || (t >= Nb_Of_Tests)) { if (Res[i] != Guard) Guard_Ok = false; continue; }
+
+				if (memcmp(&Res[i], &sw_RES[t], sizeof(float)) == 0) Nb_Of_Identical++;
+				double Rel_Error = fabs((double)Res[i] - sw_RES[t]) / fmax(fabs((double)sw_RES[t]), 1.0e-6);
+				if (!(Rel_Error <= Max_Rel_Error)) Max_Rel_Error = Rel_Error;   // also catches NaN
+			}
+
+			bool Passed = Guard_Ok && (Max_Rel_Error <= TB_MAX_REL_ERROR);
+			if (!Passed) Nb_Of_Errors++;
+
+			cout << "TB-Info: " << left << setw(20) << Kernels[k].name << " | " << right << setw(6) << n << " | " << setw(6) << Nb_Of_Tests
+			     << " | " << setw(10) << Nb_Of_Identical << " | " << setw(12) << scientific << setprecision(2) << Max_Rel_Error
+			     << " | " << setw(10) << fixed << setprecision(2) << 1.0e6 * hw_ms / Nb_Of_Nodes << " | " << setw(10) << 1.0e6 * sw_ms / Nb_Of_Nodes
+			     << (Passed ? "" : (Guard_Ok ? "  <- FAILED" : "  <- FAILED (results written outside the tests)")) << endl;
+		}
+	}
+
+	if (Nb_Of_Errors == 0) {
+		cout << endl << "TB-Info: Test Passed" << endl;
+		return 0;
+	}
+	cout << endl << "TB-Error: Test Failed (#Errors=" << Nb_Of_Errors << ")" << endl;
+	return 1;
+}